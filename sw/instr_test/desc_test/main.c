@@ -0,0 +1,119 @@
+#include <stdint.h>
+#include "errno.h"
+#include "stdio.h"
+#include "string.h"
+#include "unistd.h"
+
+#define SHARED_MEM_SIZE        (1024 * 1024 * 1)   // 1 MB
+#define SHARED_MEM_START_ADDR  0x03000000
+#define SHARED_MEM_END_ADDR    (SHARED_MEM_START_ADDR + SHARED_MEM_SIZE - 1)
+
+// Registers of a command, by number (see Fileds::abiName in core/engine/type.h)
+#define NR_REG          55
+#define R_OPCODE        1
+#define R_MMA_OPMASK    2
+#define R_MMA_N         5
+#define R_MMA_K         6
+#define R_MMA_M         7
+#define R_MMA_HP_ADDR   8
+#define R_MMA_HP_STRIDE 9
+#define R_MMA_HP_DTYPE  10
+#define R_MMA_LP_ADDR   11
+#define R_MMA_LP_STRIDE 12
+#define R_MMA_LP_DTYPE  13
+#define R_MMA_W_ADDR    14
+#define R_MMA_W_STRIDE  15
+#define R_MMA_W_DTYPE   16
+#define R_MMA_OUT_ADDR  27
+#define R_MMA_OUT_STRIDE 28
+#define R_MMA_OUT_DTYPE 29
+#define R_DESC_ADDR     54
+
+// idg.set idg.<rd>,imm: rd in bits 16..7, imm in bits 30..17. The
+// assembler has no name for desc.addr, it is set by number.
+#define IDG_SET(rd, imm) asm volatile(".insn 4, %0" :: "i"(((imm) << 17) | ((rd) << 7) | 0x7b))
+
+#define DESC_ENTRY      0x200                               // entry 8: 0x8000
+#define OUT0_ENTRY      0x100                               // entry 4: 0x4000
+#define OUT1_ENTRY      0x300                               // entry 12: 0xc000
+#define N_DESC          2
+
+struct descriptor {
+    uint32_t regs[NR_REG];
+};
+
+void initialize() {
+    uint16_t* hp_p = (uint16_t*)SHARED_MEM_START_ADDR;
+    uint8_t* lp_p  = (uint8_t*)(SHARED_MEM_START_ADDR + 8192);
+    uint8_t* w_p   = (uint8_t*)(SHARED_MEM_START_ADDR + 8192 + 4096);
+
+    for (int i = 0; i < 64; i ++) {
+        hp_p[i] = 0x3f80; // 1
+    }
+
+    for (int i = 0; i < 64; i ++) {
+        lp_p[i] = 0x40; // 2
+    }
+
+    for (int i = 0; i < 64; i ++) {
+        w_p[i] = 0x44;  // 3
+    }
+}
+
+// The same GEMM as mma_test, into the output at out_entry
+void make_mma(struct descriptor* d, uint32_t out_entry) {
+    memset(d, 0, sizeof(*d));
+
+    d->regs[R_OPCODE] = 0x1;                // opcode: SPU
+    d->regs[R_MMA_OPMASK] = 0x1c1;          // opmask: load hp, load lp, load w, gemm, store o
+
+    d->regs[R_MMA_N] = 0x40;                // N = 64
+    d->regs[R_MMA_K] = 0x2;                 // K = 64
+    d->regs[R_MMA_M] = 0x2;                 // M = 64
+
+    d->regs[R_MMA_HP_ADDR] = 0x0;           // HP: 0x0 BF16
+    d->regs[R_MMA_HP_STRIDE] = 0x0;
+    d->regs[R_MMA_HP_DTYPE] = 0x3;
+
+    d->regs[R_MMA_LP_ADDR] = 0x80;          // LP: 0x2000 FP8
+    d->regs[R_MMA_LP_STRIDE] = 0x0;
+    d->regs[R_MMA_LP_DTYPE] = 0x1;
+
+    d->regs[R_MMA_W_ADDR] = 0xc0;           // W:  0x3000 FP8
+    d->regs[R_MMA_W_STRIDE] = 0x0;
+    d->regs[R_MMA_W_DTYPE] = 0x1;
+
+    d->regs[R_MMA_OUT_ADDR] = out_entry;    // O: FP32
+    d->regs[R_MMA_OUT_STRIDE] = 0x0;
+    d->regs[R_MMA_OUT_DTYPE] = 0x7;
+}
+
+int main() {
+    initialize();
+
+    // Write the descriptors to the shared memory, they are read by the
+    // Scheduler after the submission: leave them alone until the sync
+    struct descriptor* desc = (struct descriptor*)(SHARED_MEM_START_ADDR + 0x8000);
+    make_mma(&desc[0], OUT0_ENTRY);
+    make_mma(&desc[1], OUT1_ENTRY);
+
+    IDG_SET(R_DESC_ADDR, DESC_ENTRY);       // desc.addr: 0x8000
+    IDG_SET(0, 0x1000 | N_DESC);            // SUBMIT the N_DESC descriptors
+
+    asm volatile("idg.set idg.zero,0x100"); // SYNC POINT, just a trick for simualtion
+
+    // Both commands computed the same output
+    const uint32_t* o0 = (const uint32_t*)(SHARED_MEM_START_ADDR + 0x4000);
+    const uint32_t* o1 = (const uint32_t*)(SHARED_MEM_START_ADDR + 0xc000);
+    int nonzero = 0;
+    for (int i = 0; i < 64 * 64; i ++) {
+        if (o0[i] != o1[i]) {
+            printf("descriptors: output %d differs: %x %x\n", i, o0[i], o1[i]);
+            return 1;
+        }
+        nonzero |= o0[i] != 0;
+    }
+    printf(nonzero ? "descriptors: OK\n" : "descriptors: no output\n");
+
+	return 0;
+}
@@ -0,0 +1,10 @@
+#include "stdio.h"
+
+// Nothing to do on the cores: run with -dma_hbm_test, the DMA of that core
+// writes a string to the HBM, reads it back through its HBM controller and
+// stops the simulation with an error if the data differs. The simulation
+// ends once the cores have exited and the read has been answered.
+int main() {
+    printf("waiting for the DMA HBM round trip\n");
+    return 0;
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Writes run_blocks(state, buf) to stdout: random straight-line blocks of
+the instructions the JIT compiles (see vp/src/core/rv64/jit.h), each run
+LOOPS times so that the later runs are compiled, on the registers saved
+in state and the 8 KB page aligned buffer buf. The blocks also load from
+the shared memory, which the JIT leaves to the interpreter, and run the
+odd division and FENCE.I, which end the compiled runs.
+
+usage: gen.py [seed]
+"""
+
+import random
+import sys
+
+BLOCKS = 200
+LOOPS = 100            # more than JIT::THRESHOLD
+BLOCK_INSTRS = (2, 24)
+
+# the registers of the blocks, loaded from and saved to state; s0 holds
+# state, s1 buf, gp the shared memory and tp the loop count
+REGS = ["ra", "t0", "t1", "t2", "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+        "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"]
+SAVED = ["ra", "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11", "gp", "tp"]
+
+SHARED_MEM_START_ADDR = 0x03000000
+
+ALU_IMM = ["addi", "slti", "sltiu", "xori", "ori", "andi", "addiw"]
+SHIFT_IMM = ["slli", "srli", "srai"]
+SHIFT_IMM_W = ["slliw", "srliw", "sraiw"]
+ALU = ["add", "sub", "sll", "slt", "sltu", "xor", "srl", "sra", "or", "and", "mul",
+       "addw", "subw", "sllw", "srlw", "sraw"]
+LOADS = [("lb", 1), ("lh", 2), ("lw", 4), ("ld", 8), ("lbu", 1), ("lhu", 2), ("lwu", 4)]
+STORES = [("sb", 1), ("sh", 2), ("sw", 4), ("sd", 8)]
+
+
+def imm12(r):
+    # edge values more often than their share
+    return r.choice([-2048, -1, 0, 1, 2047, r.randint(-2048, 2047), r.randint(-16, 16)])
+
+
+def instr(r):
+    rd, rs1, rs2 = r.choice(REGS + ["zero"]), r.choice(REGS + ["zero"]), r.choice(REGS + ["zero"])
+    kind = r.randrange(100)
+    if kind < 25:
+        return ["%s %s, %s, %d" % (r.choice(ALU_IMM), rd, rs1, imm12(r))]
+    if kind < 32:
+        return ["%s %s, %s, %d" % (r.choice(SHIFT_IMM), rd, rs1, r.choice([0, 1, 31, 32, 63, r.randrange(64)]))]
+    if kind < 37:
+        return ["%s %s, %s, %d" % (r.choice(SHIFT_IMM_W), rd, rs1, r.choice([0, 1, 31, r.randrange(32)]))]
+    if kind < 60:
+        return ["%s %s, %s, %s" % (r.choice(ALU), rd, rs1, rs2)]
+    if kind < 64:
+        return ["%s %s, 0x%x" % (r.choice(["lui", "auipc"]), rd, r.randrange(1 << 20))]
+    if kind < 95:
+        # an aligned access at buf + ((rs1 & 0x7f8) << 1) + offset, in
+        # either page of buf
+        op, size = r.choice(LOADS + STORES)
+        offset = r.randrange(0, 0x800, size)
+        tmp = r.choice(REGS)
+        code = ["andi %s, %s, 0x7f8" % (tmp, rs1), "slli %s, %s, 1" % (tmp, tmp), "add %s, %s, s1" % (tmp, tmp)]
+        if op.startswith("l"):
+            return code + ["%s %s, %d(%s)" % (op, rd, offset, tmp)]
+        return code + ["%s %s, %d(%s)" % (op, rs2, offset, tmp)]
+    if kind < 97:
+        op, size = r.choice(LOADS)
+        return ["%s %s, %d(gp)" % (op, rd, r.randrange(0, 0x800, size))]
+    if kind < 99:
+        return ["div %s, %s, %s" % (rd, rs1, rs2)]
+    return ["fence.i"]
+
+
+def main():
+    r = random.Random(int(sys.argv[1]) if len(sys.argv) > 1 else 1)
+    frame = 8 * len(SAVED)
+
+    out = ["# generated by gen.py, do not edit", "", ".globl run_blocks", "", "run_blocks:"]
+    out.append("\taddi sp, sp, -%d" % frame)
+    out += ["\tsd %s, %d(sp)" % (reg, 8 * i) for i, reg in enumerate(SAVED)]
+    out += ["\tmv s0, a0", "\tmv s1, a1", "\tli gp, 0x%x" % SHARED_MEM_START_ADDR]
+    out += ["\tld %s, %d(s0)" % (reg, 8 * i) for i, reg in enumerate(REGS)]
+
+    for block in range(BLOCKS):
+        out += ["", "\tli tp, %d" % LOOPS, "block%d:" % block]
+        for _ in range(r.randint(*BLOCK_INSTRS)):
+            out += ["\t" + line for line in instr(r)]
+        out += ["\taddi tp, tp, -1", "\tbnez tp, block%d" % block]
+
+    out.append("")
+    out += ["\tsd %s, %d(s0)" % (reg, 8 * i) for i, reg in enumerate(REGS)]
+    out += ["\tld %s, %d(sp)" % (reg, 8 * i) for i, reg in enumerate(SAVED)]
+    out += ["\taddi sp, sp, %d" % frame, "\tret", ""]
+    print("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#include <stdint.h>
+#include "stdio.h"
+
+#define NR_STATE 26     // registers of the blocks, see gen.py
+#define BUF_SIZE 8192
+
+// generated by gen.py
+void run_blocks(uint64_t* state, uint8_t* buf);
+
+uint64_t state[NR_STATE];
+uint8_t buf[BUF_SIZE] __attribute__((aligned(4096)));
+
+static uint64_t seed = 0x9e3779b97f4a7c15;
+
+uint64_t next() {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+uint64_t hash(const uint8_t* p, int size, uint64_t h) {
+    for (int i = 0; i < size; i ++) {
+        h = (h ^ p[i]) * 0x100000001b3;
+    }
+    return h;
+}
+
+int main() {
+    for (int i = 0; i < NR_STATE; i ++) {
+        state[i] = next() >> (next() % 64);
+    }
+    for (int i = 0; i < BUF_SIZE; i ++) {
+        buf[i] = next();
+    }
+
+    run_blocks(state, buf);
+
+    uint64_t cycle, instret;
+    asm volatile("rdcycle %0" : "=r"(cycle));
+    asm volatile("rdinstret %0" : "=r"(instret));
+
+    // the same with and without the JIT
+    printf("jit_test: state %016lx buf %016lx cycle %lu instret %lu\n",
+           hash((const uint8_t*)state, sizeof(state), 0xcbf29ce484222325),
+           hash(buf, BUF_SIZE, 0xcbf29ce484222325), cycle, instret);
+
+	return 0;
+}
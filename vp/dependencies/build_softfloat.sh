@@ -8,7 +8,10 @@ PREFIX=$DIR/softfloat-dist
 source=spike-softfloat-20190310
 
 tar -xzf $source.tar.gz
-make -C $source -j$NPROCS
+# the rounding mode and exception flags are per host thread, for the
+# parallel execution of the cores
+make -C $source -j$NPROCS SOFTFLOAT_OPTS="-DSOFTFLOAT_ROUND_ODD -DINLINE_LEVEL=5 -DSOFTFLOAT_FAST_DIV32TO16 \
+    -DSOFTFLOAT_FAST_DIV64TO32 -DTHREAD_LOCAL=_Thread_local"
 
 mkdir -p softfloat-dist/lib
 mkdir -p softfloat-dist/include/softfloat
@@ -19,6 +22,7 @@ rm -rf $source
 
 header_file=softfloat-dist/include/softfloat/softfloat.hpp
 echo "#pragma once" > $header_file
+echo "#define THREAD_LOCAL thread_local" >> $header_file
 echo "extern \"C\" {" >> $header_file
 echo "#include \"softfloat.h\"" >> $header_file
 echo "}" >> $header_file
@@ -1,20 +1,32 @@
 #pragma once
 
+#include <stdint.h>
+
+/*
+ * Atomics lock the cache line they access, an LR up to its SC: the other
+ * harts only wait when they access the same line. A hart holds at most one
+ * line, locking another one unlocks the first.
+ */
 struct bus_lock_if {
-    virtual ~bus_lock_if() {}
+	static constexpr unsigned LINE_SHIFT = 6;  // 64 byte lines
+	static constexpr unsigned NO_HART = ~0u;   // e.g. DMA peripherals
+
+	virtual ~bus_lock_if() {}
 
-	virtual void lock(unsigned hart_id) = 0;
+	virtual void lock(unsigned hart_id, uint64_t addr) = 0;
 
 	virtual void unlock(unsigned hart_id) = 0;
 
-	virtual bool is_locked() = 0;  // by any hart
+	virtual bool is_locked() = 0;  // any line, by any hart
+
+	virtual bool is_locked(unsigned hart_id) = 0;  // a line, by hart_id
 
-	virtual bool is_locked(unsigned hart_id) = 0;
+	virtual bool is_locked_by_other(unsigned hart_id, uint64_t addr) = 0;  // the line of addr
 
-	virtual void wait_until_unlocked() = 0;
+	virtual void wait_until_unlocked(unsigned hart_id, uint64_t addr) = 0;  // by the other harts
 
-	inline void wait_for_access_rights(unsigned hart_id) {
-		if (is_locked() && !is_locked(hart_id))
-			wait_until_unlocked();
+	inline void wait_for_access_rights(unsigned hart_id, uint64_t addr) {
+		if (is_locked() && is_locked_by_other(hart_id, addr))
+			wait_until_unlocked(hart_id, addr);
 	}
-};
\ No newline at end of file
+};
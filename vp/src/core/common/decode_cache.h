@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+
+#include "instr.h"
+
+/*
+ * Direct mapped cache of decoded instructions, indexed by pc.
+ *
+ * The instruction is still fetched on every step (this keeps the fetch
+ * timing, translation and access faults unchanged); only decoding is
+ * skipped when the fetched word is the one the entry was decoded from.
+ * Decoding only depends on the instruction bits, hence entries need no
+ * invalidation on fence.i, sfence.vma or satp writes, and code modified
+ * by stores, DMA or other harts misses on the word comparison.
+ */
+struct DecodeCache {
+	static constexpr unsigned SIZE = 4096;  // power of two
+
+	struct Entry {
+		uint64_t pc = UINT64_MAX;
+		uint32_t mem_word = 0;
+		Instruction instr;  // expanded, for compressed instructions
+		Opcode::Mapping op = Opcode::UNDEF;
+	};
+
+	std::array<Entry, SIZE> entries;
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+
+	// Decode mem_word fetched at pc into instr, return its opcode
+	Opcode::Mapping decode(uint64_t pc, uint32_t mem_word, Instruction &instr, Architecture arch) {
+		Entry &e = entries[(pc >> 1) & (SIZE - 1)];
+
+		if (e.pc == pc && e.mem_word == mem_word) {
+			++hits;
+		} else {
+			++misses;
+			e.pc = pc;
+			e.mem_word = mem_word;
+			e.instr = Instruction(mem_word);
+			if (e.instr.is_compressed())
+				e.op = e.instr.decode_and_expand_compressed(arch);
+			else
+				e.op = e.instr.decode_normal(arch);
+		}
+
+		instr = e.instr;
+		return e.op;
+	}
+
+	double hit_rate() const {
+		return hits + misses ? (double)hits / (hits + misses) : 0.0;
+	}
+};
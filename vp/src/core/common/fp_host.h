@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cfenv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#if defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+#include "fp.h"
+
+/*
+ * Host FPU fast path for the arithmetic F/D instructions: the softfloat
+ * function they stand for, plus the fflags of the hart. The host computes
+ * the result in RNE when no operand is a NaN or subnormal, the flags come
+ * from its status register. Anything else, or a result that may have
+ * underflowed (RISC-V detects tininess after rounding, not every host
+ * does), goes to softfloat. The operands are already unboxed, an invalid
+ * result is the canonical NaN. The host is assumed to round to nearest as
+ * the C runtime starts it, flush to zero does not matter.
+ */
+namespace host_fp {
+
+template <typename T>
+struct Format;
+
+template <>
+struct Format<float32_t> {
+	using host = float;
+	static constexpr uint32_t EXP = 0x7F800000;
+	static constexpr uint32_t FRAC = 0x007FFFFF;
+	static constexpr uint32_t NaN = defaultNaNF32UI;
+};
+
+template <>
+struct Format<float64_t> {
+	using host = double;
+	static constexpr uint64_t EXP = 0x7FF0000000000000;
+	static constexpr uint64_t FRAC = 0x000FFFFFFFFFFFFF;
+	static constexpr uint64_t NaN = defaultNaNF64UI;
+};
+
+// zero, normal or infinite
+template <typename T>
+inline bool is_plain(T x) {
+	auto exp = x.v & Format<T>::EXP;
+	return (x.v & Format<T>::FRAC) == 0 || (exp != 0 && exp != Format<T>::EXP);
+}
+
+inline bool all_plain() {
+	return true;
+}
+
+template <typename T, typename... Ts>
+inline bool all_plain(T x, Ts... xs) {
+	return is_plain(x) && all_plain(xs...);
+}
+
+template <typename T>
+inline typename Format<T>::host to_host(T x) {
+	typename Format<T>::host h;
+	memcpy(&h, &x.v, sizeof(h));
+	return h;
+}
+
+/*
+ * fetestexcept and feclearexcept. On x86-64 the arithmetic only uses SSE,
+ * whose flags in MXCSR have the bits of FE_*: glibc would save and restore
+ * the x87 environment too, which costs more than softfloat.
+ */
+#if defined(__x86_64__)
+inline int host_flags() {
+	return _mm_getcsr() & FE_ALL_EXCEPT;
+}
+
+inline void clear_host_flags() {
+	_mm_setcsr(_mm_getcsr() & ~FE_ALL_EXCEPT);
+}
+#else
+inline int host_flags() {
+	return fetestexcept(FE_ALL_EXCEPT);
+}
+
+inline void clear_host_flags() {
+	feclearexcept(FE_ALL_EXCEPT);
+}
+#endif
+
+// fflags and softfloat flags have the same bits
+inline int to_host_flags(uint_fast8_t flags) {
+	return (flags & softfloat_flag_inexact ? FE_INEXACT : 0) | (flags & softfloat_flag_underflow ? FE_UNDERFLOW : 0) |
+	       (flags & softfloat_flag_overflow ? FE_OVERFLOW : 0) | (flags & softfloat_flag_infinite ? FE_DIVBYZERO : 0) |
+	       (flags & softfloat_flag_invalid ? FE_INVALID : 0);
+}
+
+inline uint_fast8_t to_softfloat_flags(int raised) {
+	return (raised & FE_INEXACT ? softfloat_flag_inexact : 0) | (raised & FE_OVERFLOW ? softfloat_flag_overflow : 0) |
+	       (raised & FE_DIVBYZERO ? softfloat_flag_infinite : 0) | (raised & FE_INVALID ? softfloat_flag_invalid : 0);
+}
+
+/*
+ * Computes op on the host into result, false if softfloat has to. The host
+ * flags are sticky and writing them is slow: they are only cleared when
+ * the hart has not got one of them in fflags yet, the others may as well
+ * be raised again. The operands and the result go through volatiles so
+ * that the compiler keeps the operation between reading the flags.
+ */
+template <typename T, typename Op, typename... Ts>
+inline bool compute(T &result, uint_fast8_t fflags, Op op, Ts... operands) {
+	using host = typename Format<T>::host;
+
+	if (softfloat_roundingMode != softfloat_round_near_even || !all_plain(operands...))
+		return false;
+
+	if (host_flags() & ~to_host_flags(fflags))
+		clear_host_flags();
+	volatile host in[] = {to_host(operands)...};
+	volatile host out = op(in);
+	int raised = host_flags();
+
+	// a tiny result, or a zero that may have been rounded to
+	host h = out;
+	if (std::fabs(h) <= std::numeric_limits<host>::min() && (h != 0 || (raised & FE_INEXACT)))
+		return false;
+
+	if (std::isnan(h))
+		result.v = Format<T>::NaN;
+	else
+		memcpy(&result.v, &h, sizeof(h));
+	softfloat_exceptionFlags |= to_softfloat_flags(raised);
+	return true;
+}
+
+}  // namespace host_fp
+
+inline float32_t host_f32_add(float32_t a, float32_t b, uint_fast8_t fflags) {
+	float32_t r;
+	if (host_fp::compute(r, fflags, [](const volatile float *in) { return in[0] + in[1]; }, a, b))
+		return r;
+	return f32_add(a, b);
+}
+
+inline float32_t host_f32_sub(float32_t a, float32_t b, uint_fast8_t fflags) {
+	float32_t r;
+	if (host_fp::compute(r, fflags, [](const volatile float *in) { return in[0] - in[1]; }, a, b))
+		return r;
+	return f32_sub(a, b);
+}
+
+inline float32_t host_f32_mul(float32_t a, float32_t b, uint_fast8_t fflags) {
+	float32_t r;
+	if (host_fp::compute(r, fflags, [](const volatile float *in) { return in[0] * in[1]; }, a, b))
+		return r;
+	return f32_mul(a, b);
+}
+
+inline float32_t host_f32_div(float32_t a, float32_t b, uint_fast8_t fflags) {
+	float32_t r;
+	if (host_fp::compute(r, fflags, [](const volatile float *in) { return in[0] / in[1]; }, a, b))
+		return r;
+	return f32_div(a, b);
+}
+
+inline float32_t host_f32_sqrt(float32_t a, uint_fast8_t fflags) {
+	float32_t r;
+	if (host_fp::compute(r, fflags, [](const volatile float *in) { return std::sqrt(in[0]); }, a))
+		return r;
+	return f32_sqrt(a);
+}
+
+inline float32_t host_f32_mulAdd(float32_t a, float32_t b, float32_t c, uint_fast8_t fflags) {
+	float32_t r;
+	if (host_fp::compute(r, fflags, [](const volatile float *in) { return std::fma(in[0], in[1], in[2]); }, a, b, c))
+		return r;
+	return f32_mulAdd(a, b, c);
+}
+
+inline float64_t host_f64_add(float64_t a, float64_t b, uint_fast8_t fflags) {
+	float64_t r;
+	if (host_fp::compute(r, fflags, [](const volatile double *in) { return in[0] + in[1]; }, a, b))
+		return r;
+	return f64_add(a, b);
+}
+
+inline float64_t host_f64_sub(float64_t a, float64_t b, uint_fast8_t fflags) {
+	float64_t r;
+	if (host_fp::compute(r, fflags, [](const volatile double *in) { return in[0] - in[1]; }, a, b))
+		return r;
+	return f64_sub(a, b);
+}
+
+inline float64_t host_f64_mul(float64_t a, float64_t b, uint_fast8_t fflags) {
+	float64_t r;
+	if (host_fp::compute(r, fflags, [](const volatile double *in) { return in[0] * in[1]; }, a, b))
+		return r;
+	return f64_mul(a, b);
+}
+
+inline float64_t host_f64_div(float64_t a, float64_t b, uint_fast8_t fflags) {
+	float64_t r;
+	if (host_fp::compute(r, fflags, [](const volatile double *in) { return in[0] / in[1]; }, a, b))
+		return r;
+	return f64_div(a, b);
+}
+
+inline float64_t host_f64_sqrt(float64_t a, uint_fast8_t fflags) {
+	float64_t r;
+	if (host_fp::compute(r, fflags, [](const volatile double *in) { return std::sqrt(in[0]); }, a))
+		return r;
+	return f64_sqrt(a);
+}
+
+inline float64_t host_f64_mulAdd(float64_t a, float64_t b, float64_t c, uint_fast8_t fflags) {
+	float64_t r;
+	if (host_fp::compute(r, fflags, [](const volatile double *in) { return std::fma(in[0], in[1], in[2]); }, a, b, c))
+		return r;
+	return f64_mulAdd(a, b, c);
+}
@@ -5,354 +5,6 @@
 #include <cassert>
 #include <stdexcept>
 
-constexpr uint32_t LUI_MASK = 0b00000000000000000000000001111111;
-constexpr uint32_t LUI_ENCODING = 0b00000000000000000000000000110111;
-constexpr uint32_t AUIPC_MASK = 0b00000000000000000000000001111111;
-constexpr uint32_t AUIPC_ENCODING = 0b00000000000000000000000000010111;
-constexpr uint32_t JAL_MASK = 0b00000000000000000000000001111111;
-constexpr uint32_t JAL_ENCODING = 0b00000000000000000000000001101111;
-constexpr uint32_t JALR_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t JALR_ENCODING = 0b00000000000000000000000001100111;
-constexpr uint32_t BEQ_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t BEQ_ENCODING = 0b00000000000000000000000001100011;
-constexpr uint32_t BNE_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t BNE_ENCODING = 0b00000000000000000001000001100011;
-constexpr uint32_t BLT_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t BLT_ENCODING = 0b00000000000000000100000001100011;
-constexpr uint32_t BGE_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t BGE_ENCODING = 0b00000000000000000101000001100011;
-constexpr uint32_t BLTU_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t BLTU_ENCODING = 0b00000000000000000110000001100011;
-constexpr uint32_t BGEU_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t BGEU_ENCODING = 0b00000000000000000111000001100011;
-constexpr uint32_t LB_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LB_ENCODING = 0b00000000000000000000000000000011;
-constexpr uint32_t LH_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LH_ENCODING = 0b00000000000000000001000000000011;
-constexpr uint32_t LW_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LW_ENCODING = 0b00000000000000000010000000000011;
-constexpr uint32_t LBU_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LBU_ENCODING = 0b00000000000000000100000000000011;
-constexpr uint32_t LHU_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LHU_ENCODING = 0b00000000000000000101000000000011;
-constexpr uint32_t SB_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t SB_ENCODING = 0b00000000000000000000000000100011;
-constexpr uint32_t SH_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t SH_ENCODING = 0b00000000000000000001000000100011;
-constexpr uint32_t SW_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t SW_ENCODING = 0b00000000000000000010000000100011;
-constexpr uint32_t ADDI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t ADDI_ENCODING = 0b00000000000000000000000000010011;
-constexpr uint32_t SLTI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t SLTI_ENCODING = 0b00000000000000000010000000010011;
-constexpr uint32_t SLTIU_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t SLTIU_ENCODING = 0b00000000000000000011000000010011;
-constexpr uint32_t XORI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t XORI_ENCODING = 0b00000000000000000100000000010011;
-constexpr uint32_t ORI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t ORI_ENCODING = 0b00000000000000000110000000010011;
-constexpr uint32_t ANDI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t ANDI_ENCODING = 0b00000000000000000111000000010011;
-//-- RV64 special case (one less mask bit compared to RV32)
-constexpr uint32_t SLLI_MASK = 0b11111100000000000111000001111111;
-constexpr uint32_t SLLI_ENCODING = 0b00000000000000000001000000010011;
-constexpr uint32_t SRLI_MASK = 0b11111100000000000111000001111111;
-constexpr uint32_t SRLI_ENCODING = 0b00000000000000000101000000010011;
-constexpr uint32_t SRAI_MASK = 0b11111100000000000111000001111111;
-constexpr uint32_t SRAI_ENCODING = 0b01000000000000000101000000010011;
-//-- RV32 case
-constexpr uint32_t SLLI_32_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SLLI_32_ENCODING = 0b00000000000000000001000000010011;
-constexpr uint32_t SRLI_32_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRLI_32_ENCODING = 0b00000000000000000101000000010011;
-constexpr uint32_t SRAI_32_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRAI_32_ENCODING = 0b01000000000000000101000000010011;
-//--
-constexpr uint32_t ADD_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t ADD_ENCODING = 0b00000000000000000000000000110011;
-constexpr uint32_t SUB_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SUB_ENCODING = 0b01000000000000000000000000110011;
-constexpr uint32_t SLL_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SLL_ENCODING = 0b00000000000000000001000000110011;
-constexpr uint32_t SLT_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SLT_ENCODING = 0b00000000000000000010000000110011;
-constexpr uint32_t SLTU_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SLTU_ENCODING = 0b00000000000000000011000000110011;
-constexpr uint32_t XOR_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t XOR_ENCODING = 0b00000000000000000100000000110011;
-constexpr uint32_t SRL_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRL_ENCODING = 0b00000000000000000101000000110011;
-constexpr uint32_t SRA_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRA_ENCODING = 0b01000000000000000101000000110011;
-constexpr uint32_t OR_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t OR_ENCODING = 0b00000000000000000110000000110011;
-constexpr uint32_t AND_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t AND_ENCODING = 0b00000000000000000111000000110011;
-constexpr uint32_t FENCE_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t FENCE_ENCODING = 0b00000000000000000000000000001111;
-constexpr uint32_t FENCE_I_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t FENCE_I_ENCODING = 0b00000000000000000001000000001111;
-constexpr uint32_t ECALL_MASK = 0b11111111111111111111111111111111;
-constexpr uint32_t ECALL_ENCODING = 0b00000000000000000000000001110011;
-constexpr uint32_t EBREAK_MASK = 0b11111111111111111111111111111111;
-constexpr uint32_t EBREAK_ENCODING = 0b00000000000100000000000001110011;
-constexpr uint32_t CSRRW_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t CSRRW_ENCODING = 0b00000000000000000001000001110011;
-constexpr uint32_t CSRRS_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t CSRRS_ENCODING = 0b00000000000000000010000001110011;
-constexpr uint32_t CSRRC_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t CSRRC_ENCODING = 0b00000000000000000011000001110011;
-constexpr uint32_t CSRRWI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t CSRRWI_ENCODING = 0b00000000000000000101000001110011;
-constexpr uint32_t CSRRSI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t CSRRSI_ENCODING = 0b00000000000000000110000001110011;
-constexpr uint32_t CSRRCI_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t CSRRCI_ENCODING = 0b00000000000000000111000001110011;
-constexpr uint32_t MUL_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t MUL_ENCODING = 0b00000010000000000000000000110011;
-constexpr uint32_t MULH_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t MULH_ENCODING = 0b00000010000000000001000000110011;
-constexpr uint32_t MULHSU_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t MULHSU_ENCODING = 0b00000010000000000010000000110011;
-constexpr uint32_t MULHU_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t MULHU_ENCODING = 0b00000010000000000011000000110011;
-constexpr uint32_t DIV_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t DIV_ENCODING = 0b00000010000000000100000000110011;
-constexpr uint32_t DIVU_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t DIVU_ENCODING = 0b00000010000000000101000000110011;
-constexpr uint32_t REM_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t REM_ENCODING = 0b00000010000000000110000000110011;
-constexpr uint32_t REMU_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t REMU_ENCODING = 0b00000010000000000111000000110011;
-constexpr uint32_t LR_W_MASK = 0b11111001111100000111000001111111;
-constexpr uint32_t LR_W_ENCODING = 0b00010000000000000010000000101111;
-constexpr uint32_t SC_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t SC_W_ENCODING = 0b00011000000000000010000000101111;
-constexpr uint32_t AMOSWAP_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOSWAP_W_ENCODING = 0b00001000000000000010000000101111;
-constexpr uint32_t AMOADD_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOADD_W_ENCODING = 0b00000000000000000010000000101111;
-constexpr uint32_t AMOXOR_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOXOR_W_ENCODING = 0b00100000000000000010000000101111;
-constexpr uint32_t AMOAND_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOAND_W_ENCODING = 0b01100000000000000010000000101111;
-constexpr uint32_t AMOOR_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOOR_W_ENCODING = 0b01000000000000000010000000101111;
-constexpr uint32_t AMOMIN_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMIN_W_ENCODING = 0b10000000000000000010000000101111;
-constexpr uint32_t AMOMAX_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMAX_W_ENCODING = 0b10100000000000000010000000101111;
-constexpr uint32_t AMOMINU_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMINU_W_ENCODING = 0b11000000000000000010000000101111;
-constexpr uint32_t AMOMAXU_W_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMAXU_W_ENCODING = 0b11100000000000000010000000101111;
-constexpr uint32_t URET_MASK = 0b11111111111111111111111111111111;
-constexpr uint32_t URET_ENCODING = 0b00000000001000000000000001110011;
-constexpr uint32_t SRET_MASK = 0b11111111111111111111111111111111;
-constexpr uint32_t SRET_ENCODING = 0b00010000001000000000000001110011;
-constexpr uint32_t MRET_MASK = 0b11111111111111111111111111111111;
-constexpr uint32_t MRET_ENCODING = 0b00110000001000000000000001110011;
-constexpr uint32_t WFI_MASK = 0b11111111111111111111111111111111;
-constexpr uint32_t WFI_ENCODING = 0b00010000010100000000000001110011;
-constexpr uint32_t SFENCE_VMA_MASK = 0b11111110000000000111111111111111;
-constexpr uint32_t SFENCE_VMA_ENCODING = 0b00010010000000000000000001110011;
-
-//-- RV64IMA Extension
-constexpr uint32_t LWU_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LWU_ENCODING = 0b00000000000000000110000000000011;
-constexpr uint32_t LD_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t LD_ENCODING = 0b00000000000000000011000000000011;
-constexpr uint32_t SD_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t SD_ENCODING = 0b00000000000000000011000000100011;
-constexpr uint32_t ADDIW_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t ADDIW_ENCODING = 0b00000000000000000000000000011011;
-constexpr uint32_t SLLIW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SLLIW_ENCODING = 0b00000000000000000001000000011011;
-constexpr uint32_t SRLIW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRLIW_ENCODING = 0b00000000000000000101000000011011;
-constexpr uint32_t SRAIW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRAIW_ENCODING = 0b01000000000000000101000000011011;
-constexpr uint32_t ADDW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t ADDW_ENCODING = 0b00000000000000000000000000111011;
-constexpr uint32_t SUBW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SUBW_ENCODING = 0b01000000000000000000000000111011;
-constexpr uint32_t SLLW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SLLW_ENCODING = 0b00000000000000000001000000111011;
-constexpr uint32_t SRLW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRLW_ENCODING = 0b00000000000000000101000000111011;
-constexpr uint32_t SRAW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t SRAW_ENCODING = 0b01000000000000000101000000111011;
-constexpr uint32_t MULW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t MULW_ENCODING = 0b00000010000000000000000000111011;
-constexpr uint32_t DIVW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t DIVW_ENCODING = 0b00000010000000000100000000111011;
-constexpr uint32_t DIVUW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t DIVUW_ENCODING = 0b00000010000000000101000000111011;
-constexpr uint32_t REMW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t REMW_ENCODING = 0b00000010000000000110000000111011;
-constexpr uint32_t REMUW_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t REMUW_ENCODING = 0b00000010000000000111000000111011;
-constexpr uint32_t LR_D_MASK = 0b11111001111100000111000001111111;
-constexpr uint32_t LR_D_ENCODING = 0b00010000000000000011000000101111;
-constexpr uint32_t SC_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t SC_D_ENCODING = 0b00011000000000000011000000101111;
-constexpr uint32_t AMOSWAP_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOSWAP_D_ENCODING = 0b00001000000000000011000000101111;
-constexpr uint32_t AMOADD_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOADD_D_ENCODING = 0b00000000000000000011000000101111;
-constexpr uint32_t AMOXOR_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOXOR_D_ENCODING = 0b00100000000000000011000000101111;
-constexpr uint32_t AMOAND_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOAND_D_ENCODING = 0b01100000000000000011000000101111;
-constexpr uint32_t AMOOR_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOOR_D_ENCODING = 0b01000000000000000011000000101111;
-constexpr uint32_t AMOMIN_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMIN_D_ENCODING = 0b10000000000000000011000000101111;
-constexpr uint32_t AMOMAX_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMAX_D_ENCODING = 0b10100000000000000011000000101111;
-constexpr uint32_t AMOMINU_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMINU_D_ENCODING = 0b11000000000000000011000000101111;
-constexpr uint32_t AMOMAXU_D_MASK = 0b11111000000000000111000001111111;
-constexpr uint32_t AMOMAXU_D_ENCODING = 0b11100000000000000011000000101111;
-
-// RV32/64FD Extension
-constexpr uint32_t FLW_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t FLW_ENCODING = 0b00000000000000000010000000000111;
-constexpr uint32_t FSW_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t FSW_ENCODING = 0b00000000000000000010000000100111;
-constexpr uint32_t FMADD_S_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FMADD_S_ENCODING = 0b00000000000000000000000001000011;
-constexpr uint32_t FMSUB_S_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FMSUB_S_ENCODING = 0b00000000000000000000000001000111;
-constexpr uint32_t FNMADD_S_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FNMADD_S_ENCODING = 0b00000000000000000000000001001111;
-constexpr uint32_t FNMSUB_S_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FNMSUB_S_ENCODING = 0b00000000000000000000000001001011;
-constexpr uint32_t FADD_S_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FADD_S_ENCODING = 0b00000000000000000000000001010011;
-constexpr uint32_t FSUB_S_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FSUB_S_ENCODING = 0b00001000000000000000000001010011;
-constexpr uint32_t FMUL_S_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FMUL_S_ENCODING = 0b00010000000000000000000001010011;
-constexpr uint32_t FDIV_S_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FDIV_S_ENCODING = 0b00011000000000000000000001010011;
-constexpr uint32_t FSQRT_S_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FSQRT_S_ENCODING = 0b01011000000000000000000001010011;
-constexpr uint32_t FSGNJ_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FSGNJ_S_ENCODING = 0b00100000000000000000000001010011;
-constexpr uint32_t FSGNJN_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FSGNJN_S_ENCODING = 0b00100000000000000001000001010011;
-constexpr uint32_t FSGNJX_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FSGNJX_S_ENCODING = 0b00100000000000000010000001010011;
-constexpr uint32_t FMIN_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FMIN_S_ENCODING = 0b00101000000000000000000001010011;
-constexpr uint32_t FMAX_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FMAX_S_ENCODING = 0b00101000000000000001000001010011;
-constexpr uint32_t FCVT_W_S_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_W_S_ENCODING = 0b11000000000000000000000001010011;
-constexpr uint32_t FCVT_WU_S_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_WU_S_ENCODING = 0b11000000000100000000000001010011;
-constexpr uint32_t FMV_X_W_MASK = 0b11111111111100000111000001111111;
-constexpr uint32_t FMV_X_W_ENCODING = 0b11100000000000000000000001010011;
-constexpr uint32_t FEQ_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FEQ_S_ENCODING = 0b10100000000000000010000001010011;
-constexpr uint32_t FLT_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FLT_S_ENCODING = 0b10100000000000000001000001010011;
-constexpr uint32_t FLE_S_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FLE_S_ENCODING = 0b10100000000000000000000001010011;
-constexpr uint32_t FCLASS_S_MASK = 0b11111111111100000111000001111111;
-constexpr uint32_t FCLASS_S_ENCODING = 0b11100000000000000001000001010011;
-constexpr uint32_t FCVT_S_W_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_S_W_ENCODING = 0b11010000000000000000000001010011;
-constexpr uint32_t FCVT_S_WU_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_S_WU_ENCODING = 0b11010000000100000000000001010011;
-constexpr uint32_t FMV_W_X_MASK = 0b11111111111100000111000001111111;
-constexpr uint32_t FMV_W_X_ENCODING = 0b11110000000000000000000001010011;
-constexpr uint32_t FCVT_L_S_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_L_S_ENCODING = 0b11000000001000000000000001010011;
-constexpr uint32_t FCVT_LU_S_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_LU_S_ENCODING = 0b11000000001100000000000001010011;
-constexpr uint32_t FCVT_S_L_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_S_L_ENCODING = 0b11010000001000000000000001010011;
-constexpr uint32_t FCVT_S_LU_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_S_LU_ENCODING = 0b11010000001100000000000001010011;
-constexpr uint32_t FLD_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t FLD_ENCODING = 0b00000000000000000011000000000111;
-constexpr uint32_t FSD_MASK = 0b00000000000000000111000001111111;
-constexpr uint32_t FSD_ENCODING = 0b00000000000000000011000000100111;
-constexpr uint32_t FMADD_D_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FMADD_D_ENCODING = 0b00000010000000000000000001000011;
-constexpr uint32_t FMSUB_D_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FMSUB_D_ENCODING = 0b00000010000000000000000001000111;
-constexpr uint32_t FNMSUB_D_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FNMSUB_D_ENCODING = 0b00000010000000000000000001001011;
-constexpr uint32_t FNMADD_D_MASK = 0b00000110000000000000000001111111;
-constexpr uint32_t FNMADD_D_ENCODING = 0b00000010000000000000000001001111;
-constexpr uint32_t FADD_D_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FADD_D_ENCODING = 0b00000010000000000000000001010011;
-constexpr uint32_t FSUB_D_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FSUB_D_ENCODING = 0b00001010000000000000000001010011;
-constexpr uint32_t FMUL_D_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FMUL_D_ENCODING = 0b00010010000000000000000001010011;
-constexpr uint32_t FDIV_D_MASK = 0b11111110000000000000000001111111;
-constexpr uint32_t FDIV_D_ENCODING = 0b00011010000000000000000001010011;
-constexpr uint32_t FSQRT_D_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FSQRT_D_ENCODING = 0b01011010000000000000000001010011;
-constexpr uint32_t FSGNJ_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FSGNJ_D_ENCODING = 0b00100010000000000000000001010011;
-constexpr uint32_t FSGNJN_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FSGNJN_D_ENCODING = 0b00100010000000000001000001010011;
-constexpr uint32_t FSGNJX_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FSGNJX_D_ENCODING = 0b00100010000000000010000001010011;
-constexpr uint32_t FMIN_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FMIN_D_ENCODING = 0b00101010000000000000000001010011;
-constexpr uint32_t FMAX_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FMAX_D_ENCODING = 0b00101010000000000001000001010011;
-constexpr uint32_t FCVT_S_D_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_S_D_ENCODING = 0b01000000000100000000000001010011;
-constexpr uint32_t FCVT_D_S_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_D_S_ENCODING = 0b01000010000000000000000001010011;
-constexpr uint32_t FEQ_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FEQ_D_ENCODING = 0b10100010000000000010000001010011;
-constexpr uint32_t FLT_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FLT_D_ENCODING = 0b10100010000000000001000001010011;
-constexpr uint32_t FLE_D_MASK = 0b11111110000000000111000001111111;
-constexpr uint32_t FLE_D_ENCODING = 0b10100010000000000000000001010011;
-constexpr uint32_t FCLASS_D_MASK = 0b11111111111100000111000001111111;
-constexpr uint32_t FCLASS_D_ENCODING = 0b11100010000000000001000001010011;
-constexpr uint32_t FCVT_W_D_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_W_D_ENCODING = 0b11000010000000000000000001010011;
-constexpr uint32_t FCVT_WU_D_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_WU_D_ENCODING = 0b11000010000100000000000001010011;
-constexpr uint32_t FCVT_D_W_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_D_W_ENCODING = 0b11010010000000000000000001010011;
-constexpr uint32_t FCVT_D_WU_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_D_WU_ENCODING = 0b11010010000100000000000001010011;
-constexpr uint32_t FCVT_L_D_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_L_D_ENCODING = 0b11000010001000000000000001010011;
-constexpr uint32_t FCVT_LU_D_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_LU_D_ENCODING = 0b11000010001100000000000001010011;
-constexpr uint32_t FMV_X_D_MASK = 0b11111111111100000111000001111111;
-constexpr uint32_t FMV_X_D_ENCODING = 0b11100010000000000000000001010011;
-constexpr uint32_t FCVT_D_L_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_D_L_ENCODING = 0b11010010001000000000000001010011;
-constexpr uint32_t FCVT_D_LU_MASK = 0b11111111111100000000000001111111;
-constexpr uint32_t FCVT_D_LU_ENCODING = 0b11010010001100000000000001010011;
-constexpr uint32_t FMV_D_X_MASK = 0b11111111111100000111000001111111;
-constexpr uint32_t FMV_D_X_ENCODING = 0b11110010000000000000000001010011;
-
-// idagi Extension Started 
-constexpr uint32_t IDAGI_SET_MASK = 0b00000000000000000000000001111111; 
-constexpr uint32_t IDAGI_SET_ENCODING = 0b00000000000000000000000001111011;
-// idagi Extension End 
-
-#define MATCH_AND_RETURN_INSTR2(instr, result)                     \
-	if (unlikely((data() & (instr##_MASK)) != (instr##_ENCODING))) \
-		return UNDEF;                                              \
-	return result;
-
-#define MATCH_AND_RETURN_INSTR(instr) MATCH_AND_RETURN_INSTR2(instr, instr)
-
 namespace Compressed {
 enum Opcode {
 	// quadrant zero
@@ -412,243 +64,48 @@ enum Opcode {
 };
 }
 
-/*
-Python snippet to generate the "mappingStr":
-
-for e in [e.strip().replace(",", "") for e in s.strip().split("\n")]:
-    if "//" in e or len(e) == 0:
-        print(e)
-    else:
-        print('"{}",'.format(e))
- */
 std::array<const char *, Opcode::NUMBER_OF_INSTRUCTIONS> Opcode::mappingStr = {
     "ZERO-INVALID",
-
-    // RV32I base instruction set
-    "LUI",
-    "AUIPC",
-    "JAL",
-    "JALR",
-    "BEQ",
-    "BNE",
-    "BLT",
-    "BGE",
-    "BLTU",
-    "BGEU",
-    "LB",
-    "LH",
-    "LW",
-    "LBU",
-    "LHU",
-    "SB",
-    "SH",
-    "SW",
-    "ADDI",
-    "SLTI",
-    "SLTIU",
-    "XORI",
-    "ORI",
-    "ANDI",
-    "SLLI",
-    "SRLI",
-    "SRAI",
-    "ADD",
-    "SUB",
-    "SLL",
-    "SLT",
-    "SLTU",
-    "XOR",
-    "SRL",
-    "SRA",
-    "OR",
-    "AND",
-    "FENCE",
-    "ECALL",
-    "EBREAK",
-
-    // Zifencei standard extension
-    "FENCE_I",
-
-    // Zicsr standard extension
-    "CSRRW",
-    "CSRRS",
-    "CSRRC",
-    "CSRRWI",
-    "CSRRSI",
-    "CSRRCI",
-
-    // RV32M Standard Extension
-    "MUL",
-    "MULH",
-    "MULHSU",
-    "MULHU",
-    "DIV",
-    "DIVU",
-    "REM",
-    "REMU",
-
-    // RV32A Standard Extension
-    "LR_W",
-    "SC_W",
-    "AMOSWAP_W",
-    "AMOADD_W",
-    "AMOXOR_W",
-    "AMOAND_W",
-    "AMOOR_W",
-    "AMOMIN_W",
-    "AMOMAX_W",
-    "AMOMINU_W",
-    "AMOMAXU_W",
-
-    // RV64I base integer set (addition to RV32I)
-    "LWU",
-    "LD",
-    "SD",
-    "ADDIW",
-    "SLLIW",
-    "SRLIW",
-    "SRAIW",
-    "ADDW",
-    "SUBW",
-    "SLLW",
-    "SRLW",
-    "SRAW",
-
-    // RV64M standard extension (addition to RV32M)
-    "MULW",
-    "DIVW",
-    "DIVUW",
-    "REMW",
-    "REMUW",
-
-    // RV64A standard extension (addition to RV32A)
-    "LR_D",
-    "SC_D",
-    "AMOSWAP_D",
-    "AMOADD_D",
-    "AMOXOR_D",
-    "AMOAND_D",
-    "AMOOR_D",
-    "AMOMIN_D",
-    "AMOMAX_D",
-    "AMOMINU_D",
-    "AMOMAXU_D",
-
-    // RV32F standard extension
-    "FLW",
-    "FSW",
-    "FMADD_S",
-    "FMSUB_S",
-    "FNMADD_S",
-    "FNMSUB_S",
-    "FADD_S",
-    "FSUB_S",
-    "FMUL_S",
-    "FDIV_S",
-    "FSQRT_S",
-    "FSGNJ_S",
-    "FSGNJN_S",
-    "FSGNJX_S",
-    "FMIN_S",
-    "FMAX_S",
-    "FCVT_W_S",
-    "FCVT_WU_S",
-    "FMV_X_W",
-    "FEQ_S",
-    "FLT_S",
-    "FLE_S",
-    "FCLASS_S",
-    "FCVT_S_W",
-    "FCVT_S_WU",
-    "FMV_W_X",
-
-    // RV64F standard extension (addition to RV32F)
-    "FCVT_L_S",
-    "FCVT_LU_S",
-    "FCVT_S_L",
-    "FCVT_S_LU",
-
-    // RV32D standard extension
-    "FLD",
-    "FSD",
-    "FMADD_D",
-    "FMSUB_D",
-    "FNMSUB_D",
-    "FNMADD_D",
-    "FADD_D",
-    "FSUB_D",
-    "FMUL_D",
-    "FDIV_D",
-    "FSQRT_D",
-    "FSGNJ_D",
-    "FSGNJN_D",
-    "FSGNJX_D",
-    "FMIN_D",
-    "FMAX_D",
-    "FCVT_S_D",
-    "FCVT_D_S",
-    "FEQ_D",
-    "FLT_D",
-    "FLE_D",
-    "FCLASS_D",
-    "FCVT_W_D",
-    "FCVT_WU_D",
-    "FCVT_D_W",
-    "FCVT_D_WU",
-
-    // RV64D standard extension (addition to RV32D)
-    "FCVT_L_D",
-    "FCVT_LU_D",
-    "FMV_X_D",
-    "FCVT_D_L",
-    "FCVT_D_LU",
-    "FMV_D_X",
-
-	// idagi Extension Start 
-    "IDAGI_SET",
-	// idagi Extension End 
-
-    // privileged instructions
-    "URET",
-    "SRET",
-    "MRET",
-    "WFI",
-    "SFENCE_VMA",
+#define INSTR(name, type, mask, match) #name,
+#define RV32_INSTR(name, mask, match)
+#include "instr_table.h"
+#undef INSTR
+#undef RV32_INSTR
 };
 
 Opcode::Type Opcode::getType(Opcode::Mapping mapping) {
+	static constexpr Type types[NUMBER_OF_INSTRUCTIONS] = {
+	    Type::UNKNOWN,
+#define INSTR(name, type, mask, match) Type::type,
+#define RV32_INSTR(name, mask, match)
+#include "instr_table.h"
+#undef INSTR
+#undef RV32_INSTR
+	};
+	return types[mapping];
+}
+
+bool Opcode::endsBasicBlock(Opcode::Mapping mapping) {
 	switch (mapping) {
-		case SLLI:
-		case SRLI:
-		case SRAI:
-		case ADD:
-		case SUB:
-		case SLL:
-		case SLT:
-		case SLTU:
-		case XOR:
-		case SRL:
-		case SRA:
-		case OR:
-		case AND:
-		case MUL:
-		case MULH:
-		case MULHSU:
-		case MULHU:
-		case DIV:
-		case DIVU:
-		case REM:
-		case REMU:
-		case ADDW:
-		case SUBW:
-		case SLLW:
-		case SRLW:
-		case SRAW:
-		case MULW:
-		case DIVW:
-		case DIVUW:
-		case REMW:
-		case REMUW:
+		case UNDEF:
+		case JAL:
+		case JALR:
+		case BEQ:
+		case BNE:
+		case BLT:
+		case BGE:
+		case BLTU:
+		case BGEU:
+		case FENCE:
+		case ECALL:
+		case EBREAK:
+		case FENCE_I:
+		case CSRRW:
+		case CSRRS:
+		case CSRRC:
+		case CSRRWI:
+		case CSRRSI:
+		case CSRRCI:
 		case LR_W:
 		case SC_W:
 		case AMOSWAP_W:
@@ -671,114 +128,16 @@ Opcode::Type Opcode::getType(Opcode::Mapping mapping) {
 		case AMOMAX_D:
 		case AMOMINU_D:
 		case AMOMAXU_D:
-		case FADD_S:
-		case FSUB_S:
-		case FMUL_S:
-		case FDIV_S:
-		case FSQRT_S:
-		case FSGNJ_S:
-		case FSGNJN_S:
-		case FSGNJX_S:
-		case FMIN_S:
-		case FMAX_S:
-		case FCVT_W_S:
-		case FCVT_WU_S:
-		case FMV_X_W:
-		case FEQ_S:
-		case FLT_S:
-		case FLE_S:
-		case FCLASS_S:
-		case FCVT_S_W:
-		case FCVT_S_WU:
-		case FMV_W_X:
-		case FCVT_L_S:
-		case FCVT_LU_S:
-		case FCVT_S_L:
-		case FCVT_S_LU:
-		case FADD_D:
-		case FSUB_D:
-		case FMUL_D:
-		case FDIV_D:
-		case FSQRT_D:
-		case FSGNJ_D:
-		case FSGNJN_D:
-		case FSGNJX_D:
-		case FMIN_D:
-		case FMAX_D:
-		case FCVT_S_D:
-		case FCVT_D_S:
-		case FEQ_D:
-		case FLT_D:
-		case FLE_D:
-		case FCLASS_D:
-		case FCVT_W_D:
-		case FCVT_WU_D:
-		case FCVT_D_W:
-		case FCVT_D_WU:
-		case FCVT_L_D:
-		case FCVT_LU_D:
-		case FMV_X_D:
-		case FCVT_D_L:
-		case FCVT_D_LU:
-		case FMV_D_X:
-			return Type::R;
-		case JALR:
-		case LB:
-		case LH:
-		case LW:
-		case LD:
-		case LBU:
-		case LHU:
-		case LWU:
-		case ADDI:
-		case SLTI:
-		case SLTIU:
-		case XORI:
-		case ORI:
-		case ANDI:
-		case ADDIW:
-		case SLLIW:
-		case SRLIW:
-		case SRAIW:
-		case FLW:
-		case FLD:
-			return Type::I;
-		case SB:
-		case SH:
-		case SW:
-		case SD:
-		case FSW:
-		case FSD:
-			return Type::S;
-		case BEQ:
-		case BNE:
-		case BLT:
-		case BGE:
-		case BLTU:
-		case BGEU:
-			return Type::B;
-		case LUI:
-		case AUIPC:
-			return Type::U;
-		case JAL:
-			return Type::J;
-		case FMADD_S:
-		case FMSUB_S:
-		case FNMSUB_S:
-		case FNMADD_S:
-		case FMADD_D:
-		case FMSUB_D:
-		case FNMSUB_D:
-		case FNMADD_D:
-			return Type::R4;
-
-		// idagi Extension Start 
 		case IDAGI_SET:
-			return Type::IDAGI;
-		// idagi Extension End 
+		case URET:
+		case SRET:
+		case MRET:
+		case WFI:
+		case SFENCE_VMA:
+			return true;
 
 		default:
-			return Type::UNKNOWN;
+			return false;
 	}
 }
 
@@ -1360,560 +719,178 @@ Opcode::Mapping Instruction::decode_and_expand_compressed(Architecture arch) {
 	return expand_compressed(*this, c_op, arch);
 }
 
-Opcode::Mapping Instruction::decode_normal(Architecture arch) {
-	using namespace Opcode;
+namespace {
 
-	Instruction &instr = *this;
+/*
+ * The decoder tables, built at compile time from instr_table.h. Level 1 is
+ * indexed by opcode[6:2] and funct3, a slot with more than one candidate
+ * encoding is split by funct7 in level 2. The few candidates left are
+ * matched with their mask, in the order of the table.
+ */
+struct Encoding {
+	Opcode::Mapping op;
+	uint32_t mask;
+	uint32_t match;
+	unsigned archs;  // a bit per Architecture
+};
 
-	switch (instr.opcode()) {
-		case OP_LUI:
-			MATCH_AND_RETURN_INSTR(LUI);
+constexpr unsigned ALL_ARCHS = (1 << RV32) | (1 << RV64) | (1 << RV128);
 
-		case OP_AUIPC:
-			MATCH_AND_RETURN_INSTR(AUIPC);
+constexpr Encoding encodings[] = {
+#define INSTR(name, type, mask, match) {Opcode::name, mask, match, ALL_ARCHS},
+#define RV32_INSTR(name, mask, match) {Opcode::name, mask, match, 1 << RV32},
+#include "instr_table.h"
+#undef INSTR
+#undef RV32_INSTR
+};
 
-		case OP_JAL:
-			MATCH_AND_RETURN_INSTR(JAL);
+constexpr unsigned NUM_ENCODINGS = sizeof(encodings) / sizeof(encodings[0]);
+static_assert(NUM_ENCODINGS <= 256, "candidates are stored as uint8_t");
 
-		case OP_JALR: {
-			MATCH_AND_RETURN_INSTR(JALR);
-		}
+constexpr uint32_t LEVEL1_BITS = 0x0000707c;  // opcode[6:2], funct3
+constexpr uint32_t LEVEL2_BITS = 0xfe000000;  // funct7
+constexpr unsigned LEVEL1_SLOTS = 256;
+constexpr unsigned LEVEL2_SLOTS = 128;
+constexpr uint16_t SPLIT = 0xffff;
 
-		case OP_BEQ: {
-			switch (instr.funct3()) {
-				case F3_BEQ:
-					MATCH_AND_RETURN_INSTR(BEQ);
-				case F3_BNE:
-					MATCH_AND_RETURN_INSTR(BNE);
-				case F3_BLT:
-					MATCH_AND_RETURN_INSTR(BLT);
-				case F3_BGE:
-					MATCH_AND_RETURN_INSTR(BGE);
-				case F3_BLTU:
-					MATCH_AND_RETURN_INSTR(BLTU);
-				case F3_BGEU:
-					MATCH_AND_RETURN_INSTR(BGEU);
-			}
-			break;
-		}
+constexpr unsigned level1_index(uint32_t instr) {
+	return ((instr >> 2) & 0x1f) | ((instr >> 7) & 0xe0);
+}
 
-		case OP_LB: {
-			switch (instr.funct3()) {
-				case F3_LB:
-					MATCH_AND_RETURN_INSTR(LB);
-				case F3_LH:
-					MATCH_AND_RETURN_INSTR(LH);
-				case F3_LW:
-					MATCH_AND_RETURN_INSTR(LW);
-				case F3_LBU:
-					MATCH_AND_RETURN_INSTR(LBU);
-				case F3_LHU:
-					MATCH_AND_RETURN_INSTR(LHU);
-				case F3_LWU:
-					MATCH_AND_RETURN_INSTR(LWU);
-				case F3_LD:
-					MATCH_AND_RETURN_INSTR(LD);
-			}
-			break;
-		}
+constexpr uint32_t level1_bits(unsigned index) {
+	return ((index & 0x1f) << 2) | ((index >> 5) << 12);
+}
 
-		case OP_SB: {
-			switch (instr.funct3()) {
-				case F3_SB:
-					MATCH_AND_RETURN_INSTR(SB);
-				case F3_SH:
-					MATCH_AND_RETURN_INSTR(SH);
-				case F3_SW:
-					MATCH_AND_RETURN_INSTR(SW);
-				case F3_SD:
-					MATCH_AND_RETURN_INSTR(SD);
-			}
-			break;
-		}
+// whether encoding e can match an instruction with these bits
+constexpr bool agrees(const Encoding &e, uint32_t bits, uint32_t known) {
+	return ((e.match ^ bits) & e.mask & known) == 0;
+}
 
-		case OP_ADDI: {
-			switch (instr.funct3()) {
-				case F3_ADDI:
-					MATCH_AND_RETURN_INSTR(ADDI);
-				case F3_SLTI:
-					MATCH_AND_RETURN_INSTR(SLTI);
-				case F3_SLTIU:
-					MATCH_AND_RETURN_INSTR(SLTIU);
-				case F3_XORI:
-					MATCH_AND_RETURN_INSTR(XORI);
-				case F3_ORI:
-					MATCH_AND_RETURN_INSTR(ORI);
-				case F3_ANDI:
-					MATCH_AND_RETURN_INSTR(ANDI);
-				case F3_SLLI:
-					if (arch == RV32) {
-						MATCH_AND_RETURN_INSTR2(SLLI_32, SLLI);
-					} else {
-						MATCH_AND_RETURN_INSTR(SLLI);
-					}
-				case F3_SRLI: {
-					switch (instr.funct6()) {
-						case F6_SRLI:
-							if (arch == RV32) {
-								MATCH_AND_RETURN_INSTR2(SRLI_32, SRLI);
-							} else {
-								MATCH_AND_RETURN_INSTR(SRLI);
-							}
-						case F6_SRAI:
-							if (arch == RV32) {
-								MATCH_AND_RETURN_INSTR2(SRAI_32, SRAI);
-							} else {
-								MATCH_AND_RETURN_INSTR(SRAI);
-							}
-					}
-				}
-			}
-			break;
-		}
+// the funct7 values to look at for an encoding: its own when it has one
+constexpr unsigned funct7_begin(const Encoding &e) {
+	return (e.mask & LEVEL2_BITS) == LEVEL2_BITS ? e.match >> 25 : 0;
+}
 
-		case OP_ADDIW: {
-			switch (instr.funct3()) {
-				case F3_ADDIW:
-					MATCH_AND_RETURN_INSTR(ADDIW);
-				case F3_SLLIW:
-					MATCH_AND_RETURN_INSTR(SLLIW);
-				case F3_SRLIW: {
-					switch (instr.funct7()) {
-						case F7_SRLIW:
-							MATCH_AND_RETURN_INSTR(SRLIW);
-						case F7_SRAIW:
-							MATCH_AND_RETURN_INSTR(SRAIW);
-					}
-				}
-			}
-			break;
-		}
+constexpr unsigned funct7_end(const Encoding &e) {
+	return (e.mask & LEVEL2_BITS) == LEVEL2_BITS ? (e.match >> 25) + 1 : LEVEL2_SLOTS;
+}
 
-		case OP_ADD: {
-			switch (instr.funct7()) {
-				case F7_ADD:
-					switch (instr.funct3()) {
-						case F3_ADD:
-							MATCH_AND_RETURN_INSTR(ADD);
-						case F3_SLL:
-							MATCH_AND_RETURN_INSTR(SLL);
-						case F3_SLT:
-							MATCH_AND_RETURN_INSTR(SLT);
-						case F3_SLTU:
-							MATCH_AND_RETURN_INSTR(SLTU);
-						case F3_XOR:
-							MATCH_AND_RETURN_INSTR(XOR);
-						case F3_SRL:
-							MATCH_AND_RETURN_INSTR(SRL);
-						case F3_OR:
-							MATCH_AND_RETURN_INSTR(OR);
-						case F3_AND:
-							MATCH_AND_RETURN_INSTR(AND);
-					}
-					break;
+// the archs of an encoding, without RV32 when the table replaces it there
+constexpr unsigned archs_of(unsigned i) {
+	unsigned archs = encodings[i].archs;
+	if (archs != ALL_ARCHS)
+		return archs;
+	for (unsigned j = 0; j < NUM_ENCODINGS; ++j) {
+		if (encodings[j].op == encodings[i].op && encodings[j].archs == (1u << RV32))
+			archs &= ~(1u << RV32);
+	}
+	return archs;
+}
 
-				case F7_SUB:
-					switch (instr.funct3()) {
-						case F3_SUB:
-							MATCH_AND_RETURN_INSTR(SUB);
-						case F3_SRA:
-							MATCH_AND_RETURN_INSTR(SRA);
-					}
-					break;
+struct Slot {
+	uint16_t first;  // in candidates, in level2 / LEVEL2_SLOTS when split
+	uint16_t count;  // or SPLIT
+};
 
-				case F7_MUL:
-					switch (instr.funct3()) {
-						case F3_MUL:
-							MATCH_AND_RETURN_INSTR(MUL);
-						case F3_MULH:
-							MATCH_AND_RETURN_INSTR(MULH);
-						case F3_MULHSU:
-							MATCH_AND_RETURN_INSTR(MULHSU);
-						case F3_MULHU:
-							MATCH_AND_RETURN_INSTR(MULHU);
-						case F3_DIV:
-							MATCH_AND_RETURN_INSTR(DIV);
-						case F3_DIVU:
-							MATCH_AND_RETURN_INSTR(DIVU);
-						case F3_REM:
-							MATCH_AND_RETURN_INSTR(REM);
-						case F3_REMU:
-							MATCH_AND_RETURN_INSTR(REMU);
-					}
-					break;
-			}
-			break;
-		}
+template <unsigned SPLITS, unsigned CANDIDATES>
+struct DecodeTables {
+	Encoding entries[NUM_ENCODINGS];
+	Slot level1[LEVEL1_SLOTS];
+	Slot level2[SPLITS * LEVEL2_SLOTS];
+	uint8_t candidates[CANDIDATES];
+	unsigned splits;
+	unsigned num_candidates;
+};
 
-		case OP_ADDW: {
-			switch (instr.funct7()) {
-				case F7_ADDW:
-					switch (instr.funct3()) {
-						case F3_ADDW:
-							MATCH_AND_RETURN_INSTR(ADDW);
-						case F3_SLLW:
-							MATCH_AND_RETURN_INSTR(SLLW);
-						case F3_SRLW:
-							MATCH_AND_RETURN_INSTR(SRLW);
-					}
-					break;
+/*
+ * Fills the tables, their sizes are found by a first build into larger
+ * ones. The candidates of a slot are counted before they are placed, which
+ * keeps the build well within the constexpr evaluation limits.
+ */
+template <unsigned SPLITS, unsigned CANDIDATES>
+constexpr DecodeTables<SPLITS, CANDIDATES> build_decode_tables() {
+	DecodeTables<SPLITS, CANDIDATES> t{};
 
-				case F7_SUBW:
-					switch (instr.funct3()) {
-						case F3_SUBW:
-							MATCH_AND_RETURN_INSTR(SUBW);
-						case F3_SRAW:
-							MATCH_AND_RETURN_INSTR(SRAW);
-					}
-					break;
+	for (unsigned i = 0; i < NUM_ENCODINGS; ++i) {
+		t.entries[i] = encodings[i];
+		t.entries[i].archs = archs_of(i);
+	}
 
-				case F7_MULW:
-					switch (instr.funct3()) {
-						case F3_MULW:
-							MATCH_AND_RETURN_INSTR(MULW);
-						case F3_DIVW:
-							MATCH_AND_RETURN_INSTR(DIVW);
-						case F3_DIVUW:
-							MATCH_AND_RETURN_INSTR(DIVUW);
-						case F3_REMW:
-							MATCH_AND_RETURN_INSTR(REMW);
-						case F3_REMUW:
-							MATCH_AND_RETURN_INSTR(REMUW);
-					}
-					break;
-			}
-			break;
+	unsigned counts[LEVEL1_SLOTS] = {};
+	for (unsigned i = 0; i < NUM_ENCODINGS; ++i) {
+		for (unsigned f3 = 0; f3 < 8; ++f3) {
+			uint32_t bits = (encodings[i].match & 0x7c) | (f3 << 12);
+			if (agrees(encodings[i], bits, LEVEL1_BITS))
+				++counts[level1_index(bits)];
 		}
+	}
 
-		case OP_FENCE: {
-			switch (instr.funct3()) {
-				case F3_FENCE:
-					MATCH_AND_RETURN_INSTR(FENCE);
-				case F3_FENCE_I:
-					MATCH_AND_RETURN_INSTR(FENCE_I);
-			}
-			break;
+	for (unsigned s = 0; s < LEVEL1_SLOTS; ++s) {
+		if (counts[s] <= 1) {
+			t.level1[s] = {uint16_t(t.num_candidates), uint16_t(0)};
+			t.num_candidates += counts[s];
+			continue;
 		}
 
-		case OP_ECALL: {
-			switch (instr.funct3()) {
-				case F3_SYS: {
-					switch (instr.funct12()) {
-						case F12_ECALL:
-							MATCH_AND_RETURN_INSTR(ECALL);
-						case F12_EBREAK:
-							MATCH_AND_RETURN_INSTR(EBREAK);
-						case F12_URET:
-							MATCH_AND_RETURN_INSTR(URET);
-						case F12_SRET:
-							MATCH_AND_RETURN_INSTR(SRET);
-						case F12_MRET:
-							MATCH_AND_RETURN_INSTR(MRET);
-						case F12_WFI:
-							MATCH_AND_RETURN_INSTR(WFI);
-						default:
-							MATCH_AND_RETURN_INSTR(SFENCE_VMA);
-					}
-					break;
+		uint16_t block = t.splits++;
+		t.level1[s] = {block, SPLIT};
+		Slot *level2 = &t.level2[block * LEVEL2_SLOTS];
+
+		unsigned counts2[LEVEL2_SLOTS] = {};
+		for (unsigned i = 0; i < NUM_ENCODINGS; ++i) {
+			if (!agrees(encodings[i], level1_bits(s), LEVEL1_BITS))
+				continue;
+			for (unsigned f7 = funct7_begin(encodings[i]); f7 < funct7_end(encodings[i]); ++f7) {
+				if (agrees(encodings[i], f7 << 25, LEVEL2_BITS))
+					++counts2[f7];
+			}
+		}
+		for (unsigned f7 = 0; f7 < LEVEL2_SLOTS; ++f7) {
+			level2[f7] = {uint16_t(t.num_candidates), uint16_t(0)};
+			t.num_candidates += counts2[f7];
+		}
+		for (unsigned i = 0; i < NUM_ENCODINGS; ++i) {
+			if (!agrees(encodings[i], level1_bits(s), LEVEL1_BITS))
+				continue;
+			for (unsigned f7 = funct7_begin(encodings[i]); f7 < funct7_end(encodings[i]); ++f7) {
+				if (agrees(encodings[i], f7 << 25, LEVEL2_BITS)) {
+					Slot &slot = level2[f7];
+					t.candidates[slot.first + slot.count++] = i;
 				}
-				case F3_CSRRW:
-					MATCH_AND_RETURN_INSTR(CSRRW);
-				case F3_CSRRS:
-					MATCH_AND_RETURN_INSTR(CSRRS);
-				case F3_CSRRC:
-					MATCH_AND_RETURN_INSTR(CSRRC);
-				case F3_CSRRWI:
-					MATCH_AND_RETURN_INSTR(CSRRWI);
-				case F3_CSRRSI:
-					MATCH_AND_RETURN_INSTR(CSRRSI);
-				case F3_CSRRCI:
-					MATCH_AND_RETURN_INSTR(CSRRCI);
 			}
-			break;
 		}
+	}
 
-		case OP_AMO: {
-			switch (instr.funct5()) {
-				case F5_LR_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(LR_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(LR_W);
-					}
-				case F5_SC_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(SC_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(SC_W);
-					}
-				case F5_AMOSWAP_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOSWAP_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOSWAP_W);
-					}
-				case F5_AMOADD_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOADD_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOADD_W);
-					}
-				case F5_AMOXOR_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOXOR_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOXOR_W);
-					}
-				case F5_AMOAND_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOAND_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOAND_W);
-					}
-				case F5_AMOOR_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOOR_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOOR_W);
-					}
-				case F5_AMOMIN_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOMIN_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOMIN_W);
-					}
-				case F5_AMOMAX_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOMAX_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOMAX_W);
-					}
-				case F5_AMOMINU_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOMINU_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOMINU_W);
-					}
-				case F5_AMOMAXU_W:
-					if (instr.funct3() == F3_AMO_D) {
-						MATCH_AND_RETURN_INSTR(AMOMAXU_D);
-					} else {
-						MATCH_AND_RETURN_INSTR(AMOMAXU_W);
-					}
-			}
-			break;
+	for (unsigned i = 0; i < NUM_ENCODINGS; ++i) {
+		for (unsigned f3 = 0; f3 < 8; ++f3) {
+			uint32_t bits = (encodings[i].match & 0x7c) | (f3 << 12);
+			Slot &slot = t.level1[level1_index(bits)];
+			if (slot.count != SPLIT && agrees(encodings[i], bits, LEVEL1_BITS))
+				t.candidates[slot.first + slot.count++] = i;
 		}
+	}
 
-		// RV32/64 FD Extension
-		case OP_FMADD_S:
-			switch (instr.funct2()) {
-				case F2_FMADD_S:
-					MATCH_AND_RETURN_INSTR(FMADD_S);
-				case F2_FMADD_D:
-					MATCH_AND_RETURN_INSTR(FMADD_D);
-			}
-			break;
+	return t;
+}
 
-		case OP_FADD_S:
-			switch (instr.funct7()) {
-				case F7_FADD_S:
-					MATCH_AND_RETURN_INSTR(FADD_S);
-				case F7_FADD_D:
-					MATCH_AND_RETURN_INSTR(FADD_D);
-				case F7_FSUB_S:
-					MATCH_AND_RETURN_INSTR(FSUB_S);
-				case F7_FSUB_D:
-					MATCH_AND_RETURN_INSTR(FSUB_D);
-				case F7_FCVT_D_S:
-					MATCH_AND_RETURN_INSTR(FCVT_D_S);
-				case F7_FMUL_S:
-					MATCH_AND_RETURN_INSTR(FMUL_S);
-				case F7_FMUL_D:
-					MATCH_AND_RETURN_INSTR(FMUL_D);
-				case F7_FDIV_S:
-					MATCH_AND_RETURN_INSTR(FDIV_S);
-				case F7_FDIV_D:
-					MATCH_AND_RETURN_INSTR(FDIV_D);
-				case F7_FLE_S:
-					switch (instr.funct3()) {
-						case F3_FLE_S:
-							MATCH_AND_RETURN_INSTR(FLE_S);
-						case F3_FLT_S:
-							MATCH_AND_RETURN_INSTR(FLT_S);
-						case F3_FEQ_S:
-							MATCH_AND_RETURN_INSTR(FEQ_S);
-					}
-					break;
-				case F7_FSGNJ_D:
-					switch (instr.funct3()) {
-						case F3_FSGNJ_D:
-							MATCH_AND_RETURN_INSTR(FSGNJ_D);
-						case F3_FSGNJN_D:
-							MATCH_AND_RETURN_INSTR(FSGNJN_D);
-						case F3_FSGNJX_D:
-							MATCH_AND_RETURN_INSTR(FSGNJX_D);
-					}
-					break;
-				case F7_FMIN_S:
-					switch (instr.funct3()) {
-						case F3_FMIN_S:
-							MATCH_AND_RETURN_INSTR(FMIN_S);
-						case F3_FMAX_S:
-							MATCH_AND_RETURN_INSTR(FMAX_S);
-					}
-					break;
-				case F7_FMIN_D:
-					switch (instr.funct3()) {
-						case F3_FMIN_D:
-							MATCH_AND_RETURN_INSTR(FMIN_D);
-						case F3_FMAX_D:
-							MATCH_AND_RETURN_INSTR(FMAX_D);
-					}
-					break;
-				case F7_FCVT_S_D:
-					MATCH_AND_RETURN_INSTR(FCVT_S_D);
-				case F7_FSGNJ_S:
-					switch (instr.funct3()) {
-						case F3_FSGNJ_S:
-							MATCH_AND_RETURN_INSTR(FSGNJ_S);
-						case F3_FSGNJN_S:
-							MATCH_AND_RETURN_INSTR(FSGNJN_S);
-						case F3_FSGNJX_S:
-							MATCH_AND_RETURN_INSTR(FSGNJX_S);
-					}
-					break;
-				case F7_FLE_D:
-					switch (instr.funct3()) {
-						case F3_FLE_D:
-							MATCH_AND_RETURN_INSTR(FLE_D);
-						case F3_FLT_D:
-							MATCH_AND_RETURN_INSTR(FLT_D);
-						case F3_FEQ_D:
-							MATCH_AND_RETURN_INSTR(FEQ_D);
-					}
-					break;
-				case F7_FCVT_S_W:
-					switch (instr.rs2()) {
-						case RS2_FCVT_S_W:
-							MATCH_AND_RETURN_INSTR(FCVT_S_W);
-						case RS2_FCVT_S_WU:
-							MATCH_AND_RETURN_INSTR(FCVT_S_WU);
-						case RS2_FCVT_S_L:
-							MATCH_AND_RETURN_INSTR(FCVT_S_L);
-						case RS2_FCVT_S_LU:
-							MATCH_AND_RETURN_INSTR(FCVT_S_LU);
-					}
-					break;
-				case F7_FCVT_D_W:
-					switch (instr.rs2()) {
-						case RS2_FCVT_D_W:
-							MATCH_AND_RETURN_INSTR(FCVT_D_W);
-						case RS2_FCVT_D_WU:
-							MATCH_AND_RETURN_INSTR(FCVT_D_WU);
-						case RS2_FCVT_D_L:
-							MATCH_AND_RETURN_INSTR(FCVT_D_L);
-						case RS2_FCVT_D_LU:
-							MATCH_AND_RETURN_INSTR(FCVT_D_LU);
-					}
-					break;
-				case F7_FCVT_W_D:
-					switch (instr.rs2()) {
-						case RS2_FCVT_W_D:
-							MATCH_AND_RETURN_INSTR(FCVT_W_D);
-						case RS2_FCVT_WU_D:
-							MATCH_AND_RETURN_INSTR(FCVT_WU_D);
-						case RS2_FCVT_L_D:
-							MATCH_AND_RETURN_INSTR(FCVT_L_D);
-						case RS2_FCVT_LU_D:
-							MATCH_AND_RETURN_INSTR(FCVT_LU_D);
-					}
-					break;
-				case F7_FSQRT_S:
-					MATCH_AND_RETURN_INSTR(FSQRT_S);
-				case F7_FSQRT_D:
-					MATCH_AND_RETURN_INSTR(FSQRT_D);
-				case F7_FCVT_W_S:
-					switch (instr.rs2()) {
-						case RS2_FCVT_W_S:
-							MATCH_AND_RETURN_INSTR(FCVT_W_S);
-						case RS2_FCVT_WU_S:
-							MATCH_AND_RETURN_INSTR(FCVT_WU_S);
-						case RS2_FCVT_L_S:
-							MATCH_AND_RETURN_INSTR(FCVT_L_S);
-						case RS2_FCVT_LU_S:
-							MATCH_AND_RETURN_INSTR(FCVT_LU_S);
-					}
-					break;
-				case F7_FMV_X_W:
-					switch (instr.funct3()) {
-						case F3_FMV_X_W:
-							MATCH_AND_RETURN_INSTR(FMV_X_W);
-						case F3_FCLASS_S:
-							MATCH_AND_RETURN_INSTR(FCLASS_S);
-					}
-					break;
-				case F7_FMV_X_D:
-					switch (instr.funct3()) {
-						case F3_FMV_X_D:
-							MATCH_AND_RETURN_INSTR(FMV_X_D);
-						case F3_FCLASS_D:
-							MATCH_AND_RETURN_INSTR(FCLASS_D);
-					}
-					break;
-				case F7_FMV_W_X:
-					MATCH_AND_RETURN_INSTR(FMV_W_X);
-				case F7_FMV_D_X:
-					MATCH_AND_RETURN_INSTR(FMV_D_X);
-			}
-			break;
-		case OP_FLW:
-			switch (instr.funct3()) {
-				case F3_FLW:
-					MATCH_AND_RETURN_INSTR(FLW);
-				case F3_FLD:
-					MATCH_AND_RETURN_INSTR(FLD);
-			}
-			break;
-		case OP_FSW:
-			switch (instr.funct3()) {
-				case F3_FSW:
-					MATCH_AND_RETURN_INSTR(FSW);
-				case F3_FSD:
-					MATCH_AND_RETURN_INSTR(FSD);
-			}
-			break;
-		case OP_FMSUB_S:
-			switch (instr.funct2()) {
-				case F2_FMSUB_S:
-					MATCH_AND_RETURN_INSTR(FMSUB_S);
-				case F2_FMSUB_D:
-					MATCH_AND_RETURN_INSTR(FMSUB_D);
-			}
-			break;
-		case OP_FNMSUB_S:
-			switch (instr.funct2()) {
-				case F2_FNMSUB_S:
-					MATCH_AND_RETURN_INSTR(FNMSUB_S);
-				case F2_FNMSUB_D:
-					MATCH_AND_RETURN_INSTR(FNMSUB_D);
-			}
-			break;
-		case OP_FNMADD_S:
-			switch (instr.funct2()) {
-				case F2_FNMADD_S:
-					MATCH_AND_RETURN_INSTR(FNMADD_S);
-				case F2_FNMADD_D:
-					MATCH_AND_RETURN_INSTR(FNMADD_D);
-			}
-			break;
-		
-		// IDAGI Extension Start
-		case OP_CUST3: {
-			MATCH_AND_RETURN_INSTR(IDAGI_SET);
-			break;
-		}
-		// IDAGI Extension End
+constexpr auto decode_sizes = build_decode_tables<64, 8192>();
+constexpr DecodeTables<decode_sizes.splits, decode_sizes.num_candidates> decode_tables =
+    build_decode_tables<decode_sizes.splits, decode_sizes.num_candidates>();
+
+}  // namespace
+
+Opcode::Mapping Instruction::decode_normal(Architecture arch) {
+	uint32_t bits = instr;
+
+	const Slot *slot = &decode_tables.level1[level1_index(bits)];
+	if (slot->count == SPLIT)
+		slot = &decode_tables.level2[slot->first * LEVEL2_SLOTS + (bits >> 25)];
+
+	for (unsigned i = slot->first; i < slot->first + slot->count; ++i) {
+		const Encoding &e = decode_tables.entries[decode_tables.candidates[i]];
+		if ((bits & e.mask) == e.match && (e.archs & (1 << arch)))
+			return e.op;
 	}
 
-	return UNDEF;
+	return Opcode::UNDEF;
 }
@@ -236,196 +236,11 @@ enum Parts {
 enum Mapping {
 	UNDEF = 0,
 
-	// RV32I base instruction set
-	LUI = 1,
-	AUIPC,
-	JAL,
-	JALR,
-	BEQ,
-	BNE,
-	BLT,
-	BGE,
-	BLTU,
-	BGEU,
-	LB,
-	LH,
-	LW,
-	LBU,
-	LHU,
-	SB,
-	SH,
-	SW,
-	ADDI,
-	SLTI,
-	SLTIU,
-	XORI,
-	ORI,
-	ANDI,
-	SLLI,
-	SRLI,
-	SRAI,
-	ADD,
-	SUB,
-	SLL,
-	SLT,
-	SLTU,
-	XOR,
-	SRL,
-	SRA,
-	OR,
-	AND,
-	FENCE,
-	ECALL,
-	EBREAK,
-
-	// Zifencei standard extension
-	FENCE_I,
-
-	// Zicsr standard extension
-	CSRRW,
-	CSRRS,
-	CSRRC,
-	CSRRWI,
-	CSRRSI,
-	CSRRCI,
-
-	// RV32M standard extension
-	MUL,
-	MULH,
-	MULHSU,
-	MULHU,
-	DIV,
-	DIVU,
-	REM,
-	REMU,
-
-	// RV32A standard extension
-	LR_W,
-	SC_W,
-	AMOSWAP_W,
-	AMOADD_W,
-	AMOXOR_W,
-	AMOAND_W,
-	AMOOR_W,
-	AMOMIN_W,
-	AMOMAX_W,
-	AMOMINU_W,
-	AMOMAXU_W,
-
-	// RV64I base integer set (addition to RV32I)
-	LWU,
-	LD,
-	SD,
-	ADDIW,
-	SLLIW,
-	SRLIW,
-	SRAIW,
-	ADDW,
-	SUBW,
-	SLLW,
-	SRLW,
-	SRAW,
-
-	// RV64M standard extension (addition to RV32M)
-	MULW,
-	DIVW,
-	DIVUW,
-	REMW,
-	REMUW,
-
-	// RV64A standard extension (addition to RV32A)
-	LR_D,
-	SC_D,
-	AMOSWAP_D,
-	AMOADD_D,
-	AMOXOR_D,
-	AMOAND_D,
-	AMOOR_D,
-	AMOMIN_D,
-	AMOMAX_D,
-	AMOMINU_D,
-	AMOMAXU_D,
-
-	// RV32F standard extension
-	FLW,
-	FSW,
-	FMADD_S,
-	FMSUB_S,
-	FNMADD_S,
-	FNMSUB_S,
-	FADD_S,
-	FSUB_S,
-	FMUL_S,
-	FDIV_S,
-	FSQRT_S,
-	FSGNJ_S,
-	FSGNJN_S,
-	FSGNJX_S,
-	FMIN_S,
-	FMAX_S,
-	FCVT_W_S,
-	FCVT_WU_S,
-	FMV_X_W,
-	FEQ_S,
-	FLT_S,
-	FLE_S,
-	FCLASS_S,
-	FCVT_S_W,
-	FCVT_S_WU,
-	FMV_W_X,
-
-	// RV64F standard extension (addition to RV32F)
-	FCVT_L_S,
-	FCVT_LU_S,
-	FCVT_S_L,
-	FCVT_S_LU,
-
-	// RV32D standard extension
-	FLD,
-	FSD,
-	FMADD_D,
-	FMSUB_D,
-	FNMSUB_D,
-	FNMADD_D,
-	FADD_D,
-	FSUB_D,
-	FMUL_D,
-	FDIV_D,
-	FSQRT_D,
-	FSGNJ_D,
-	FSGNJN_D,
-	FSGNJX_D,
-	FMIN_D,
-	FMAX_D,
-	FCVT_S_D,
-	FCVT_D_S,
-	FEQ_D,
-	FLT_D,
-	FLE_D,
-	FCLASS_D,
-	FCVT_W_D,
-	FCVT_WU_D,
-	FCVT_D_W,
-	FCVT_D_WU,
-
-	// RV64D standard extension (addition to RV32D)
-	FCVT_L_D,
-	FCVT_LU_D,
-	FMV_X_D,
-	FCVT_D_L,
-	FCVT_D_LU,
-	FMV_D_X,
-	
-	// idagi Extension Start
-	IDAGI_SET,
-	// idagi Extension End
-
-	// privileged instructions
-	URET,
-	SRET,
-	MRET,
-	WFI,
-	SFENCE_VMA,
+#define INSTR(name, type, mask, match) name,
+#define RV32_INSTR(name, mask, match)
+#include "instr_table.h"
+#undef INSTR
+#undef RV32_INSTR
 
 	NUMBER_OF_INSTRUCTIONS
 };
@@ -446,6 +261,11 @@ enum class Type {
 extern std::array<const char*, NUMBER_OF_INSTRUCTIONS> mappingStr;
 
 Type getType(Mapping mapping);
+
+// Whether the ISS ends a basic block with this instruction: control
+// transfers, and the instructions that read counters, lock the bus, wait
+// or change the privilege state
+bool endsBasicBlock(Mapping mapping);
 }  // namespace Opcode
 
 #define BIT_RANGE(instr, upper, lower) (instr & (((1 << (upper - lower + 1)) - 1) << lower))
@@ -0,0 +1,203 @@
+/*
+ * The RV32/RV64 instructions, with their format and their encoding: an
+ * instruction matches when (instr & mask) == match. Opcode::Mapping,
+ * Opcode::mappingStr, Opcode::getType and the tables of the decoder
+ * (Instruction::decode_normal) are generated from it, an instruction is
+ * added here only. No include guard: included with INSTR(name, type, mask,
+ * match) and RV32_INSTR(name, mask, match) defined, the latter replaces the
+ * encoding of name on RV32.
+ */
+
+// RV32I base instruction set
+INSTR(LUI, U, 0x0000007f, 0x00000037)
+INSTR(AUIPC, U, 0x0000007f, 0x00000017)
+INSTR(JAL, J, 0x0000007f, 0x0000006f)
+INSTR(JALR, I, 0x0000707f, 0x00000067)
+INSTR(BEQ, B, 0x0000707f, 0x00000063)
+INSTR(BNE, B, 0x0000707f, 0x00001063)
+INSTR(BLT, B, 0x0000707f, 0x00004063)
+INSTR(BGE, B, 0x0000707f, 0x00005063)
+INSTR(BLTU, B, 0x0000707f, 0x00006063)
+INSTR(BGEU, B, 0x0000707f, 0x00007063)
+INSTR(LB, I, 0x0000707f, 0x00000003)
+INSTR(LH, I, 0x0000707f, 0x00001003)
+INSTR(LW, I, 0x0000707f, 0x00002003)
+INSTR(LBU, I, 0x0000707f, 0x00004003)
+INSTR(LHU, I, 0x0000707f, 0x00005003)
+INSTR(SB, S, 0x0000707f, 0x00000023)
+INSTR(SH, S, 0x0000707f, 0x00001023)
+INSTR(SW, S, 0x0000707f, 0x00002023)
+INSTR(ADDI, I, 0x0000707f, 0x00000013)
+INSTR(SLTI, I, 0x0000707f, 0x00002013)
+INSTR(SLTIU, I, 0x0000707f, 0x00003013)
+INSTR(XORI, I, 0x0000707f, 0x00004013)
+INSTR(ORI, I, 0x0000707f, 0x00006013)
+INSTR(ANDI, I, 0x0000707f, 0x00007013)
+INSTR(SLLI, R, 0xfc00707f, 0x00001013)
+INSTR(SRLI, R, 0xfc00707f, 0x00005013)
+INSTR(SRAI, R, 0xfc00707f, 0x40005013)
+// RV32 encodings of the shifts by an immediate, with a 5 bit shamt
+RV32_INSTR(SLLI, 0xfe00707f, 0x00001013)
+RV32_INSTR(SRLI, 0xfe00707f, 0x00005013)
+RV32_INSTR(SRAI, 0xfe00707f, 0x40005013)
+INSTR(ADD, R, 0xfe00707f, 0x00000033)
+INSTR(SUB, R, 0xfe00707f, 0x40000033)
+INSTR(SLL, R, 0xfe00707f, 0x00001033)
+INSTR(SLT, R, 0xfe00707f, 0x00002033)
+INSTR(SLTU, R, 0xfe00707f, 0x00003033)
+INSTR(XOR, R, 0xfe00707f, 0x00004033)
+INSTR(SRL, R, 0xfe00707f, 0x00005033)
+INSTR(SRA, R, 0xfe00707f, 0x40005033)
+INSTR(OR, R, 0xfe00707f, 0x00006033)
+INSTR(AND, R, 0xfe00707f, 0x00007033)
+INSTR(FENCE, UNKNOWN, 0x0000707f, 0x0000000f)
+INSTR(ECALL, UNKNOWN, 0xffffffff, 0x00000073)
+INSTR(EBREAK, UNKNOWN, 0xffffffff, 0x00100073)
+
+// Zifencei standard extension
+INSTR(FENCE_I, UNKNOWN, 0x0000707f, 0x0000100f)
+
+// Zicsr standard extension
+INSTR(CSRRW, UNKNOWN, 0x0000707f, 0x00001073)
+INSTR(CSRRS, UNKNOWN, 0x0000707f, 0x00002073)
+INSTR(CSRRC, UNKNOWN, 0x0000707f, 0x00003073)
+INSTR(CSRRWI, UNKNOWN, 0x0000707f, 0x00005073)
+INSTR(CSRRSI, UNKNOWN, 0x0000707f, 0x00006073)
+INSTR(CSRRCI, UNKNOWN, 0x0000707f, 0x00007073)
+
+// RV32M standard extension
+INSTR(MUL, R, 0xfe00707f, 0x02000033)
+INSTR(MULH, R, 0xfe00707f, 0x02001033)
+INSTR(MULHSU, R, 0xfe00707f, 0x02002033)
+INSTR(MULHU, R, 0xfe00707f, 0x02003033)
+INSTR(DIV, R, 0xfe00707f, 0x02004033)
+INSTR(DIVU, R, 0xfe00707f, 0x02005033)
+INSTR(REM, R, 0xfe00707f, 0x02006033)
+INSTR(REMU, R, 0xfe00707f, 0x02007033)
+
+// RV32A standard extension
+INSTR(LR_W, R, 0xf9f0707f, 0x1000202f)
+INSTR(SC_W, R, 0xf800707f, 0x1800202f)
+INSTR(AMOSWAP_W, R, 0xf800707f, 0x0800202f)
+INSTR(AMOADD_W, R, 0xf800707f, 0x0000202f)
+INSTR(AMOXOR_W, R, 0xf800707f, 0x2000202f)
+INSTR(AMOAND_W, R, 0xf800707f, 0x6000202f)
+INSTR(AMOOR_W, R, 0xf800707f, 0x4000202f)
+INSTR(AMOMIN_W, R, 0xf800707f, 0x8000202f)
+INSTR(AMOMAX_W, R, 0xf800707f, 0xa000202f)
+INSTR(AMOMINU_W, R, 0xf800707f, 0xc000202f)
+INSTR(AMOMAXU_W, R, 0xf800707f, 0xe000202f)
+
+// RV64I base integer set (addition to RV32I)
+INSTR(LWU, I, 0x0000707f, 0x00006003)
+INSTR(LD, I, 0x0000707f, 0x00003003)
+INSTR(SD, S, 0x0000707f, 0x00003023)
+INSTR(ADDIW, I, 0x0000707f, 0x0000001b)
+INSTR(SLLIW, I, 0xfe00707f, 0x0000101b)
+INSTR(SRLIW, I, 0xfe00707f, 0x0000501b)
+INSTR(SRAIW, I, 0xfe00707f, 0x4000501b)
+INSTR(ADDW, R, 0xfe00707f, 0x0000003b)
+INSTR(SUBW, R, 0xfe00707f, 0x4000003b)
+INSTR(SLLW, R, 0xfe00707f, 0x0000103b)
+INSTR(SRLW, R, 0xfe00707f, 0x0000503b)
+INSTR(SRAW, R, 0xfe00707f, 0x4000503b)
+
+// RV64M standard extension (addition to RV32M)
+INSTR(MULW, R, 0xfe00707f, 0x0200003b)
+INSTR(DIVW, R, 0xfe00707f, 0x0200403b)
+INSTR(DIVUW, R, 0xfe00707f, 0x0200503b)
+INSTR(REMW, R, 0xfe00707f, 0x0200603b)
+INSTR(REMUW, R, 0xfe00707f, 0x0200703b)
+
+// RV64A standard extension (addition to RV32A)
+INSTR(LR_D, R, 0xf9f0707f, 0x1000302f)
+INSTR(SC_D, R, 0xf800707f, 0x1800302f)
+INSTR(AMOSWAP_D, R, 0xf800707f, 0x0800302f)
+INSTR(AMOADD_D, R, 0xf800707f, 0x0000302f)
+INSTR(AMOXOR_D, R, 0xf800707f, 0x2000302f)
+INSTR(AMOAND_D, R, 0xf800707f, 0x6000302f)
+INSTR(AMOOR_D, R, 0xf800707f, 0x4000302f)
+INSTR(AMOMIN_D, R, 0xf800707f, 0x8000302f)
+INSTR(AMOMAX_D, R, 0xf800707f, 0xa000302f)
+INSTR(AMOMINU_D, R, 0xf800707f, 0xc000302f)
+INSTR(AMOMAXU_D, R, 0xf800707f, 0xe000302f)
+
+// RV32F standard extension
+INSTR(FLW, I, 0x0000707f, 0x00002007)
+INSTR(FSW, S, 0x0000707f, 0x00002027)
+INSTR(FMADD_S, R4, 0x0600007f, 0x00000043)
+INSTR(FMSUB_S, R4, 0x0600007f, 0x00000047)
+INSTR(FNMADD_S, R4, 0x0600007f, 0x0000004f)
+INSTR(FNMSUB_S, R4, 0x0600007f, 0x0000004b)
+INSTR(FADD_S, R, 0xfe00007f, 0x00000053)
+INSTR(FSUB_S, R, 0xfe00007f, 0x08000053)
+INSTR(FMUL_S, R, 0xfe00007f, 0x10000053)
+INSTR(FDIV_S, R, 0xfe00007f, 0x18000053)
+INSTR(FSQRT_S, R, 0xfff0007f, 0x58000053)
+INSTR(FSGNJ_S, R, 0xfe00707f, 0x20000053)
+INSTR(FSGNJN_S, R, 0xfe00707f, 0x20001053)
+INSTR(FSGNJX_S, R, 0xfe00707f, 0x20002053)
+INSTR(FMIN_S, R, 0xfe00707f, 0x28000053)
+INSTR(FMAX_S, R, 0xfe00707f, 0x28001053)
+INSTR(FCVT_W_S, R, 0xfff0007f, 0xc0000053)
+INSTR(FCVT_WU_S, R, 0xfff0007f, 0xc0100053)
+INSTR(FMV_X_W, R, 0xfff0707f, 0xe0000053)
+INSTR(FEQ_S, R, 0xfe00707f, 0xa0002053)
+INSTR(FLT_S, R, 0xfe00707f, 0xa0001053)
+INSTR(FLE_S, R, 0xfe00707f, 0xa0000053)
+INSTR(FCLASS_S, R, 0xfff0707f, 0xe0001053)
+INSTR(FCVT_S_W, R, 0xfff0007f, 0xd0000053)
+INSTR(FCVT_S_WU, R, 0xfff0007f, 0xd0100053)
+INSTR(FMV_W_X, R, 0xfff0707f, 0xf0000053)
+
+// RV64F standard extension (addition to RV32F)
+INSTR(FCVT_L_S, R, 0xfff0007f, 0xc0200053)
+INSTR(FCVT_LU_S, R, 0xfff0007f, 0xc0300053)
+INSTR(FCVT_S_L, R, 0xfff0007f, 0xd0200053)
+INSTR(FCVT_S_LU, R, 0xfff0007f, 0xd0300053)
+
+// RV32D standard extension
+INSTR(FLD, I, 0x0000707f, 0x00003007)
+INSTR(FSD, S, 0x0000707f, 0x00003027)
+INSTR(FMADD_D, R4, 0x0600007f, 0x02000043)
+INSTR(FMSUB_D, R4, 0x0600007f, 0x02000047)
+INSTR(FNMSUB_D, R4, 0x0600007f, 0x0200004b)
+INSTR(FNMADD_D, R4, 0x0600007f, 0x0200004f)
+INSTR(FADD_D, R, 0xfe00007f, 0x02000053)
+INSTR(FSUB_D, R, 0xfe00007f, 0x0a000053)
+INSTR(FMUL_D, R, 0xfe00007f, 0x12000053)
+INSTR(FDIV_D, R, 0xfe00007f, 0x1a000053)
+INSTR(FSQRT_D, R, 0xfff0007f, 0x5a000053)
+INSTR(FSGNJ_D, R, 0xfe00707f, 0x22000053)
+INSTR(FSGNJN_D, R, 0xfe00707f, 0x22001053)
+INSTR(FSGNJX_D, R, 0xfe00707f, 0x22002053)
+INSTR(FMIN_D, R, 0xfe00707f, 0x2a000053)
+INSTR(FMAX_D, R, 0xfe00707f, 0x2a001053)
+INSTR(FCVT_S_D, R, 0xfff0007f, 0x40100053)
+INSTR(FCVT_D_S, R, 0xfff0007f, 0x42000053)
+INSTR(FEQ_D, R, 0xfe00707f, 0xa2002053)
+INSTR(FLT_D, R, 0xfe00707f, 0xa2001053)
+INSTR(FLE_D, R, 0xfe00707f, 0xa2000053)
+INSTR(FCLASS_D, R, 0xfff0707f, 0xe2001053)
+INSTR(FCVT_W_D, R, 0xfff0007f, 0xc2000053)
+INSTR(FCVT_WU_D, R, 0xfff0007f, 0xc2100053)
+INSTR(FCVT_D_W, R, 0xfff0007f, 0xd2000053)
+INSTR(FCVT_D_WU, R, 0xfff0007f, 0xd2100053)
+
+// RV64D standard extension (addition to RV32D)
+INSTR(FCVT_L_D, R, 0xfff0007f, 0xc2200053)
+INSTR(FCVT_LU_D, R, 0xfff0007f, 0xc2300053)
+INSTR(FMV_X_D, R, 0xfff0707f, 0xe2000053)
+INSTR(FCVT_D_L, R, 0xfff0007f, 0xd2200053)
+INSTR(FCVT_D_LU, R, 0xfff0007f, 0xd2300053)
+INSTR(FMV_D_X, R, 0xfff0707f, 0xf2000053)
+
+// idagi extension
+INSTR(IDAGI_SET, IDAGI, 0x0000007f, 0x0000007b)
+
+// privileged instructions
+INSTR(URET, UNKNOWN, 0xffffffff, 0x00200073)
+INSTR(SRET, UNKNOWN, 0xffffffff, 0x10200073)
+INSTR(MRET, UNKNOWN, 0xffffffff, 0x30200073)
+INSTR(WFI, UNKNOWN, 0xffffffff, 0x10500073)
+INSTR(SFENCE_VMA, UNKNOWN, 0xfe007fff, 0x12000073)
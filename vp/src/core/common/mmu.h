@@ -67,9 +67,14 @@ struct GenericMMU {
     mmu_memory_if *mem = nullptr;
     bool page_fault_on_AD = false;
 
+    // Translations of the pages accessed lately. The entries of pages
+    // backed by DMI memory also map the virtual page to the host memory:
+    // the host address of vaddr is vaddr + host_offset
     struct tlb_entry_t {
         uint64_t ppn = -1;
         uint64_t vpn = -1;
+        uintptr_t host_offset = 0;
+        bool host = false;
     };
 
     static constexpr unsigned TLB_ENTRIES = 256;
@@ -83,11 +88,36 @@ struct GenericMMU {
         flush_tlb();
     }
 
+    // on sfence.vma and on satp, mstatus.SUM and mstatus.MXR writes; the
+    // entries are kept per privilege mode and access type
     void flush_tlb() {
-        memset(&tlb[0], -1, NUM_MODES * NUM_ACCESS_TYPES * TLB_ENTRIES * sizeof(tlb_entry_t));
+        for (auto &modes : tlb)
+            for (auto &types : modes)
+                for (auto &x : types)
+                    x = tlb_entry_t();
+    }
+
+    // Whether the accesses of type go through the page tables now
+    bool translates(MemoryAccessType type) {
+        if (core.csrs.satp.mode == SATP_MODE_BARE)
+            return false;
+        auto mode = core.prv;
+        if (type != FETCH && core.csrs.mstatus.mprv)
+            mode = core.csrs.mstatus.mpp;
+        return mode != MachineMode;
     }
 
     uint64_t translate_virtual_to_physical_addr(uint64_t vaddr, MemoryAccessType type) {
+        uint8_t *host;
+        return translate(vaddr, type, 1, host);
+    }
+
+    // Translate the num_bytes at vaddr. When the TLB maps their page to
+    // DMI memory, host is set to their host address (a TLB hit then costs
+    // one add) and the access can bypass the bus; host is nullptr
+    // otherwise, and always without translation (bare or machine mode)
+    uint64_t translate(uint64_t vaddr, MemoryAccessType type, unsigned num_bytes, uint8_t *&host) {
+        host = nullptr;
         if (core.csrs.satp.mode == SATP_MODE_BARE)
             return vaddr;
 
@@ -110,16 +140,20 @@ struct GenericMMU {
         auto vpn = (vaddr >> PGSHIFT);
         auto idx = vpn % TLB_ENTRIES;
         auto &x = tlb[mode][type][idx];
-        if (x.vpn == vpn)
-            return x.ppn | (vaddr & PGMASK);
-
-        uint64_t paddr = walk(vaddr, type, mode);
-
-        // optimization only, to void page walk
-        x.ppn = (paddr & ~PGMASK);
-        x.vpn = vpn;
+        if (x.vpn != vpn) {
+            uint64_t paddr = walk(vaddr, type, mode);
+
+            // optimization only, to void page walk
+            x.ppn = (paddr & ~PGMASK);
+            x.vpn = vpn;
+            uint8_t *page = mem->mmu_dmi_page(x.ppn);
+            x.host = page != nullptr;
+            x.host_offset = (uintptr_t)page - (vpn << PGSHIFT);
+        }
 
-        return paddr;
+        if (x.host && (vaddr & PGMASK) + num_bytes <= PGSIZE)
+            host = (uint8_t *)(vaddr + x.host_offset);
+        return x.ppn | (vaddr & PGMASK);
     }
 
     vm_info decode_vm_info(PrivilegeLevel prv) {
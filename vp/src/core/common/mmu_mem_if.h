@@ -12,6 +12,13 @@ struct mmu_memory_if {
     virtual uint64_t mmu_load_pte64(uint64_t addr) = 0;
     virtual uint64_t mmu_load_pte32(uint64_t addr) = 0;
     virtual void mmu_store_pte32(uint64_t addr, uint32_t value) = 0;
+
+    // Host address of the physical page at paddr (page aligned) when its
+    // accesses can bypass the bus, nullptr otherwise
+    virtual uint8_t *mmu_dmi_page(uint64_t paddr) {
+        (void)paddr;
+        return nullptr;
+    }
 };
 
 #endif //RISCV_VP_MMU_MEM_IF_H
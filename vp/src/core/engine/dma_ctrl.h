@@ -63,6 +63,16 @@ public:
 
     bool has_send = false;
 
+    // Round trip through the HBM run once after reset: test_data is
+    // written and read back, see handle_recv_state()
+    bool hbm_test = false;
+    bool has_read = false;   // The read has been sent, its response not processed yet
+
+    // Whether the self-test still has work to do
+    bool busy() const {
+        return current_state != IDLE || has_received_local_trans || (hbm_test && (!has_send || has_read));
+    }
+
 	// State machine main method
 	void state_machine() {
 		if (reset.read()) {
@@ -75,7 +85,6 @@ public:
 		// State machine logic
 		switch (current_state) {
 			case IDLE:
-                break;
 				if (has_received_local_trans) {
 					current_state = RECV;
 				} else if (cmd_queue.num_available() > 0) {
@@ -84,7 +93,7 @@ public:
 					// Determine next state based on command content
 					// Currently simple handling: all commands go to SEND state
 					current_state = SEND;
-				} else if (!strcmp(name(), "DMACTRL[4,5]") && !has_send) {
+				} else if (hbm_test && !has_send) {
 					current_state = SEND;
 				}
 				break;
@@ -134,16 +143,13 @@ public:
 	void handle_send_state() {
         // assert(current_cmd != nullptr && "current_cmd is nullptr");
 
-        uint8_t *data_ptr = new uint8_t[16];
-        memcpy(data_ptr, test_data, 16);
-
-        // Create a header
+        // Create a header, the NIU copies the data it points to
         Header header;
         header.dst_id = 0;
         header.hbm_id = -1;
         header.cmd = TLM_WRITE_COMMAND;
         header.addr = 0;
-        header.data = data_ptr;
+        header.data = test_data;
         header.len = 12;
 
         // Create a tlm_generic_payload
@@ -177,6 +183,7 @@ public:
         header.hbm_id = -1;
         header.cmd = TLM_READ_COMMAND;
         header.addr = 0;
+        header.data = nullptr;
         header.len = 12;
 
         // Create a tlm_generic_payload
@@ -193,6 +200,7 @@ public:
         if (trans.get_response_status() == TLM_OK_RESPONSE) {
             // Return to IDLE state
             std::cout << "\033[1;31m" << name() << ": Has Send READ transaction\033[0m" << std::endl;
+            has_read = true;
             current_state = IDLE;
         }
 	}
@@ -205,6 +213,15 @@ public:
             printf("\033[1;33m%c\033[0m", byte);
         }
         printf("\n");
+
+        // The response to the read of the self-test holds what was written
+        if (has_read) {
+            if (router_data_buffer.size() != 12 || memcmp(router_data_buffer.data(), test_data, 12)) {
+                std::cerr << "Error: " << name() << " read back from the HBM differs from what was written" << std::endl;
+                exit(1);
+            }
+            has_read = false;
+        }
         
         // Reset flag
         has_received_local_trans = false;
@@ -5,6 +5,7 @@
 #include <tlm_utils/simple_initiator_socket.h>
 #include <tlm_utils/simple_target_socket.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <systemc>
@@ -18,11 +19,28 @@
 using namespace sc_core;
 using namespace tlm;
 
+// 一条命令，或 SharedMemory 中 addr 处的 count 条描述符
+struct Submission {
+	Fileds* fileds = nullptr;
+	uint32_t addr = 0;
+	uint32_t count = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Submission& s) {
+	if (s.fileds) {
+		os << "command";
+	} else {
+		os << s.count << " descriptors at " << s.addr;
+	}
+	return os;
+}
+
 struct Scheduler : sc_module {
 	tlm_utils::simple_target_socket<Scheduler> tsock;
 	tlm_utils::simple_initiator_socket<Scheduler> spu_isock;
 	tlm_utils::simple_initiator_socket<Scheduler> ae_isock;
 	tlm_utils::simple_initiator_socket<Scheduler> dma_isock;
+	tlm_utils::simple_initiator_socket<Scheduler> mem_isock;  // descriptors
 
 	SPU* spu_ref;
 	AE* ae_ref;
@@ -31,7 +49,7 @@ struct Scheduler : sc_module {
 	tlm::tlm_generic_payload trans;
 	sc_time delay;
 
-	sc_fifo<Fileds*> cmd_queue;
+	sc_fifo<Submission> cmd_queue;
 	std::map<std::string, int> resource_table;
 
     SC_CTOR(Scheduler) : spu_ref(nullptr), ae_ref(nullptr), dma_ref(nullptr) {
@@ -78,7 +96,7 @@ struct Scheduler : sc_module {
 		trans.set_data_ptr(reinterpret_cast<unsigned char*>(&fileds));
 		trans.set_write();
 
-		uint32_t opcode = fileds["opcode"];
+		uint32_t opcode = fileds.regs[IDAGI_OPCODE];
 		tlm_sync_enum result;
 
 		while (true) {
@@ -119,7 +137,7 @@ struct Scheduler : sc_module {
 	}
 
 	void dispatch(Fileds& fileds) {
-		uint32_t opcode = fileds["opcode"];
+		uint32_t opcode = fileds.regs[IDAGI_OPCODE];
 
 		if (opcode == Engine::FENCE) {
 			printf("%s: FENCE\n", this->name());
@@ -130,18 +148,59 @@ struct Scheduler : sc_module {
 		}
 	}
 
+	// Read the descriptors from the shared memory, DESC_BATCH at a time
+	void fetch_descriptors(uint32_t addr, uint32_t count) {
+		static constexpr uint32_t DESC_BATCH = 16;
+		IDAGIDescriptor batch[DESC_BATCH];
+
+		while (count > 0) {
+			uint32_t n = std::min(count, DESC_BATCH);
+
+			tlm::tlm_generic_payload mem_trans;
+			mem_trans.set_command(tlm::TLM_READ_COMMAND);
+			mem_trans.set_address(addr);
+			mem_trans.set_data_ptr(reinterpret_cast<unsigned char*>(batch));
+			mem_trans.set_data_length(n * sizeof(IDAGIDescriptor));
+			mem_trans.set_response_status(tlm::TLM_OK_RESPONSE);
+			sc_time mem_delay = SC_ZERO_TIME;
+			mem_isock->b_transport(mem_trans, mem_delay);
+			wait(mem_delay);
+
+			for (uint32_t i = 0; i < n; i++) {
+				dispatch(*(Fileds*)IDAGIExtension::build_fileds(batch[i].regs));
+
+				wait(10, sc_core::SC_NS);  // Simulate interval between instructions
+			}
+
+			addr += n * sizeof(IDAGIDescriptor);
+			count -= n;
+		}
+	}
+
 	void schedule() {
 		while (true) {
-			Fileds* fileds = cmd_queue.read();
-			dispatch(*fileds);
+			Submission s = cmd_queue.read();
+			if (!s.fileds) {
+				fetch_descriptors(s.addr, s.count);
+				continue;
+			}
+
+			dispatch(*s.fileds);
 
 			wait(10, sc_core::SC_NS);  // Simulate interval between instructions
 		}
 	}
 
 	void b_transport(tlm::tlm_generic_payload& trans, sc_core::sc_time& delay) {
-		Fileds* fileds = (Fileds*)trans.get_data_ptr();
-		cmd_queue.write(fileds);
+		Submission s;
+		if (trans.get_address() == IDAGI_DESCRIPTORS) {
+			uint32_t* batch = (uint32_t*)trans.get_data_ptr();
+			s.addr = batch[0];
+			s.count = batch[1];
+		} else {
+			s.fileds = (Fileds*)trans.get_data_ptr();
+		}
+		cmd_queue.write(s);
 	}
 };
 
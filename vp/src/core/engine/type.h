@@ -3,6 +3,7 @@
 
 #include <memory.h>
 
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <fstream>
@@ -10,7 +11,8 @@
 #include <iostream>
 #include <vector>
 
-#define NR_REG 54
+#define NR_REG 55
+#define IDAGI_OPCODE 1  // opcode
 
 enum Engine {
 	FENCE = 0b000000,
@@ -126,65 +128,6 @@ class FP8 {
 
 class Fileds {
 public:
-    // 寄存器数组：通过序号访问寄存器名称
-    std::string abiName[NR_REG] = {
-        "zero",
-        "opcode",
-        "mma.opmask",
-        "mma.hp.en",
-        "mma.lp.en",
-        "mma.n",
-        "mma.k",
-        "mma.m",
-        "mma.hp.addr",
-        "mma.hp.stride",
-        "mma.hp.dtype",
-        "mma.lp.addr",
-        "mma.lp.stride",
-        "mma.lp.dtype",
-        "mma.w.addr",
-        "mma.w.stride",
-        "mma.w.dtype",
-        "mma.mask.addr",
-        "mma.mask.stride",
-        "mma.scale.hp.addr",
-        "mma.scale.hp.stride",
-        "mma.scale.lp.addr",
-        "mma.scale.lp.stride",
-        "mma.scale.w.addr",
-        "mma.scale.w.stride",
-        "mma.acc.addr",
-        "mma.acc.stride",
-        "mma.out.addr",
-        "mma.out.stride",
-        "mma.out.dtype",
-        "smx.opmask",
-        "smx.max.val",
-        "smx.m",
-        "smx.n",
-        "smx.dim",
-        "smx.in.addr",
-        "smx.in.stride",
-        "smx.in.dtype",
-        "smx.p.addr",
-        "smx.p.stride",
-        "smx.out.addr",
-        "smx.out.stride",
-        "smx.out.dtype",
-        "smx.init",
-        "act.opmask",
-        "act.mode",
-        "act.m",
-        "act.n",
-        "act.in.addr",
-        "act.in.stride",
-        "act.in.dtype",
-        "act.out.addr",
-        "act.out.stride",
-        "act.out.dtype",
-    };
-    
-    std::map<std::string, int> nameToIndex;
     uint32_t regs[NR_REG] = {0}; 
 
 
@@ -193,30 +136,97 @@ public:
     uint32_t w_dtype_size  = 0;
 
 public:
-    Fileds() {
-        for (int i = 0; i < NR_REG; ++i) {
-            nameToIndex[abiName[i]] = i;
-        }
+    // 寄存器数组：通过序号访问寄存器名称，所有命令共用
+    static const std::string& abiName(int index) {
+        static const std::string names[NR_REG] = {
+            "zero",
+            "opcode",
+            "mma.opmask",
+            "mma.hp.en",
+            "mma.lp.en",
+            "mma.n",
+            "mma.k",
+            "mma.m",
+            "mma.hp.addr",
+            "mma.hp.stride",
+            "mma.hp.dtype",
+            "mma.lp.addr",
+            "mma.lp.stride",
+            "mma.lp.dtype",
+            "mma.w.addr",
+            "mma.w.stride",
+            "mma.w.dtype",
+            "mma.mask.addr",
+            "mma.mask.stride",
+            "mma.scale.hp.addr",
+            "mma.scale.hp.stride",
+            "mma.scale.lp.addr",
+            "mma.scale.lp.stride",
+            "mma.scale.w.addr",
+            "mma.scale.w.stride",
+            "mma.acc.addr",
+            "mma.acc.stride",
+            "mma.out.addr",
+            "mma.out.stride",
+            "mma.out.dtype",
+            "smx.opmask",
+            "smx.max.val",
+            "smx.m",
+            "smx.n",
+            "smx.dim",
+            "smx.in.addr",
+            "smx.in.stride",
+            "smx.in.dtype",
+            "smx.p.addr",
+            "smx.p.stride",
+            "smx.out.addr",
+            "smx.out.stride",
+            "smx.out.dtype",
+            "smx.init",
+            "act.opmask",
+            "act.mode",
+            "act.m",
+            "act.n",
+            "act.in.addr",
+            "act.in.stride",
+            "act.in.dtype",
+            "act.out.addr",
+            "act.out.stride",
+            "act.out.dtype",
+            "desc.addr",
+        };
+        return names[index];
+    }
+
+    static const std::map<std::string, int>& nameToIndex() {
+        static const std::map<std::string, int> index = [] {
+            std::map<std::string, int> m;
+            for (int i = 0; i < NR_REG; ++i) {
+                m[abiName(i)] = i;
+            }
+            return m;
+        }();
+        return index;
     }
 
     std::string getRegisterName(int index) const {
         if (index < 0 || index >= NR_REG) {
             throw std::out_of_range("Invalid register index!");
         }
-        return abiName[index];
+        return abiName(index);
     }
 
     int getRegisterIndex(const std::string& name) const {
-        auto it = nameToIndex.find(name);
-        if (it == nameToIndex.end()) {
+        auto it = nameToIndex().find(name);
+        if (it == nameToIndex().end()) {
             throw std::invalid_argument("Invalid register name!");
         }
         return it->second;
     }
 
     uint32_t& operator[](const std::string& name) {
-        auto it = nameToIndex.find(name);
-        if (it == nameToIndex.end()) {
+        auto it = nameToIndex().find(name);
+        if (it == nameToIndex().end()) {
             std::cout << "Stupid name: " << name << std::endl;
             throw std::invalid_argument("Invalid register name!");
         }
@@ -235,56 +245,115 @@ public:
     }
 
     uint8_t* build_fileds() {
+        return build_fileds(regs);
+    }
+
+    // 由寄存器值构建命令，也用于内存中的描述符
+    static uint8_t* build_fileds(const uint32_t* regs) {
+        const auto& kinds = filed_kinds();
         Fileds* fileds = new Fileds;
         for (int i = 0; i < NR_REG; i ++) {
-			std::string name = fileds->getRegisterName(i);
-			if (name == "mma.hp.addr" || name == "mma.lp.addr" || name == "mma.w.addr" || name == "mma.acc.addr" || name == "mma.out.addr" ||
-                name == "smx.in.addr" || name == "smx.p.addr" || name == "smx.out.addr" ||
-                name == "act.in.addr" || name == "act.out.addr") {
-				fileds->regs[i] = linearize(regs[i]);
-			} else if (name == "mma.k" || name == "mma.m" ||
-                       name == "smx.dim") {
-                switch (regs[i]) {
-                    case 0: fileds->regs[i] = 16; break;
-                    case 1: fileds->regs[i] = 32; break;
-                    case 2: fileds->regs[i] = 64; break;
-                    case 3: fileds->regs[i] = 128; break;
-                    default:
-                        printf("Invalid Code");
-                        assert(0);
-                }
-			} else if (name == "mma.hp.dtype" || name == "mma.lp.dtype" || name == "mma.w.dtype") {
-                uint32_t dtype_size = 0;
-				switch (regs[i]) {
-					case 0: dtype_size = 1; break;
-					case 1: dtype_size = 1; break;
-					case 2: dtype_size = 1; break;
-					case 3: dtype_size = 2; break;
-					case 4: dtype_size = 2; break;
-					default:
-						printf("Invalid Code");
-						assert(0);
-                }
+            switch (kinds[i]) {
+                case ADDR:
+                    fileds->regs[i] = linearize(regs[i]);
+                    break;
+                case SIZE:
+                    switch (regs[i]) {
+                        case 0: fileds->regs[i] = 16; break;
+                        case 1: fileds->regs[i] = 32; break;
+                        case 2: fileds->regs[i] = 64; break;
+                        case 3: fileds->regs[i] = 128; break;
+                        default:
+                            printf("Invalid Code");
+                            assert(0);
+                    }
+                    break;
+                case HP_DTYPE:
+                case LP_DTYPE:
+                case W_DTYPE: {
+                    uint32_t dtype_size = 0;
+                    switch (regs[i]) {
+                        case 0: dtype_size = 1; break;
+                        case 1: dtype_size = 1; break;
+                        case 2: dtype_size = 1; break;
+                        case 3: dtype_size = 2; break;
+                        case 4: dtype_size = 2; break;
+                        default:
+                            printf("Invalid Code");
+                            assert(0);
+                    }
+
+                    if (kinds[i] == HP_DTYPE) {
+                        fileds->hp_dtype_size = dtype_size;
+                    } else if (kinds[i] == LP_DTYPE) {
+                        fileds->lp_dtype_size = dtype_size;
+                    } else {
+                        fileds->w_dtype_size = dtype_size;
+                    }
+                    fileds->regs[i] = regs[i];
+                } break;
+                default:
+                    fileds->regs[i] = regs[i];
+            }
+        }
+        return (uint8_t*)fileds;
+    }
 
-                if (name == "mma.hp.dtype") {
-                    fileds->hp_dtype_size = dtype_size;
+    // 寄存器的转换方式，由名称只查找一次
+    enum FiledKind { PLAIN, ADDR, SIZE, HP_DTYPE, LP_DTYPE, W_DTYPE };
+
+    static const std::array<FiledKind, NR_REG>& filed_kinds() {
+        static const std::array<FiledKind, NR_REG> kinds = [] {
+            std::array<FiledKind, NR_REG> k;
+            for (int i = 0; i < NR_REG; i ++) {
+                const std::string& name = Fileds::abiName(i);
+                if (name == "mma.hp.addr" || name == "mma.lp.addr" || name == "mma.w.addr" || name == "mma.acc.addr" || name == "mma.out.addr" ||
+                    name == "smx.in.addr" || name == "smx.p.addr" || name == "smx.out.addr" ||
+                    name == "act.in.addr" || name == "act.out.addr") {
+                    k[i] = ADDR;
+                } else if (name == "mma.k" || name == "mma.m" || name == "smx.dim") {
+                    k[i] = SIZE;
+                } else if (name == "mma.hp.dtype") {
+                    k[i] = HP_DTYPE;
                 } else if (name == "mma.lp.dtype") {
-                    fileds->lp_dtype_size = dtype_size;
+                    k[i] = LP_DTYPE;
                 } else if (name == "mma.w.dtype") {
-                    fileds->w_dtype_size = dtype_size;
+                    k[i] = W_DTYPE;
+                } else {
+                    k[i] = PLAIN;
                 }
-				fileds->regs[i] = regs[i];
-			} else {
-				fileds->regs[i] = regs[i];
-			}
-        }
-        return (uint8_t*)fileds;
+            }
+            return k;
+        }();
+        return kinds;
     }
 
-    uint32_t linearize(uint32_t entry_bank) {
+    static uint32_t linearize(uint32_t entry_bank) {
         uint32_t entry_idx = (entry_bank >> 6) & 0xff;
         uint32_t bank_idx = (entry_bank & 0x3f);
         return (entry_idx * 64 * 64) + bank_idx * 64;
     }
 };
+
+/*
+ * 描述符：软件在 SharedMemory 中按 idg.set 的寄存器顺序写好的命令，
+ * 一次提交多条。desc.addr 给出第一条的位置（编码同其它 addr 寄存器），
+ * idg.set zero,0x1000|n 把之后的 n 条交给 Scheduler，按批读取。
+ * Scheduler 在执行过程中每次只读入 16 条，提交时并不拷贝：在
+ * idg.set zero,0x100（同步）返回之前，软件不能改写已提交的描述符。
+ */
+struct IDAGIDescriptor {
+    uint32_t regs[NR_REG];
+};
+
+#define IDAGI_DESC_ADDR (NR_REG - 1)  // desc.addr
+#define IDAGI_SUBMIT 0x1000           // idg.set zero,IDAGI_SUBMIT|n
+#define IDAGI_SUBMIT_MAX 0xfff
+
+// core 发给 Scheduler 的事务地址：一条命令 (Fileds*)，或 n 条描述符
+enum IDAGITransaction {
+    IDAGI_COMMAND = 0,
+    IDAGI_DESCRIPTORS = 1,  // data: uint32_t {SharedMemory 中的偏移, n}
+};
+
 #endif
\ No newline at end of file
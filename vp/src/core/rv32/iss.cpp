@@ -118,8 +118,9 @@ ISS::ISS(uint32_t hart_id, bool use_E_base_isa) : systemc_name("Core-" + std::to
 void ISS::exec_step() {
 	assert(((pc & ~pc_alignment_mask()) == 0) && "misaligned instruction");
 
+	uint32_t mem_word;
 	try {
-		uint32_t mem_word = instr_mem->load_instr(pc);
+		mem_word = instr_mem->load_instr(pc);
 		instr = Instruction(mem_word);
 	} catch (SimulationTrap &e) {
 		op = Opcode::UNDEF;
@@ -127,13 +128,13 @@ void ISS::exec_step() {
 		throw;
 	}
 
-	if (instr.is_compressed()) {
-		op = instr.decode_and_expand_compressed(RV32);
+	bool compressed = instr.is_compressed();
+	op = decode_cache.decode(pc, mem_word, instr, RV32);
+	if (compressed) {
 		pc += 2;
         if (op != Opcode::UNDEF)
             REQUIRE_ISA(C_ISA_EXT);
     } else {
-		op = instr.decode_normal(RV32);
 		pc += 4;
 	}
 
@@ -1299,6 +1300,10 @@ void ISS::set_csr_value(uint32_t addr, uint32_t value) {
 
 	using namespace csr;
 
+	// the MMU caches translations checked against these
+	bool sum = csrs.mstatus.sum;
+	bool mxr = csrs.mstatus.mxr;
+
 	switch (addr) {
 		case MISA_ADDR:                         // currently, read-only, thus cannot be changed at runtime
 		SWITCH_CASE_MATCH_ANY_HPMCOUNTER_RV32:  // not implemented
@@ -1308,6 +1313,7 @@ void ISS::set_csr_value(uint32_t addr, uint32_t value) {
             if (csrs.mstatus.tvm)
                 RAISE_ILLEGAL_INSTRUCTION();
             write(csrs.satp, SATP_MASK);
+            mem->flush_tlb();
             // std::cout << "[iss] satp=" << boost::format("%x") % csrs.satp.reg << std::endl;
         } break;
 
@@ -1418,6 +1424,9 @@ void ISS::set_csr_value(uint32_t addr, uint32_t value) {
 
 			csrs.default_write32(addr, value);
 	}
+
+	if (csrs.mstatus.sum != sum || csrs.mstatus.mxr != mxr)
+		mem->flush_tlb();
 }
 
 void ISS::init(instr_memory_if *instr_mem, data_memory_if *data_mem, clint_if *clint, uint32_t entrypoint,
@@ -1867,4 +1876,5 @@ void ISS::show() {
 	regs.show();
 	std::cout << "pc = " << std::hex << pc << std::endl;
 	std::cout << "num-instr = " << std::dec << csrs.instret.reg << std::endl;
+	std::cout << "decode-cache-hit-rate = " << decode_cache.hit_rate() << std::endl;
 }
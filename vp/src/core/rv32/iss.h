@@ -2,6 +2,7 @@
 
 #include "core/common/bus_lock_if.h"
 #include "core/common/clint_if.h"
+#include "core/common/decode_cache.h"
 #include "core/common/instr.h"
 #include "core/common/irq_if.h"
 #include "core/common/trap.h"
@@ -172,6 +173,7 @@ struct ISS : public external_interrupt_target, public clint_interrupt_target, pu
 	// last decoded and executed instruction and opcode
 	Instruction instr;
 	Opcode::Mapping op;
+	DecodeCache decode_cache;
 
 	CoreExecStatus status = CoreExecStatus::Runnable;
 	std::unordered_set<uint32_t> breakpoints;
@@ -274,14 +276,12 @@ struct ISS : public external_interrupt_target, public clint_interrupt_target, pu
 		trap_check_addr_alignment<4, false>(addr);
 		uint32_t data;
 		try {
-			data = mem->atomic_load_word(addr);
+			data = mem->atomic_amo_word(addr, operation, regs[instr.rs2()]);
 		} catch (SimulationTrap &e) {
 			if (e.reason == EXC_LOAD_ACCESS_FAULT)
 				e.reason = EXC_STORE_AMO_ACCESS_FAULT;
 			throw e;
 		}
-		uint32_t val = operation(data, regs[instr.rs2()]);
-		mem->atomic_store_word(addr, val);
 		regs[instr.rd()] = data;
 	}
 
@@ -81,7 +81,7 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 	inline T _raw_load_data(uint64_t addr) {
 		// NOTE: a DMI load will not context switch (SystemC) and not modify the memory, hence should be able to
 		// postpone the lock after the dmi access
-		bus_lock->wait_for_access_rights(iss.get_hart_id());
+		bus_lock->wait_for_access_rights(iss.get_hart_id(), addr);
 
 		for (auto &e : dmi_ranges) {
 			if (e.contains(addr)) {
@@ -97,7 +97,7 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 
 	template <typename T>
 	inline void _raw_store_data(uint64_t addr, T value) {
-		bus_lock->wait_for_access_rights(iss.get_hart_id());
+		bus_lock->wait_for_access_rights(iss.get_hart_id(), addr);
 
 		bool done = false;
 		for (auto &e : dmi_ranges) {
@@ -114,14 +114,44 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 	}
 
 
+    // Virtual accesses: the MMU gives the host address of the pages its
+    // TLB maps to DMI memory, the others go on with the physical address
     template <typename T>
-    inline T _load_data(uint64_t addr) {
-        return _raw_load_data<T>(v2p(addr, LOAD));
+    inline T _load_data(uint64_t addr, MemoryAccessType type = LOAD) {
+        if (mmu == nullptr)
+            return _raw_load_data<T>(addr);
+
+        uint8_t *host;
+        uint64_t paddr = mmu->translate(addr, type, sizeof(T), host);
+        if (host) {
+            bus_lock->wait_for_access_rights(iss.get_hart_id(), paddr);
+            quantum_keeper.inc(dmi_access_delay);
+
+            T ans;
+            memcpy(&ans, host, sizeof(T));
+            return ans;
+        }
+        return _raw_load_data<T>(paddr);
     }
 
     template <typename T>
     inline void _store_data(uint64_t addr, T value) {
-        _raw_store_data(v2p(addr, STORE), value);
+        if (mmu == nullptr) {
+            _raw_store_data(addr, value);
+            return;
+        }
+
+        uint8_t *host;
+        uint64_t paddr = mmu->translate(addr, STORE, sizeof(T), host);
+        if (host) {
+            bus_lock->wait_for_access_rights(iss.get_hart_id(), paddr);
+            quantum_keeper.inc(dmi_access_delay);
+
+            memcpy(host, &value, sizeof(T));
+            atomic_unlock();
+            return;
+        }
+        _raw_store_data(paddr, value);
     }
 
     uint64_t mmu_load_pte64(uint64_t addr) override {
@@ -134,12 +164,21 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
         _raw_store_data(addr, value);
     }
 
+    uint8_t *mmu_dmi_page(uint64_t page_addr) override {
+        for (auto &r : dmi_ranges) {
+            if (r.contains(page_addr) && r.contains(page_addr + PGMASK))
+                return r.get_mem_ptr_to_global_addr<uint8_t>(page_addr);
+        }
+        return nullptr;
+    }
+
     void flush_tlb() override {
-        mmu->flush_tlb();
+        if (mmu != nullptr)
+            mmu->flush_tlb();
     }
 
     uint32_t load_instr(uint64_t addr) override {
-        return _raw_load_data<uint32_t>(v2p(addr, FETCH));
+        return _load_data<uint32_t>(addr, FETCH);
     }
 
     int64_t load_double(uint64_t addr) override {
@@ -174,16 +213,40 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		_store_data(addr, value);
 	}
 
-	virtual int32_t atomic_load_word(uint64_t addr) override {
-		bus_lock->lock(iss.get_hart_id());
-		return load_word(addr);
-	}
-	virtual void atomic_store_word(uint64_t addr, uint32_t value) override {
-		assert(bus_lock->is_locked(iss.get_hart_id()));
-		store_word(addr, value);
+	// A host atomic operation on DMI memory, the lock of the line is only
+	// taken for the other memory or when an LR of another hart holds it
+	virtual int32_t atomic_amo_word(uint64_t addr, const std::function<int32_t(int32_t, int32_t)> &operation,
+	                                int32_t value) override {
+		uint8_t *host = nullptr;
+		uint64_t paddr = addr;
+		if (mmu != nullptr)
+			paddr = mmu->translate(addr, STORE, sizeof(int32_t), host);
+		for (auto &e : dmi_ranges) {
+			if (host)
+				break;
+			if (e.contains(paddr) && e.contains(paddr + sizeof(int32_t) - 1))
+				host = e.get_mem_ptr_to_global_addr<uint8_t>(paddr);
+		}
+
+		if (host && !bus_lock->is_locked_by_other(iss.get_hart_id(), paddr)) {
+			quantum_keeper.inc(2 * dmi_access_delay);
+
+			int32_t *p = reinterpret_cast<int32_t *>(host);
+			int32_t old = __atomic_load_n(p, __ATOMIC_RELAXED);
+			while (!__atomic_compare_exchange_n(p, &old, operation(old, value), true, __ATOMIC_SEQ_CST,
+			                                    __ATOMIC_RELAXED)) {
+			}
+			atomic_unlock();
+			return old;
+		}
+
+		bus_lock->lock(iss.get_hart_id(), paddr);
+		int32_t old = _raw_load_data<int32_t>(paddr);
+		_raw_store_data(paddr, operation(old, value));
+		return old;
 	}
 	virtual int32_t atomic_load_reserved_word(uint64_t addr) override {
-		bus_lock->lock(iss.get_hart_id());
+		bus_lock->lock(iss.get_hart_id(), v2p(addr, LOAD));
 		lr_addr = addr;
 		return load_word(addr);
 	}
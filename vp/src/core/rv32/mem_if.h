@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 
+#include <functional>
+
 namespace rv32 {
 
 struct instr_memory_if {
@@ -26,8 +28,9 @@ struct data_memory_if {
 	virtual void store_half(uint64_t addr, uint16_t value) = 0;
 	virtual void store_byte(uint64_t addr, uint8_t value) = 0;
 
-	virtual int32_t atomic_load_word(uint64_t addr) = 0;
-	virtual void atomic_store_word(uint64_t addr, uint32_t value) = 0;
+	// AMOs store operation(old, value) and return the old value
+	virtual int32_t atomic_amo_word(uint64_t addr, const std::function<int32_t(int32_t, int32_t)> &operation,
+	                                int32_t value) = 0;
 	virtual int32_t atomic_load_reserved_word(uint64_t addr) = 0;
 	virtual bool atomic_store_conditional_word(uint64_t addr, uint32_t value) = 0;
 	virtual void atomic_unlock() = 0;
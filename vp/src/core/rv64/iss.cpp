@@ -1,4 +1,6 @@
 #include "iss.h"
+#include "core/common/fp_host.h"
+#include "core/common/mmu.h"
 
 // to save *cout* format setting, see *ISS::show*
 #include <boost/format.hpp>
@@ -122,19 +124,21 @@ ISS::ISS(sc_core::sc_module_name name, uint64_t hart_id) : systemc_name(name) {
 	long_instr_cnt = 0; 
  	long_instr_complete = 0; 
 
+	// only started by the release of reset, the cores then run decoupled
+	// from the clock within their quantum
 	SC_METHOD(run_wrapper);
 	sensitive << reset;
-	sensitive << clock.pos();
 
     SC_THREAD(run);
 }
 
-void ISS::exec_step() {
+void ISS::fetch_and_decode() {
 	assert(((pc & ~pc_alignment_mask()) == 0) && "misaligned instruction");
 
 	uint32_t mem_word;
 	try {
 		mem_word = instr_mem->load_instr(pc);
+		last_mem_word = mem_word;
 		instr = Instruction(mem_word);
 	} catch (SimulationTrap &e) {
 		op = Opcode::UNDEF;
@@ -142,13 +146,12 @@ void ISS::exec_step() {
 		throw;
 	}
 
-	if (instr.is_compressed()) {
-		op = instr.decode_and_expand_compressed(RV64);
+	bool compressed = instr.is_compressed();
+	op = decode_cache.decode(pc, mem_word, instr, RV64);
+	if (compressed)
 		pc += 2;
-	} else {
-		op = instr.decode_normal(RV64);
+	else
 		pc += 4;
-	}
 
 	if (trace) {
 		printf("core %2lu: prv %1x: pc %16lx (%8x): %s ", csrs.mhartid.reg, prv, last_pc, mem_word,
@@ -188,7 +191,9 @@ void ISS::exec_step() {
 		}
 		puts("");
 	}
+}
 
+void ISS::exec_step() {
 	switch (op) {
 		case Opcode::UNDEF:
 			if (trace)
@@ -436,13 +441,19 @@ void ISS::exec_step() {
 			regs[instr.rd()] = (int32_t)((int32_t)regs[instr.rs1()] >> regs.shamt_w(instr.rs2()));
 			break;
 
-		case Opcode::FENCE:
-		case Opcode::FENCE_I: {
+		case Opcode::FENCE: {
 			// not using out of order execution/caches so can be ignored
 		} break;
 
+		case Opcode::FENCE_I: {
+			// no instruction cache, but the compiled code checks its words again
+			if (jit)
+				jit->invalidate_code();
+		} break;
+
 		case Opcode::ECALL: {
 			if (sys) {
+				require_kernel();
 				sys->execute_syscall(this);
 			} else {
 				switch (prv) {
@@ -802,35 +813,35 @@ void ISS::exec_step() {
 		case Opcode::FADD_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_add(fp_regs.f32(RS1), fp_regs.f32(RS2)));
+			fp_regs.write(RD, host_f32_add(fp_regs.f32(RS1), fp_regs.f32(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FSUB_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_sub(fp_regs.f32(RS1), fp_regs.f32(RS2)));
+			fp_regs.write(RD, host_f32_sub(fp_regs.f32(RS1), fp_regs.f32(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FMUL_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_mul(fp_regs.f32(RS1), fp_regs.f32(RS2)));
+			fp_regs.write(RD, host_f32_mul(fp_regs.f32(RS1), fp_regs.f32(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FDIV_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_div(fp_regs.f32(RS1), fp_regs.f32(RS2)));
+			fp_regs.write(RD, host_f32_div(fp_regs.f32(RS1), fp_regs.f32(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FSQRT_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_sqrt(fp_regs.f32(RS1)));
+			fp_regs.write(RD, host_f32_sqrt(fp_regs.f32(RS1), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
@@ -873,28 +884,28 @@ void ISS::exec_step() {
 		case Opcode::FMADD_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_mulAdd(fp_regs.f32(RS1), fp_regs.f32(RS2), fp_regs.f32(RS3)));
+			fp_regs.write(RD, host_f32_mulAdd(fp_regs.f32(RS1), fp_regs.f32(RS2), fp_regs.f32(RS3), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FMSUB_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_mulAdd(fp_regs.f32(RS1), fp_regs.f32(RS2), f32_neg(fp_regs.f32(RS3))));
+			fp_regs.write(RD, host_f32_mulAdd(fp_regs.f32(RS1), fp_regs.f32(RS2), f32_neg(fp_regs.f32(RS3)), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FNMADD_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_mulAdd(f32_neg(fp_regs.f32(RS1)), fp_regs.f32(RS2), f32_neg(fp_regs.f32(RS3))));
+			fp_regs.write(RD, host_f32_mulAdd(f32_neg(fp_regs.f32(RS1)), fp_regs.f32(RS2), f32_neg(fp_regs.f32(RS3)), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FNMSUB_S: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f32_mulAdd(f32_neg(fp_regs.f32(RS1)), fp_regs.f32(RS2), fp_regs.f32(RS3)));
+			fp_regs.write(RD, host_f32_mulAdd(f32_neg(fp_regs.f32(RS1)), fp_regs.f32(RS2), fp_regs.f32(RS3), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
@@ -1027,35 +1038,35 @@ void ISS::exec_step() {
 		case Opcode::FADD_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_add(fp_regs.f64(RS1), fp_regs.f64(RS2)));
+			fp_regs.write(RD, host_f64_add(fp_regs.f64(RS1), fp_regs.f64(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FSUB_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_sub(fp_regs.f64(RS1), fp_regs.f64(RS2)));
+			fp_regs.write(RD, host_f64_sub(fp_regs.f64(RS1), fp_regs.f64(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FMUL_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_mul(fp_regs.f64(RS1), fp_regs.f64(RS2)));
+			fp_regs.write(RD, host_f64_mul(fp_regs.f64(RS1), fp_regs.f64(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FDIV_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_div(fp_regs.f64(RS1), fp_regs.f64(RS2)));
+			fp_regs.write(RD, host_f64_div(fp_regs.f64(RS1), fp_regs.f64(RS2), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FSQRT_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_sqrt(fp_regs.f64(RS1)));
+			fp_regs.write(RD, host_f64_sqrt(fp_regs.f64(RS1), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
@@ -1098,28 +1109,28 @@ void ISS::exec_step() {
 		case Opcode::FMADD_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_mulAdd(fp_regs.f64(RS1), fp_regs.f64(RS2), fp_regs.f64(RS3)));
+			fp_regs.write(RD, host_f64_mulAdd(fp_regs.f64(RS1), fp_regs.f64(RS2), fp_regs.f64(RS3), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FMSUB_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_mulAdd(fp_regs.f64(RS1), fp_regs.f64(RS2), f64_neg(fp_regs.f64(RS3))));
+			fp_regs.write(RD, host_f64_mulAdd(fp_regs.f64(RS1), fp_regs.f64(RS2), f64_neg(fp_regs.f64(RS3)), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FNMADD_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_mulAdd(f64_neg(fp_regs.f64(RS1)), fp_regs.f64(RS2), f64_neg(fp_regs.f64(RS3))));
+			fp_regs.write(RD, host_f64_mulAdd(f64_neg(fp_regs.f64(RS1)), fp_regs.f64(RS2), f64_neg(fp_regs.f64(RS3)), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
 		case Opcode::FNMSUB_D: {
 			fp_prepare_instr();
 			fp_setup_rm();
-			fp_regs.write(RD, f64_mulAdd(f64_neg(fp_regs.f64(RS1)), fp_regs.f64(RS2), fp_regs.f64(RS3)));
+			fp_regs.write(RD, host_f64_mulAdd(f64_neg(fp_regs.f64(RS1)), fp_regs.f64(RS2), fp_regs.f64(RS3), csrs.fcsr.fflags));
 			fp_finish_instr();
 		} break;
 
@@ -1256,19 +1267,24 @@ void ISS::exec_step() {
 			uint32_t rd = instr.idagi_rd();
 			uint32_t imm = instr.idagi_imm();
 
-			assert(rd < 54);
+			assert(rd < NR_REG);
 
-			// 0 < rd < 54: set normaly
-			if (rd < 54) {
+			// 0 < rd < NR_REG: set normaly
+			if (rd < NR_REG) {
 				idagi_ext.regs[rd] = imm;
 			}
 
 			// rd == 0: fire/sync
 			if (rd == 0) {
+				require_kernel();
+
 				// imm == 0: fire
 				if (imm == 0) {
 					idagi_ext.regs[0] = 0;
 	
+					// the engines run at the simulation time
+					quantum_keeper.sync();
+
 					long_instr_cnt ++;
 					uint8_t* fileds = idagi_ext.build_fileds();
 					
@@ -1285,9 +1301,30 @@ void ISS::exec_step() {
 						// TODO
 					}
 				}
+				// imm == IDAGI_SUBMIT | n: the n descriptors from desc.addr
+				if ((imm & ~IDAGI_SUBMIT_MAX) == IDAGI_SUBMIT) {
+					idagi_ext.regs[0] = 0;
+
+					uint32_t batch[2] = {IDAGIExtension::linearize(idagi_ext.regs[IDAGI_DESC_ADDR]), imm & IDAGI_SUBMIT_MAX};
+					if (batch[1] > 0) {
+						quantum_keeper.sync();
+
+						long_instr_cnt += batch[1];
+
+						tlm_generic_payload trans;
+						sc_time delay = SC_ZERO_TIME;
+
+						trans.set_command(TLM_WRITE_COMMAND);
+						trans.set_address(IDAGI_DESCRIPTORS);
+						trans.set_data_ptr((uint8_t *)batch);
+						trans.set_data_length(sizeof(batch));
+						isock->b_transport(trans, delay);
+					}
+				}
 				// imm == 0x100: sync
 				if (imm == 0x100) {
 					printf("\033[32m Waiting ...\033[0m\n");
+					quantum_keeper.sync();
 					while (true) {
 						if (long_instr_cnt == long_instr_complete.load()) {
 							break;
@@ -1312,8 +1349,11 @@ void ISS::exec_step() {
 			if (u_mode() && csrs.misa.has_supervisor_mode_extension())
 				raise_trap(EXC_ILLEGAL_INSTR, instr.data());
 
-			if (!ignore_wfi && !has_local_pending_enabled_interrupts())
+			if (!ignore_wfi && !has_local_pending_enabled_interrupts()) {
+				require_kernel();
+				quantum_keeper.sync();
 				sc_core::wait(wfi_event);
+			}
 			break;
 
 		case Opcode::SFENCE_VMA:
@@ -1375,6 +1415,7 @@ uint64_t ISS::get_csr_value(uint64_t addr) {
 	switch (addr) {
 		case TIME_ADDR:
 		case MTIME_ADDR: {
+			require_kernel();
 			uint64_t mtime = clint->update_and_get_mtime();
 			csrs.time.reg = mtime;
 			return csrs.time.reg;
@@ -1438,6 +1479,10 @@ void ISS::set_csr_value(uint64_t addr, uint64_t value) {
 
 	using namespace csr;
 
+	// the MMU caches translations checked against these
+	bool sum = csrs.mstatus.sum;
+	bool mxr = csrs.mstatus.mxr;
+
 	switch (addr) {
 		case MISA_ADDR:                         // currently, read-only, thus cannot be changed at runtime
 		SWITCH_CASE_MATCH_ANY_HPMCOUNTER_RV64:  // not implemented
@@ -1451,6 +1496,7 @@ void ISS::set_csr_value(uint64_t addr, uint64_t value) {
 			if (csrs.satp.mode != SATP_MODE_BARE && csrs.satp.mode != SATP_MODE_SV39 &&
 			    csrs.satp.mode != SATP_MODE_SV48)
 				csrs.satp.mode = mode;
+			mem->flush_tlb();
 			// std::cout << "[iss] satp=" << boost::format("%x") % csrs.satp.reg << std::endl;
 		} break;
 
@@ -1550,6 +1596,9 @@ void ISS::set_csr_value(uint64_t addr, uint64_t value) {
 
 			csrs.default_write64(addr, value);
 	}
+
+	if (csrs.mstatus.sum != sum || csrs.mstatus.mxr != mxr)
+		mem->flush_tlb();
 }
 
 void ISS::init(instr_memory_if *instr_mem, data_memory_if *data_mem, clint_if *clint, uint64_t entrypoint,
@@ -1908,9 +1957,6 @@ void ISS::switch_to_trap_handler(PrivilegeLevel target_mode) {
 }
 
 void ISS::performance_and_sync_update(Opcode::Mapping executed_op) {
-	if (!csrs.mcountinhibit.IR)
-		++csrs.instret.reg;
-
 	if (lr_sc_counter != 0) {
 		--lr_sc_counter;
 		assert (lr_sc_counter >= 0);
@@ -1918,18 +1964,84 @@ void ISS::performance_and_sync_update(Opcode::Mapping executed_op) {
 			release_lr_sc_reservation();
 	}
 
-	auto new_cycles = instr_cycles[executed_op];
+	performance_and_sync_update(1, instr_cycles[executed_op]);
+}
+
+void ISS::performance_and_sync_update(uint64_t num_instr, sc_core::sc_time new_cycles) {
+	performance_update(num_instr, new_cycles);
+	sync_update();
+}
+
+void ISS::performance_update(uint64_t num_instr, sc_core::sc_time new_cycles) {
+	if (!csrs.mcountinhibit.IR)
+		csrs.instret.reg += num_instr;
 
 	if (!csrs.mcountinhibit.CY)
 		cycle_counter += new_cycles;
 
 	quantum_keeper.inc(new_cycles);
-	if (quantum_keeper.need_sync()) {
+}
+
+void ISS::sync_update() {
+	// a host phase stops at the end of the quantum, the core syncs in its SystemC thread
+	if (quantum_keeper.need_sync() && !host_phase) {
 	    if (lr_sc_counter == 0) // match SystemC sync with bus unlocking in a tight LR_W/SC_W loop
 		    quantum_keeper.sync();
 	}
 }
 
+unsigned ISS::run_jit_block(JIT::Block &block) {
+	// check the compiled words on the first run in a code generation, on
+	// each run while the fetches are translated: the block is dropped when
+	// they have changed or cannot be fetched anymore, the interpreter then
+	// takes over (and traps on the fetch if needed)
+	bool translated = csrs.satp.mode != SATP_MODE_BARE && prv != MachineMode;
+	if (block.generation != jit->code_generation() || translated) {
+		if (!check_jit_words(block)) {
+			block.code = nullptr;
+			block.count = 0;
+			return 0;
+		}
+		block.generation = jit->code_generation();
+	}
+
+	// the loads and stores go through the interpreter while they may not
+	// access the memory in place
+	if (block.has_memory && !mem->direct_access())
+		jit->clear_pages();
+
+	unsigned n = block.code(regs.regs, jit->page_table());
+	if (n) {
+		quantum_keeper.inc(block.delays[n]);
+		last_pc = block.pcs[n - 1];
+		pc = block.pcs[n];
+	}
+	return n;
+}
+
+bool ISS::check_jit_words(const JIT::Block &block) {
+	// the run accounts for the fetches
+	sc_core::sc_time local_time = quantum_keeper.get_local_time();
+	uint64_t fetch_pc = pc;
+	bool same = true;
+	try {
+		for (uint32_t word : block.words) {
+			uint32_t mem_word = instr_mem->load_instr(fetch_pc);
+			bool compressed = (word & 3) != 3;
+			if (compressed ? (uint16_t)mem_word != (uint16_t)word : mem_word != word) {
+				same = false;
+				break;
+			}
+			fetch_pc += compressed ? 2 : 4;
+		}
+	} catch (SimulationTrap &) {
+		same = false;
+	}
+	if (quantum_keeper.get_local_time() >= local_time)  // not synchronized meanwhile
+		quantum_keeper.set(local_time);
+	return same;
+}
+
 void ISS::run_step() {
 	assert(regs.read(0) == 0);
 
@@ -1940,9 +2052,104 @@ void ISS::run_step() {
 		return;
 	}
 
+	// Run up to the end of the basic block (see Opcode::endsBasicBlock) or
+	// of the page. Its straight-line instructions are accounted together,
+	// before the last instruction executes or traps, and interrupts are
+	// checked once at the end. The core only syncs once the last one has
+	// executed, pc then holds the next instruction to run. Debugging,
+	// tracing and LR/SC sequences step one instruction at a time.
+	//
+	// Each instruction is still fetched, decoded through the decode cache
+	// and dispatched by the switch of exec_step; there is no handler table
+	// nor predecoded block. Hot blocks run as host code instead (see
+	// jit.h). The rv32 ISS steps one instruction at a time.
+	bool single_step = debug_mode || trace || lr_sc_counter != 0;
+	uint64_t block_instr = 0;
+	sc_core::sc_time block_cycles = sc_core::SC_ZERO_TIME;
+	bool last_accounted = false;
+
+	// With the JIT, the compiled run at the start of a hot block replaces
+	// the interpretation of its instructions; the first THRESHOLD runs
+	// of a block are interpreted and the last of them records its run
+	uint64_t block_pc = pc;
+	bool recording = false;
+
+	// local time at the start of the instruction at last_pc, which has
+	// not happened if it needs the kernel
+	sc_core::sc_time instr_start_time = quantum_keeper.get_local_time();
+
 	last_pc = pc;
+	in_step = true;
 	try {
-		exec_step();
+		if (jit && !single_step) {
+			JIT::Block &block = jit->lookup(pc);
+			if (block.code) {
+				// the interpreter goes on after the instructions that ran
+				unsigned n = run_jit_block(block);
+				if (n) {
+					block_instr += n;
+					block_cycles += block.cycles[n];
+					last_accounted = ((pc ^ last_pc) >> PGSHIFT) != 0;
+				}
+			} else if (block.count == JIT::THRESHOLD) {
+				recording = true;
+				jit_run.clear();
+			}
+		}
+
+		while (!last_accounted) {
+			last_pc = pc;
+			instr_start_time = quantum_keeper.get_local_time();
+			fetch_and_decode();
+			if (single_step || Opcode::endsBasicBlock(op))
+				break;
+
+			// the JIT accesses the page of a load or store in place once
+			// the interpreter has found it can
+			bool memory = jit && JIT::is_memory(op);
+			uint64_t addr = 0;
+			if (memory)
+				addr = regs[instr.rs1()] + (Opcode::getType(op) == Opcode::Type::S ? instr.S_imm() : instr.I_imm());
+
+			exec_step();
+			regs.regs[regs.zero] = 0;
+			++block_instr;
+			block_cycles += instr_cycles[op];
+
+			bool direct = false;
+			if (memory && (recording || !jit->is_mapped(addr))) {
+				if (uint8_t *host = mem->direct_page(addr)) {
+					jit->map_page(addr, host);
+					direct = true;
+				}
+			}
+
+			if (recording) {
+				sc_core::sc_time now = quantum_keeper.get_local_time();
+				if (JIT::is_compilable(op) && (!memory || direct) && now >= instr_start_time) {
+					jit_run.words.push_back(last_mem_word);
+					jit_run.instrs.push_back(instr);
+					jit_run.ops.push_back(op);
+					jit_run.cycles.push_back(instr_cycles[op]);
+					jit_run.delays.push_back(now - instr_start_time);
+				} else {
+					recording = false;
+				}
+			}
+
+			if ((pc ^ last_pc) >> PGSHIFT) {
+				last_accounted = true;
+				break;
+			}
+		}
+
+		if (block_instr) {
+			performance_update(block_instr, block_cycles);
+			instr_start_time += block_cycles;  // the last instruction starts after them
+			block_instr = 0;
+		}
+		if (!last_accounted)
+			exec_step();
 
 		auto x = compute_pending_interrupts();
 		if (x.target_mode != NoneMode) {
@@ -1950,13 +2157,32 @@ void ISS::run_step() {
 			switch_to_trap_handler(x.target_mode);
 		}
 	} catch (SimulationTrap &e) {
+		if (block_instr)
+			performance_update(block_instr, block_cycles);
+
 		if (trace)
 			std::cout << "take trap " << e.reason << ", mtval=" << boost::format("%x") % e.mtval
 			          << ", pc=" << boost::format("%x") % last_pc << std::endl;
 		auto target_mode = prepare_trap(e);
 		switch_to_trap_handler(target_mode);
+	} catch (KernelAccess &) {
+		// the instruction at last_pc runs again in the SystemC thread,
+		// including its fetch and the accesses it has done so far
+		quantum_keeper.set(instr_start_time);
+		if (block_instr)
+			performance_update(block_instr, block_cycles);
+		pc = last_pc;
+		kernel_access = true;
+		last_accounted = true;
 	}
 
+	in_step = false;
+
+	// the recorded instructions have run, whether the block ended with a trap or not
+	if (jit_run.words.size() >= 2)
+		jit->compile(block_pc, jit_run);
+	jit_run.clear();
+
 	// NOTE: writes to zero register are supposedly allowed but must be ignored
 	// (reset it after every instruction, instead of checking *rd != zero*
 	// before every register write)
@@ -1968,28 +2194,69 @@ void ISS::run_step() {
 	if (shall_exit)
 		status = CoreExecStatus::Terminated;
 
-	performance_and_sync_update(op);
+	if (!last_accounted)
+		performance_and_sync_update(op);
+	else
+		sync_update();
+}
+
+void ISS::run_host_phase() {
+	host_phase = true;
+	try {
+		while (status == CoreExecStatus::Runnable && !kernel_access && lr_sc_counter == 0 &&
+		       !quantum_keeper.need_sync())
+			run_step();
+	} catch (...) {
+		host_error = std::current_exception();
+	}
+	host_phase = false;
 }
 
 void ISS::run() {
 	wait(start_event);
 
+	// already terminated in the checkpoint the simulation was restored from
+	if (status != CoreExecStatus::Runnable)
+		return;
+
 	std::cout << name() << " Running" << std::endl;
 
+	// the global quantum is known once the platform is configured
+	quantum_keeper.reset();
+
+	if (use_jit && !jit) {
+		jit.reset(new JIT());
+		if (!jit->is_available()) {
+			std::cout << "[vp::iss] " << name() << ": JIT not supported on this host, interpreting" << std::endl;
+			jit.reset();
+		}
+	}
+
 	// run a single step until either a breakpoint is hit or the execution terminates
 	do {
+		if (host_phases && !kernel_access && lr_sc_counter == 0) {
+			host_phases->run_host_phase(*this);
+			if (host_error)
+				std::rethrow_exception(host_error);
+			if (!kernel_access) {
+				if (quantum_keeper.need_sync())
+					quantum_keeper.sync();
+				continue;
+			}
+		}
+		kernel_access = false;
 		run_step();
 	} while (status == CoreExecStatus::Runnable);
 
     // force sync to make sure that no action is missed
+    quantum_keeper.sync();
     (*nr_done) ++;
 	std::cout << name() << " Done" << std::endl;
-    // quantum_keeper.sync();
 }
 
 void ISS::run_wrapper() {
 	if (!reset.read()) {
-		start_event.notify();
+		start_event.notify(sc_core::SC_ZERO_TIME);
 	}
 }
 
@@ -2000,4 +2267,5 @@ void ISS::show() {
 	regs.show();
 	std::cout << "pc = " << std::hex << pc << std::endl;
 	std::cout << "num-instr = " << std::dec << csrs.instret.reg << std::endl;
+	std::cout << "decode-cache-hit-rate = " << decode_cache.hit_rate() << std::endl;
 }
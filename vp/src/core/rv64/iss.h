@@ -2,12 +2,14 @@
 
 #include "core/common/bus_lock_if.h"
 #include "core/common/clint_if.h"
+#include "core/common/decode_cache.h"
 #include "core/common/core_defs.h"
 #include "core/common/instr.h"
 #include "core/common/irq_if.h"
 #include "core/common/trap.h"
 #include "csr.h"
 #include "fp.h"
+#include "jit.h"
 #include "mem_if.h"
 #include "syscall_if.h"
 #include "util/common.h"
@@ -22,6 +24,7 @@
 
 #include <thread>
 #include <atomic>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -137,6 +140,24 @@ struct timing_if {
 	virtual void update_timing(Instruction instr, Opcode::Mapping op, ISS &iss) = 0;
 };
 
+/*
+ * Parallel execution (optional): the cores run their quanta on host
+ * threads, as long as they only touch their own state, i.e. registers,
+ * TLB and DMI memory out of the sync ranges. An instruction that needs
+ * the SystemC kernel (bus transactions, atomics, syscalls, engines,
+ * WFI, mtime) throws KernelAccess before any side effect and runs again
+ * in the SystemC thread of the core, the quantum then goes on there.
+ */
+struct KernelAccess {};
+
+struct host_phase_if {
+	virtual ~host_phase_if() {}
+
+	// Run the host phase of core (ISS::run_host_phase), returns in its
+	// SystemC thread once done
+	virtual void run_host_phase(ISS &core) = 0;
+};
+
 struct PendingInterrupts {
 	PrivilegeLevel target_mode;
 	uint64_t pending;
@@ -161,6 +182,20 @@ struct ISS : public sc_core::sc_module, public external_interrupt_target, public
 	// last decoded and executed instruction and opcode
 	Instruction instr;
 	Opcode::Mapping op;
+	DecodeCache decode_cache;
+	uint32_t last_mem_word = 0;  // fetched for instr
+
+	// optional JIT tier (see jit.h), set up when the core starts running
+	bool use_jit = false;
+	std::unique_ptr<JIT> jit;
+	JIT::Run jit_run;  // straight-line run recorded for compilation
+
+	// optional parallel execution, see host_phase_if
+	host_phase_if *host_phases = nullptr;
+	bool host_phase = false;     // running on a host thread
+	bool kernel_access = false;  // the host phase stopped at an instruction that needs the kernel
+	bool in_step = false;        // executing a block: a sync now is in the middle of an instruction
+	std::exception_ptr host_error;
 
 	CoreExecStatus status = CoreExecStatus::Runnable;
 	std::unordered_set<uint64_t> breakpoints;
@@ -212,7 +247,15 @@ struct ISS : public sc_core::sc_module, public external_interrupt_target, public
 	void insert_breakpoint(uint64_t) override;
 	void remove_breakpoint(uint64_t) override;
 
-	void exec_step();
+	void fetch_and_decode();
+	void exec_step();  // of the instruction fetched and decoded
+	unsigned run_jit_block(JIT::Block &block);
+	bool check_jit_words(const JIT::Block &block);
+
+	inline void require_kernel() {
+		if (host_phase)
+			throw KernelAccess();
+	}
 
 	uint64_t _compute_and_get_current_cycles();
 
@@ -288,14 +331,12 @@ struct ISS : public sc_core::sc_module, public external_interrupt_target, public
 		trap_check_addr_alignment<4, false>(addr);
 		int32_t data;
 		try {
-			data = mem->atomic_load_word(addr);
+			data = mem->atomic_amo_word(addr, operation, (int32_t)regs[instr.rs2()]);
 		} catch (SimulationTrap &e) {
 			if (e.reason == EXC_LOAD_ACCESS_FAULT)
 				e.reason = EXC_STORE_AMO_ACCESS_FAULT;
 			throw e;
 		}
-		int32_t val = operation(data, (int32_t)regs[instr.rs2()]);
-		mem->atomic_store_word(addr, val);
 		regs[instr.rd()] = data;
 	}
 
@@ -304,14 +345,12 @@ struct ISS : public sc_core::sc_module, public external_interrupt_target, public
 		trap_check_addr_alignment<8, false>(addr);
 		uint64_t data;
 		try {
-			data = mem->atomic_load_double(addr);
+			data = mem->atomic_amo_double(addr, operation, regs[instr.rs2()]);
 		} catch (SimulationTrap &e) {
 			if (e.reason == EXC_LOAD_ACCESS_FAULT)
 				e.reason = EXC_STORE_AMO_ACCESS_FAULT;
 			throw e;
 		}
-		uint64_t val = operation(data, regs[instr.rs2()]);
-		mem->atomic_store_double(addr, val);
 		regs[instr.rd()] = data;
 	}
 
@@ -346,9 +385,16 @@ struct ISS : public sc_core::sc_module, public external_interrupt_target, public
 	void switch_to_trap_handler(PrivilegeLevel target_mode);
 
 	void performance_and_sync_update(Opcode::Mapping executed_op);
+	void performance_and_sync_update(uint64_t num_instr, sc_core::sc_time new_cycles);
+	void performance_update(uint64_t num_instr, sc_core::sc_time new_cycles);  // without syncing
+	void sync_update();
 
 	void run_step() override;
 
+	// Steps up to the end of the quantum or an instruction that needs the
+	// kernel, on a host thread
+	void run_host_phase();
+
 	void run() override;
 
 	void run_wrapper();
@@ -0,0 +1,493 @@
+#include "jit.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <initializer_list>
+#include <utility>
+
+using namespace rv64;
+
+namespace {
+
+#if defined(__x86_64__)
+
+enum : uint8_t { RAX = 0, RCX = 1, RDX = 2 };
+
+enum : uint8_t {
+	ADD_RM_R = 0x01,
+	OR_RM_R = 0x09,
+	AND_RM_R = 0x21,
+	SUB_RM_R = 0x29,
+	XOR_RM_R = 0x31,
+	CMP_RM_R = 0x39,
+
+	ADD_RAX_IMM = 0x05,
+	OR_RAX_IMM = 0x0D,
+	AND_RAX_IMM = 0x25,
+	XOR_RAX_IMM = 0x35,
+	CMP_RAX_IMM = 0x3D,
+
+	SHL = 0xE0,
+	SHR = 0xE8,
+	SAR = 0xF8,
+
+	SETL = 0x9C,
+	SETB = 0x92,
+
+	JNZ = 0x85,
+};
+
+// Emits the host code of a block into the code buffer; the register file
+// is addressed through rdi (first argument), the page table through rsi
+// (second argument), rax, rcx and rdx are scratch
+struct Emitter {
+	uint8_t *p;
+	std::vector<std::pair<uint8_t *, unsigned>> exits;  // rel32 to patch, instruction index
+
+	void byte(uint8_t b) {
+		*p++ = b;
+	}
+
+	void bytes(std::initializer_list<uint8_t> bs) {
+		for (uint8_t b : bs) byte(b);
+	}
+
+	void imm32(int32_t v) {
+		memcpy(p, &v, 4);
+		p += 4;
+	}
+
+	void imm64(int64_t v) {
+		memcpy(p, &v, 8);
+		p += 8;
+	}
+
+	// mov r, [rdi + 8*reg] (x0 reads as zero)
+	void load(unsigned reg, uint8_t r) {
+		if (reg == 0) {
+			bytes({0x31, uint8_t(0xC0 | r << 3 | r)});  // xor r32, r32
+		} else {
+			bytes({0x48, 0x8B, uint8_t(0x87 | r << 3)});
+			imm32(reg * 8);
+		}
+	}
+
+	// mov [rdi + 8*reg], rax
+	void store(unsigned reg) {
+		bytes({0x48, 0x89, 0x87});
+		imm32(reg * 8);
+	}
+
+	// op rax, imm32 (sign extended)
+	void alu_imm(uint8_t opcode, int32_t v) {
+		bytes({0x48, opcode});
+		imm32(v);
+	}
+
+	// setcc al; movzx eax, al
+	void setcc(uint8_t cc) {
+		bytes({0x0F, cc, 0xC0, 0x0F, 0xB6, 0xC0});
+	}
+
+	// movsxd rax, eax
+	void sign_extend_w() {
+		bytes({0x48, 0x63, 0xC0});
+	}
+
+	// jcc to the exit of the instruction at index, patched by the caller
+	void exit_if(uint8_t cc, unsigned index) {
+		bytes({0x0F, cc});
+		exits.emplace_back(p, index);
+		imm32(0);
+	}
+
+	// mov eax, n; ret
+	void ret(unsigned n) {
+		byte(0xB8);
+		imm32(n);
+		byte(0xC3);
+	}
+
+	// rax = host address of the num_bytes at the address in rax, taking
+	// the exit of the instruction at index when they are misaligned or
+	// their page is not in the page table
+	void host_address(unsigned num_bytes, unsigned index) {
+		if (num_bytes > 1) {
+			bytes({0xA8, uint8_t(num_bytes - 1)});  // test al, num_bytes - 1
+			exit_if(JNZ, index);
+		}
+		bytes({0x48, 0x89, 0xC2});                            // mov rdx, rax
+		bytes({0x48, 0xC1, 0xEA, JIT::PAGE_SHIFT});           // shr rdx, PAGE_SHIFT
+		bytes({0x89, 0xD1});                                  // mov ecx, edx
+		bytes({0x83, 0xE1, JIT::PAGES - 1});                  // and ecx, PAGES - 1
+		bytes({0xC1, 0xE1, 4});                               // shl ecx, 4 (sizeof(Page))
+		bytes({0x48, 0x3B, 0x14, 0x0E});                      // cmp rdx, [rsi + rcx] (page)
+		exit_if(JNZ, index);
+		bytes({0x48, 0x03, 0x44, 0x0E, 0x08});                // add rax, [rsi + rcx + 8] (offset)
+	}
+};
+
+static_assert(sizeof(JIT::Page) == 16 && offsetof(JIT::Page, offset) == 8, "the code indexes the page table");
+
+
+// Loads and stores of the instruction at index, in place (see JIT)
+void emit_memory(Emitter &e, Instruction &instr, Opcode::Mapping op, unsigned index) {
+	switch (op) {
+		case Opcode::LB:
+		case Opcode::LH:
+		case Opcode::LW:
+		case Opcode::LD:
+		case Opcode::LBU:
+		case Opcode::LHU:
+		case Opcode::LWU: {
+			unsigned size = op == Opcode::LB || op == Opcode::LBU   ? 1
+			                : op == Opcode::LH || op == Opcode::LHU ? 2
+			                : op == Opcode::LD                      ? 8
+			                                                        : 4;
+			e.load(instr.rs1(), RAX);
+			e.alu_imm(ADD_RAX_IMM, instr.I_imm());
+			e.host_address(size, index);
+			switch (op) {
+				case Opcode::LB:
+					e.bytes({0x48, 0x0F, 0xBE, 0x00});  // movsx rax, byte [rax]
+					break;
+				case Opcode::LBU:
+					e.bytes({0x0F, 0xB6, 0x00});  // movzx eax, byte [rax]
+					break;
+				case Opcode::LH:
+					e.bytes({0x48, 0x0F, 0xBF, 0x00});  // movsx rax, word [rax]
+					break;
+				case Opcode::LHU:
+					e.bytes({0x0F, 0xB7, 0x00});  // movzx eax, word [rax]
+					break;
+				case Opcode::LW:
+					e.bytes({0x48, 0x63, 0x00});  // movsxd rax, dword [rax]
+					break;
+				case Opcode::LWU:
+					e.bytes({0x8B, 0x00});  // mov eax, [rax]
+					break;
+				default:
+					e.bytes({0x48, 0x8B, 0x00});  // mov rax, [rax]
+			}
+			if (instr.rd() != 0)
+				e.store(instr.rd());
+		} break;
+
+		case Opcode::SB:
+		case Opcode::SH:
+		case Opcode::SW:
+		case Opcode::SD: {
+			unsigned size = op == Opcode::SB ? 1 : op == Opcode::SH ? 2 : op == Opcode::SW ? 4 : 8;
+			e.load(instr.rs1(), RAX);
+			e.alu_imm(ADD_RAX_IMM, instr.S_imm());
+			e.host_address(size, index);
+			e.load(instr.rs2(), RDX);
+			switch (op) {
+				case Opcode::SB:
+					e.bytes({0x88, 0x10});  // mov [rax], dl
+					break;
+				case Opcode::SH:
+					e.bytes({0x66, 0x89, 0x10});  // mov [rax], dx
+					break;
+				case Opcode::SW:
+					e.bytes({0x89, 0x10});  // mov [rax], edx
+					break;
+				default:
+					e.bytes({0x48, 0x89, 0x10});  // mov [rax], rdx
+			}
+		} break;
+
+		default:
+			assert(false && "instruction not a load or store");
+	}
+}
+
+void emit(Emitter &e, uint64_t pc, Instruction &instr, Opcode::Mapping op) {
+	unsigned rd = instr.rd();
+	if (rd == 0)
+		return;  // no effect
+
+	switch (op) {
+		case Opcode::LUI:
+			e.bytes({0x48, 0xC7, 0xC0});  // mov rax, simm32
+			e.imm32(instr.U_imm());
+			break;
+
+		case Opcode::AUIPC:
+			e.bytes({0x48, 0xB8});  // mov rax, imm64
+			e.imm64(pc + instr.U_imm());
+			break;
+
+		case Opcode::ADDI:
+		case Opcode::XORI:
+		case Opcode::ORI:
+		case Opcode::ANDI:
+		case Opcode::SLTI:
+		case Opcode::SLTIU: {
+			static const uint8_t opcodes[] = {ADD_RAX_IMM, XOR_RAX_IMM, OR_RAX_IMM, AND_RAX_IMM};
+			e.load(instr.rs1(), RAX);
+			if (op == Opcode::SLTI || op == Opcode::SLTIU) {
+				e.alu_imm(CMP_RAX_IMM, instr.I_imm());
+				e.setcc(op == Opcode::SLTI ? SETL : SETB);
+			} else {
+				unsigned i = op == Opcode::ADDI ? 0 : op == Opcode::XORI ? 1 : op == Opcode::ORI ? 2 : 3;
+				e.alu_imm(opcodes[i], instr.I_imm());
+			}
+		} break;
+
+		case Opcode::SLLI:
+		case Opcode::SRLI:
+		case Opcode::SRAI:
+			e.load(instr.rs1(), RAX);
+			e.bytes({0x48, 0xC1, op == Opcode::SLLI ? SHL : op == Opcode::SRLI ? SHR : SAR, uint8_t(instr.shamt())});
+			break;
+
+		case Opcode::ADD:
+		case Opcode::SUB:
+		case Opcode::XOR:
+		case Opcode::OR:
+		case Opcode::AND:
+			e.load(instr.rs1(), RAX);
+			e.load(instr.rs2(), RCX);
+			e.bytes({0x48,
+			         op == Opcode::ADD   ? ADD_RM_R
+			         : op == Opcode::SUB ? SUB_RM_R
+			         : op == Opcode::XOR ? XOR_RM_R
+			         : op == Opcode::OR  ? OR_RM_R
+			                             : AND_RM_R,
+			         0xC8});
+			break;
+
+		case Opcode::SLT:
+		case Opcode::SLTU:
+			e.load(instr.rs1(), RAX);
+			e.load(instr.rs2(), RCX);
+			e.bytes({0x48, CMP_RM_R, 0xC8});
+			e.setcc(op == Opcode::SLT ? SETL : SETB);
+			break;
+
+		case Opcode::SLL:
+		case Opcode::SRL:
+		case Opcode::SRA:
+			// the host masks the count in cl to 6 bits, as RegFile::shamt
+			e.load(instr.rs1(), RAX);
+			e.load(instr.rs2(), RCX);
+			e.bytes({0x48, 0xD3, op == Opcode::SLL ? SHL : op == Opcode::SRL ? SHR : SAR});
+			break;
+
+		case Opcode::MUL:
+			e.load(instr.rs1(), RAX);
+			e.load(instr.rs2(), RCX);
+			e.bytes({0x48, 0x0F, 0xAF, 0xC1});  // imul rax, rcx
+			break;
+
+		case Opcode::ADDIW:
+			e.load(instr.rs1(), RAX);
+			e.byte(ADD_RAX_IMM);  // add eax, imm32
+			e.imm32(instr.I_imm());
+			e.sign_extend_w();
+			break;
+
+		case Opcode::SLLIW:
+		case Opcode::SRLIW:
+		case Opcode::SRAIW:
+			e.load(instr.rs1(), RAX);
+			e.bytes({0xC1, op == Opcode::SLLIW ? SHL : op == Opcode::SRLIW ? SHR : SAR, uint8_t(instr.shamt_w())});
+			e.sign_extend_w();
+			break;
+
+		case Opcode::ADDW:
+		case Opcode::SUBW:
+			e.load(instr.rs1(), RAX);
+			e.load(instr.rs2(), RCX);
+			e.bytes({op == Opcode::ADDW ? ADD_RM_R : SUB_RM_R, 0xC8});
+			e.sign_extend_w();
+			break;
+
+		case Opcode::SLLW:
+		case Opcode::SRLW:
+		case Opcode::SRAW:
+			// 32 bit shifts mask the count in cl to 5 bits, as RegFile::shamt_w
+			e.load(instr.rs1(), RAX);
+			e.load(instr.rs2(), RCX);
+			e.bytes({0xD3, op == Opcode::SLLW ? SHL : op == Opcode::SRLW ? SHR : SAR});
+			e.sign_extend_w();
+			break;
+
+		default:
+			assert(false && "instruction not compilable");
+	}
+
+	e.store(rd);
+}
+
+#endif
+
+}  // namespace
+
+JIT::JIT() {
+	code = nullptr;
+	code_used = 0;
+
+#if defined(__x86_64__)
+	void *m = mmap(NULL, CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (m != MAP_FAILED) {
+		code = (uint8_t *)m;
+		// the host may not let the memory become executable
+		if (!set_writable(false)) {
+			munmap(code, CODE_SIZE);
+			code = nullptr;
+		}
+	}
+#endif
+}
+
+JIT::~JIT() {
+	if (code != nullptr)
+		munmap(code, CODE_SIZE);
+}
+
+bool JIT::set_writable(bool writable) {
+	return mprotect(code, CODE_SIZE, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) == 0;
+}
+
+bool JIT::is_compilable(Opcode::Mapping op) {
+#if defined(__x86_64__)
+	switch (op) {
+		case Opcode::LUI:
+		case Opcode::AUIPC:
+		case Opcode::ADDI:
+		case Opcode::SLTI:
+		case Opcode::SLTIU:
+		case Opcode::XORI:
+		case Opcode::ORI:
+		case Opcode::ANDI:
+		case Opcode::SLLI:
+		case Opcode::SRLI:
+		case Opcode::SRAI:
+		case Opcode::ADD:
+		case Opcode::SUB:
+		case Opcode::SLL:
+		case Opcode::SLT:
+		case Opcode::SLTU:
+		case Opcode::XOR:
+		case Opcode::SRL:
+		case Opcode::SRA:
+		case Opcode::OR:
+		case Opcode::AND:
+		case Opcode::MUL:
+		case Opcode::ADDIW:
+		case Opcode::SLLIW:
+		case Opcode::SRLIW:
+		case Opcode::SRAIW:
+		case Opcode::ADDW:
+		case Opcode::SUBW:
+		case Opcode::SLLW:
+		case Opcode::SRLW:
+		case Opcode::SRAW:
+			return true;
+
+		default:
+			return is_memory(op);
+	}
+#else
+	(void)op;
+	return false;
+#endif
+}
+
+bool JIT::is_memory(Opcode::Mapping op) {
+	switch (op) {
+		case Opcode::LB:
+		case Opcode::LH:
+		case Opcode::LW:
+		case Opcode::LD:
+		case Opcode::LBU:
+		case Opcode::LHU:
+		case Opcode::LWU:
+		case Opcode::SB:
+		case Opcode::SH:
+		case Opcode::SW:
+		case Opcode::SD:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+JIT::Block *JIT::compile(uint64_t pc, const Run &run) {
+	size_t n = run.words.size();
+	assert(run.instrs.size() == n && run.ops.size() == n && run.cycles.size() == n && run.delays.size() == n);
+
+#if defined(__x86_64__)
+	size_t size = n * MAX_INSTR_CODE_SIZE + 6;
+	if (code == nullptr || size > CODE_SIZE)
+		return nullptr;
+	code_used = (code_used + 15) & ~(size_t)15;
+	if (code_used + size > CODE_SIZE)
+		flush();
+	if (!set_writable(true))
+		return nullptr;
+
+	Block &block = blocks[pc];
+	block = Block();
+	block.words = run.words;
+	block.pcs.push_back(pc);
+	block.cycles.push_back(sc_core::SC_ZERO_TIME);
+	block.delays.push_back(sc_core::SC_ZERO_TIME);
+
+	Emitter e;
+	e.p = code + code_used;
+	for (size_t i = 0; i < n; ++i) {
+		Instruction instr = run.instrs[i];
+		if (is_memory(run.ops[i])) {
+			emit_memory(e, instr, run.ops[i], i);
+			block.has_memory = true;
+		} else {
+			emit(e, block.pcs[i], instr, run.ops[i]);
+		}
+		block.pcs.push_back(block.pcs[i] + ((run.words[i] & 3) == 3 ? 4 : 2));
+		block.cycles.push_back(block.cycles[i] + run.cycles[i]);
+		block.delays.push_back(block.delays[i] + run.delays[i]);
+	}
+	e.ret(n);
+
+	// an exit per load and store, the page table miss and the misaligned
+	// address of an instruction share it
+	uint8_t *exit = nullptr;
+	unsigned exit_index = n;
+	for (auto &x : e.exits) {
+		if (x.second != exit_index) {
+			exit = e.p;
+			exit_index = x.second;
+			e.ret(exit_index);
+		}
+		int32_t rel = exit - (x.first + 4);
+		memcpy(x.first, &rel, 4);
+	}
+
+	assert((size_t)(e.p - (code + code_used)) <= size);
+
+	block.code = (BlockCode)(code + code_used);
+	block.count = THRESHOLD + 1;
+	code_used = e.p - code;
+
+	if (!set_writable(false)) {
+		flush();
+		return nullptr;
+	}
+	return &block;
+#else
+	(void)pc;
+	return nullptr;
+#endif
+}
+
+void JIT::flush() {
+	blocks.clear();
+	code_used = 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include <systemc>
+
+#include "core/common/instr.h"
+
+namespace rv64 {
+
+/*
+ * Optional JIT tier of the ISS, for x86-64 hosts.
+ *
+ * The straight-line run at the start of a hot basic block is compiled to
+ * host code as long as its instructions compute on the integer registers
+ * or load and store them, the code reading and writing the register file.
+ * Loads and stores access the host memory of their page in place when
+ * the page is in the direct mapped page table and the access is aligned;
+ * otherwise the code stops before them and the interpreter goes on from
+ * there, as it does after the compiled run with the CSR, control
+ * transfer, atomic and floating point instructions. Compiled code thus
+ * never traps nor waits.
+ *
+ * The compiled words are checked against the memory on the first run of
+ * a block in each code generation, which FENCE.I ends (the ISA requires
+ * one before modified code runs), and on each run while the fetches are
+ * translated. The fetch and access time of a run is the one recorded
+ * when the interpreter ran it.
+ *
+ * The code buffer is writable while compiling and executable otherwise,
+ * never both.
+ */
+class JIT {
+   public:
+	static constexpr unsigned THRESHOLD = 64;         // runs of a block before its compilation
+	static constexpr size_t CODE_SIZE = 4 << 20;      // host code of all the blocks
+	static constexpr size_t MAX_INSTR_CODE_SIZE = 96;
+	static constexpr unsigned PAGES = 64;             // direct mapped, see Page
+	static constexpr unsigned PAGE_SHIFT = 12;        // PGSHIFT
+
+	// Host memory the compiled loads and stores access in place: the host
+	// address of addr in page is addr + offset
+	struct Page {
+		uint64_t page = -1;
+		uintptr_t offset = 0;
+	};
+
+	// Runs the compiled instructions up to the first load or store it
+	// cannot do in place, returns how many ran
+	typedef unsigned (*BlockCode)(int64_t *regs, const Page *pages);
+
+	// Straight-line run recorded by the interpreter, per instruction
+	struct Run {
+		std::vector<uint32_t> words;
+		std::vector<Instruction> instrs;
+		std::vector<Opcode::Mapping> ops;
+		std::vector<sc_core::sc_time> cycles;  // instruction cycles
+		std::vector<sc_core::sc_time> delays;  // fetch and memory access time
+
+		void clear() {
+			words.clear();
+			instrs.clear();
+			ops.clear();
+			cycles.clear();
+			delays.clear();
+		}
+	};
+
+	struct Block {
+		unsigned count = 0;
+		BlockCode code = nullptr;
+		std::vector<uint32_t> words;  // fetched words of the compiled instructions
+		std::vector<uint64_t> pcs;    // of the compiled instructions and of the next one
+		// of the first i compiled instructions, for runs stopping before i
+		std::vector<sc_core::sc_time> cycles;
+		std::vector<sc_core::sc_time> delays;
+		bool has_memory = false;   // compiles loads or stores
+		uint64_t generation = 0;   // code generation the words were checked in, 0 for none
+	};
+
+	JIT();
+	~JIT();
+
+	// False when the host cannot run generated code
+	bool is_available() const {
+		return code != nullptr;
+	}
+
+	// Block starting at pc, counting its runs up to THRESHOLD
+	Block &lookup(uint64_t pc) {
+		Block &block = blocks[pc];
+		if (block.count <= THRESHOLD)
+			++block.count;
+		return block;
+	}
+
+	static bool is_compilable(Opcode::Mapping op);
+	static bool is_memory(Opcode::Mapping op);
+
+	// Compile the run starting at pc, all of its instructions compilable;
+	// nullptr when out of code memory (all the blocks are then dropped)
+	Block *compile(uint64_t pc, const Run &run);
+
+	void flush();
+
+	uint64_t code_generation() const {
+		return generation;
+	}
+
+	// On FENCE.I: the compiled words are checked again before they run
+	void invalidate_code() {
+		++generation;
+	}
+
+	const Page *page_table() const {
+		return pages;
+	}
+
+	bool is_mapped(uint64_t addr) const {
+		uint64_t page = addr >> PAGE_SHIFT;
+		return pages[page % PAGES].page == page;
+	}
+
+	// Let the compiled code access the page of addr at host
+	void map_page(uint64_t addr, uint8_t *host) {
+		uint64_t page = addr >> PAGE_SHIFT;
+		pages[page % PAGES].page = page;
+		pages[page % PAGES].offset = (uintptr_t)host - (page << PAGE_SHIFT);
+	}
+
+	void clear_pages() {
+		for (Page &p : pages) p = Page();
+	}
+
+   private:
+	uint8_t *code;
+	size_t code_used;
+	uint64_t generation = 1;
+	Page pages[PAGES];
+	std::unordered_map<uint64_t, Block> blocks;
+
+	bool set_writable(bool writable);
+};
+
+}  // namespace rv64
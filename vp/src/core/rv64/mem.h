@@ -40,6 +40,23 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 	sc_core::sc_time dmi_access_delay = clock_cycle * 4;
 	std::vector<MemoryDMI> dmi_ranges;
 
+	// Host pointers of the physical pages last accessed through DMI,
+	// direct mapped. Pages of the sync_ranges are not cached, their
+	// accesses synchronize first. The DMI ranges must not change once
+	// the core runs.
+	struct dmi_page_t {
+		uint64_t page = -1;
+		uint8_t *host = nullptr;
+	};
+	static constexpr unsigned DMI_PAGES = 64;
+	dmi_page_t dmi_pages[DMI_PAGES];
+	unsigned last_dmi_range = 0;  // searched first on a page miss
+
+	// [start, end] ranges of state shared with other initiators: the core
+	// synchronizes with the simulation before accessing them, instead of
+	// running ahead in its quantum
+	std::vector<std::pair<uint64_t, uint64_t>> sync_ranges;
+
 	MMU &mmu;
 
 	CombinedMemoryInterface(sc_core::sc_module_name, ISS &owner, MMU &mmu)
@@ -49,6 +66,61 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		return mmu.translate_virtual_to_physical_addr(vaddr, type);
 	}
 
+	// Host pointer to the num_bytes at addr, nullptr out of the DMI ranges
+	inline uint8_t *dmi_ptr(uint64_t addr, unsigned num_bytes) {
+		uint64_t page = addr >> PGSHIFT;
+		dmi_page_t &p = dmi_pages[page % DMI_PAGES];
+		if (p.page == page && (addr & PGMASK) + num_bytes <= PGSIZE)
+			return p.host + (addr & PGMASK);
+		return dmi_ptr_slow(addr, num_bytes);
+	}
+
+	uint8_t *dmi_ptr_slow(uint64_t addr, unsigned num_bytes) {
+		uint64_t last = addr + num_bytes - 1;
+		unsigned i = last_dmi_range;
+		if (i >= dmi_ranges.size() || !dmi_ranges[i].contains(addr) || !dmi_ranges[i].contains(last)) {
+			for (i = 0; i < dmi_ranges.size(); ++i) {
+				if (dmi_ranges[i].contains(addr) && dmi_ranges[i].contains(last))
+					break;
+			}
+			if (i == dmi_ranges.size())
+				return nullptr;
+			last_dmi_range = i;
+		}
+		MemoryDMI &r = dmi_ranges[i];
+
+		uint64_t page = addr >> PGSHIFT;
+		if (is_sync_addr(addr)) {
+			iss.require_kernel();
+			quantum_keeper.sync();
+		} else if (uint8_t *host = mmu_dmi_page(page << PGSHIFT)) {
+			dmi_page_t &p = dmi_pages[page % DMI_PAGES];
+			p.page = page;
+			p.host = host;
+		}
+		return r.get_mem_ptr_to_global_addr<uint8_t>(addr);
+	}
+
+	// Host address of the physical page at page_addr, nullptr unless it
+	// is all DMI memory out of the sync_ranges
+	uint8_t *mmu_dmi_page(uint64_t page_addr) override {
+		if (is_sync_addr(page_addr) || is_sync_addr(page_addr + PGMASK))
+			return nullptr;
+		for (auto &r : dmi_ranges) {
+			if (r.contains(page_addr) && r.contains(page_addr + PGMASK))
+				return r.get_mem_ptr_to_global_addr<uint8_t>(page_addr);
+		}
+		return nullptr;
+	}
+
+	bool is_sync_addr(uint64_t addr) {
+		for (auto &r : sync_ranges) {
+			if (addr >= r.first && addr <= r.second)
+				return true;
+		}
+		return false;
+	}
+
 	inline void _do_transaction(tlm::tlm_command cmd, uint64_t addr, uint8_t *data, unsigned num_bytes) {
 		tlm::tlm_generic_payload trans;
 		trans.set_command(cmd);
@@ -57,6 +129,10 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		trans.set_data_length(num_bytes);
 		trans.set_response_status(tlm::TLM_OK_RESPONSE);
 
+		iss.require_kernel();
+		if (is_sync_addr(addr))
+			quantum_keeper.sync();
+
 		sc_core::sc_time local_delay = quantum_keeper.get_local_time();
 
 		isock->b_transport(trans, local_delay);
@@ -76,19 +152,26 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		}
 	}
 
+	// Waits while another hart locks the line of the physical addr
+	inline void wait_for_access_rights(uint64_t addr) {
+		if (bus_lock->is_locked() && bus_lock->is_locked_by_other(iss.get_hart_id(), addr)) {
+			iss.require_kernel();
+			bus_lock->wait_until_unlocked(iss.get_hart_id(), addr);
+		}
+	}
+
 	template <typename T>
 	inline T _raw_load_data(uint64_t addr) {
 		// NOTE: a DMI load will not context switch (SystemC) and not modify the memory, hence should be able to
 		// postpone the lock after the dmi access
-		bus_lock->wait_for_access_rights(iss.get_hart_id());
+		wait_for_access_rights(addr);
 
-		for (auto &e : dmi_ranges) {
-			if (e.contains(addr)) {
-				quantum_keeper.inc(dmi_access_delay);
+		uint8_t *p = dmi_ptr(addr, sizeof(T));
+		if (p) {
+			quantum_keeper.inc(dmi_access_delay);
 
-				T ans = *(e.get_mem_ptr_to_global_addr<T>(addr));
-				return ans;
-			}
+			T ans = *reinterpret_cast<T *>(p);
+			return ans;
 		}
 
 		T ans;
@@ -98,31 +181,48 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 
 	template <typename T>
 	inline void _raw_store_data(uint64_t addr, T value) {
-		bus_lock->wait_for_access_rights(iss.get_hart_id());
+		wait_for_access_rights(addr);
 
-		bool done = false;
-		for (auto &e : dmi_ranges) {
-			if (e.contains(addr)) {
-				quantum_keeper.inc(dmi_access_delay);
+		uint8_t *p = dmi_ptr(addr, sizeof(T));
+		if (p) {
+			quantum_keeper.inc(dmi_access_delay);
 
-				*(e.get_mem_ptr_to_global_addr<T>(addr)) = value;
-				done = true;
-			}
-		}
-
-		if (!done)
+			*reinterpret_cast<T *>(p) = value;
+		} else {
 			_do_transaction(tlm::TLM_WRITE_COMMAND, addr, (uint8_t *)&value, sizeof(T));
+		}
 		atomic_unlock();
 	}
 
+	// Virtual accesses: the MMU gives the host address of the pages its
+	// TLB maps to DMI memory, the others go on with the physical address
 	template <typename T>
-	inline T _load_data(uint64_t addr) {
-		return _raw_load_data<T>(v2p(addr, LOAD));
+	inline T _load_data(uint64_t addr, MemoryAccessType type = LOAD) {
+		uint8_t *host;
+		uint64_t paddr = mmu.translate(addr, type, sizeof(T), host);
+		if (host) {
+			wait_for_access_rights(paddr);
+			quantum_keeper.inc(dmi_access_delay);
+
+			T ans = *reinterpret_cast<T *>(host);
+			return ans;
+		}
+		return _raw_load_data<T>(paddr);
 	}
 
 	template <typename T>
 	inline void _store_data(uint64_t addr, T value) {
-		_raw_store_data(v2p(addr, STORE), value);
+		uint8_t *host;
+		uint64_t paddr = mmu.translate(addr, STORE, sizeof(T), host);
+		if (host) {
+			wait_for_access_rights(paddr);
+			quantum_keeper.inc(dmi_access_delay);
+
+			*reinterpret_cast<T *>(host) = value;
+			atomic_unlock();
+			return;
+		}
+		_raw_store_data(paddr, value);
 	}
 
 	uint64_t mmu_load_pte64(uint64_t addr) override {
@@ -139,23 +239,51 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		mmu.flush_tlb();
 	}
 
-	uint32_t load_instr(uint64_t addr) override {
-		return _raw_load_data<uint32_t>(v2p(addr, FETCH));
+	bool direct_access() override {
+		return !bus_lock->is_locked() && !mmu.translates(LOAD) && !mmu.translates(STORE);
 	}
 
-	template <typename T>
-	T _atomic_load_data(uint64_t addr) {
-		bus_lock->lock(iss.get_hart_id());
-		return _load_data<T>(addr);
+	uint8_t *direct_page(uint64_t addr) override {
+		if (!direct_access())
+			return nullptr;
+		return mmu_dmi_page(addr & ~(uint64_t)PGMASK);
 	}
+
+	uint32_t load_instr(uint64_t addr) override {
+		return _load_data<uint32_t>(addr, FETCH);
+	}
+
+	// A host atomic operation on DMI memory, the lock of the line is only
+	// taken for the other memory or when an LR of another hart holds it
 	template <typename T>
-	void _atomic_store_data(uint64_t addr, T value) {
-		assert(bus_lock->is_locked(iss.get_hart_id()));
-		_store_data(addr, value);
+	T _atomic_amo_data(uint64_t addr, const std::function<T(T, T)> &operation, T value) {
+		uint8_t *host;
+		uint64_t paddr = mmu.translate(addr, STORE, sizeof(T), host);
+		if (!host)
+			host = dmi_ptr(paddr, sizeof(T));
+
+		if (host && !bus_lock->is_locked_by_other(iss.get_hart_id(), paddr)) {
+			quantum_keeper.inc(2 * dmi_access_delay);
+
+			T *p = reinterpret_cast<T *>(host);
+			T old = __atomic_load_n(p, __ATOMIC_RELAXED);
+			while (!__atomic_compare_exchange_n(p, &old, operation(old, value), true, __ATOMIC_SEQ_CST,
+			                                    __ATOMIC_RELAXED)) {
+			}
+			atomic_unlock();
+			return old;
+		}
+
+		iss.require_kernel();
+		bus_lock->lock(iss.get_hart_id(), paddr);
+		T old = _raw_load_data<T>(paddr);
+		_raw_store_data(paddr, operation(old, value));
+		return old;
 	}
 	template <typename T>
 	T _atomic_load_reserved_data(uint64_t addr) {
-		bus_lock->lock(iss.get_hart_id());
+		iss.require_kernel();
+		bus_lock->lock(iss.get_hart_id(), v2p(addr, LOAD));
 		lr_addr = addr;
 		return _load_data<T>(addr);
 	}
@@ -164,6 +292,7 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		/* According to the RISC-V ISA, an implementation can fail each LR/SC sequence that does not satisfy the forward
 		 * progress semantic.
 		 * The lock is established by the LR instruction and the lock is kept while forward progress is maintained. */
+		iss.require_kernel();
 		if (bus_lock->is_locked(iss.get_hart_id())) {
 			if (addr == lr_addr) {
 				_store_data(addr, value);
@@ -209,11 +338,9 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		_store_data(addr, value);
 	}
 
-	int64_t atomic_load_word(uint64_t addr) override {
-		return _atomic_load_data<int32_t>(addr);
-	}
-	void atomic_store_word(uint64_t addr, uint32_t value) override {
-		_atomic_store_data(addr, value);
+	int64_t atomic_amo_word(uint64_t addr, const std::function<int32_t(int32_t, int32_t)> &operation,
+	                        int32_t value) override {
+		return _atomic_amo_data<int32_t>(addr, operation, value);
 	}
 	int64_t atomic_load_reserved_word(uint64_t addr) override {
 		return _atomic_load_reserved_data<int32_t>(addr);
@@ -222,11 +349,9 @@ struct CombinedMemoryInterface : public sc_core::sc_module,
 		return _atomic_store_conditional_data(addr, value);
 	}
 
-	int64_t atomic_load_double(uint64_t addr) override {
-		return _atomic_load_data<int64_t>(addr);
-	}
-	void atomic_store_double(uint64_t addr, uint64_t value) override {
-		_atomic_store_data(addr, value);
+	int64_t atomic_amo_double(uint64_t addr, const std::function<int64_t(int64_t, int64_t)> &operation,
+	                          int64_t value) override {
+		return _atomic_amo_data<int64_t>(addr, operation, value);
 	}
 	int64_t atomic_load_reserved_double(uint64_t addr) override {
 		return _atomic_load_reserved_data<int64_t>(addr);
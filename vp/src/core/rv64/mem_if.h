@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 
+#include <functional>
+
 namespace rv64 {
 
 struct instr_memory_if {
@@ -26,18 +28,32 @@ struct data_memory_if {
 	virtual void store_half(uint64_t addr, uint16_t value) = 0;
 	virtual void store_byte(uint64_t addr, uint8_t value) = 0;
 
-	virtual int64_t atomic_load_word(uint64_t addr) = 0;
-	virtual void atomic_store_word(uint64_t addr, uint32_t value) = 0;
+	// AMOs store operation(old, value) and return the old value
+	virtual int64_t atomic_amo_word(uint64_t addr, const std::function<int32_t(int32_t, int32_t)> &operation,
+	                                int32_t value) = 0;
 	virtual int64_t atomic_load_reserved_word(uint64_t addr) = 0;
 	virtual bool atomic_store_conditional_word(uint64_t addr, uint32_t value) = 0;
 	virtual void atomic_unlock() = 0;
 
-	virtual int64_t atomic_load_double(uint64_t addr) = 0;
-	virtual void atomic_store_double(uint64_t addr, uint64_t value) = 0;
+	virtual int64_t atomic_amo_double(uint64_t addr, const std::function<int64_t(int64_t, int64_t)> &operation,
+	                                  int64_t value) = 0;
 	virtual int64_t atomic_load_reserved_double(uint64_t addr) = 0;
 	virtual bool atomic_store_conditional_double(uint64_t addr, uint64_t value) = 0;
 
 	virtual void flush_tlb() = 0;
+
+	// Whether the JIT may load and store in place now (see jit.h): the
+	// addresses are not translated and no hart locks a line
+	virtual bool direct_access() {
+		return false;
+	}
+
+	// Host address of the page of addr when the JIT may access it in place
+	// (direct_access() and the page is plain DMI memory), nullptr otherwise
+	virtual uint8_t *direct_page(uint64_t addr) {
+		(void)addr;
+		return nullptr;
+	}
 };
 
 }  // namespace rv64
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains a micro-benchmark of the switch reservation table
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "ReservationTable.h"
+
+using namespace std;
+
+#define PORTS (DIRECTIONS + 2)
+
+/* Runs the table as Router::txProcess does for cycles cycles: every input
+ * queries its reservations, then about half of the cycles reserve or
+ * release a random input/VC/output, then the arbiters advance. Returns
+ * the number of reservations found, so that the queries are not dropped. */
+static long run(ReservationTable & rt, const long cycles, double & ns_per_cycle)
+{
+	mt19937 rng(1);
+	long found = 0;
+	pair<int, int> reservations[PORTS];
+
+	auto start = chrono::steady_clock::now();
+	for (long c = 0; c < cycles; c++) {
+		for (int i = 0; i < PORTS; i++)
+			found += rt.getReservations(i, reservations);
+
+		unsigned int r = rng();
+		TReservation res;
+		res.input = r % PORTS;
+		res.vc = (r >> 8) % MAX_VIRTUAL_CHANNELS;
+		int o = (r >> 16) % PORTS;
+		if (r & (1u << 30)) {
+			if (rt.checkReservation(res, o) == RT_AVAILABLE)
+				rt.reserve(res, o);
+			else if (rt.checkReservation(res, o) == RT_ALREADY_SAME)
+				rt.release(res, o);
+		}
+
+		rt.updateIndex();
+	}
+	auto end = chrono::steady_clock::now();
+
+	ns_per_cycle = chrono::duration<double, nano>(end - start).count() / cycles;
+	return found;
+}
+
+int sc_main(int argc, char *argv[])
+{
+	long cycles = argc > 1 ? atol(argv[1]) : 10000000;
+
+	for (const char *arbiter : {ARBITER_ROUND_ROBIN, ARBITER_MATRIX}) {
+		GlobalParams::reservation_arbiter = arbiter;
+		ReservationTable rt;
+		rt.setSize(PORTS);
+
+		double ns;
+		long found = run(rt, cycles, ns);
+		cout << arbiter << ": " << ns << " ns per router cycle (" << PORTS << " queries), "
+		     << found << " reservations found in " << cycles << " cycles" << endl;
+	}
+	return 0;
+}
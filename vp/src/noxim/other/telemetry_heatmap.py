@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+#
+# Noxim - the NoC Simulator
+#
+# Renders one heatmap per telemetry window from the files written with
+# -telemetry N (see Telemetry.h for the binary layout).
+#
+# usage: telemetry_heatmap.py FILE DIM_X DIM_Y [-m METRIC] [-o OUTDIR]
+#
+#   FILE    <prefix>.routers.csv or <prefix>.bin
+#   METRIC  any router column (buf_N, routed, link_E, stall_vc0, ...) or
+#           one of the aggregates: buf (total occupancy), link (flits sent
+#           on all ports), stall (stalls on all VCs). Default: buf
+#
+# Images are written to OUTDIR (default: current directory) as
+# <metric>_<cycle>.png; without matplotlib an ASCII map is printed instead.
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+
+def read_csv(path):
+    windows = {}
+    with open(path) as f:
+        reader = csv.DictReader(f)
+        columns = [c for c in reader.fieldnames if c not in ("cycle", "node")]
+        for row in reader:
+            w = windows.setdefault(int(row["cycle"]), {c: {} for c in columns})
+            for c in columns:
+                w[c][int(row["node"])] = int(row[c])
+    n_routers = max(len(v) for w in windows.values() for v in w.values())
+    return [(cycle, {c: [w[c][n] for n in range(n_routers)] for c in w})
+            for cycle, w in sorted(windows.items())]
+
+
+def read_bin(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"NXTM":
+        sys.exit("error: %s is not a telemetry file" % path)
+    _, _, n_routers, n_rcols, n_hbm, n_hcols = struct.unpack_from("<6I", data, 4)
+    pos = 28
+    names = []
+    for _ in range(n_rcols + n_hcols):
+        end = data.index(b"\0", pos)
+        names.append(data[pos:end].decode())
+        pos = end + 1
+    router_columns = names[:n_rcols]
+
+    windows = []
+    size = 8 + 4 * (n_rcols * n_routers + n_hcols * n_hbm)
+    while pos + size <= len(data):
+        (cycle,) = struct.unpack_from("<Q", data, pos)
+        values = struct.unpack_from("<%dI" % (n_rcols * n_routers), data, pos + 8)
+        windows.append((cycle, {c: list(values[i * n_routers:(i + 1) * n_routers])
+                                for i, c in enumerate(router_columns)}))
+        pos += size
+    return windows
+
+
+def metric_values(columns, metric):
+    if metric in columns:
+        return columns[metric]
+    prefix = {"buf": "buf_", "link": "link_", "stall": "stall_vc"}.get(metric)
+    selected = [v for c, v in columns.items() if prefix and c.startswith(prefix)]
+    if not selected:
+        sys.exit("error: unknown metric %s (available: %s)" % (metric, ", ".join(columns)))
+    return [sum(v) for v in zip(*selected)]
+
+
+def to_grid(values, dim_x, dim_y):
+    return [[values[y * dim_x + x] for x in range(dim_x)] for y in range(dim_y)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Noxim telemetry heatmaps")
+    parser.add_argument("file")
+    parser.add_argument("dim_x", type=int)
+    parser.add_argument("dim_y", type=int)
+    parser.add_argument("-m", "--metric", default="buf")
+    parser.add_argument("-o", "--outdir", default=".")
+    args = parser.parse_args()
+
+    windows = read_bin(args.file) if args.file.endswith(".bin") else read_csv(args.file)
+
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        plt = None
+
+    grids = [(cycle, to_grid(metric_values(cols, args.metric), args.dim_x, args.dim_y))
+             for cycle, cols in windows]
+    vmax = max([max(max(row) for row in g) for _, g in grids] + [1])
+
+    for cycle, grid in grids:
+        if plt is None:
+            print("%s @ cycle %d" % (args.metric, cycle))
+            for row in grid:
+                print(" ".join("%6d" % v for v in row))
+            print()
+            continue
+
+        # same color scale for all the windows, so that they can be compared
+        fig, ax = plt.subplots()
+        image = ax.imshow(grid, cmap="hot", vmin=0, vmax=vmax)
+        ax.set_title("%s @ cycle %d" % (args.metric, cycle))
+        ax.set_xlabel("x")
+        ax.set_ylabel("y")
+        fig.colorbar(image)
+        fig.savefig(os.path.join(args.outdir, "%s_%d.png" % (args.metric, cycle)))
+        plt.close(fig)
+
+
+if __name__ == "__main__":
+    main()
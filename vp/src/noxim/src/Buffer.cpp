@@ -9,6 +9,7 @@
  */
 
 #include "Buffer.h"
+#include "Checkpoint.h"
 #include "Utils.h"
 
 Buffer::Buffer()
@@ -246,3 +247,19 @@ void Buffer::ShowStats(std::ostream & out)
   else
     out << "\t\t";
 }
+
+void Buffer::serialize(Checkpoint & ckpt)
+{
+  ckpt.io(true_buffer);
+  ckpt.io(deadlock_detected);
+  ckpt.io(full_cycles_counter);
+  ckpt.io(last_front_flit_seq);
+  ckpt.io(max_buffer_size);
+  ckpt.io(buffer);
+  ckpt.io(max_occupancy);
+  ckpt.io(hold_time);
+  ckpt.io(last_event);
+  ckpt.io(hold_time_sum);
+  ckpt.io(mean_occupancy);
+  ckpt.io(previous_occupancy);
+}
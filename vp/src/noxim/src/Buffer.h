@@ -16,6 +16,8 @@
 #include "DataStructs.h"
 using namespace std;
 
+class Checkpoint;
+
 class Buffer {
 
   public:
@@ -61,6 +63,8 @@ class Buffer {
     void setLabel(string);
     string getLabel() const;
 
+    void serialize(Checkpoint & ckpt);	// Save or restore flits and statistics
+
   private:
 
     bool true_buffer;
@@ -0,0 +1,419 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the simulation checkpoints
+ */
+
+#include "Checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+static const size_t FLUSH_SIZE = 1 << 20;
+
+// Whether size bytes at data are all zero, eight words at a time. Pages
+// never touched read as the shared zero page and stay unallocated.
+static bool isZero(const uint8_t * data, const size_t size)
+{
+	const size_t BLOCK = 8 * sizeof(uint64_t);
+	size_t i = 0;
+
+	for (; i + BLOCK <= size; i += BLOCK) {
+		uint64_t w[8];
+		memcpy(w, data + i, BLOCK);
+		if (w[0] | w[1] | w[2] | w[3] | w[4] | w[5] | w[6] | w[7])
+			return false;
+	}
+	for (; i < size; i++)
+		if (data[i])
+			return false;
+	return true;
+}
+
+Checkpoint::Checkpoint()
+{
+	saving = false;
+	fd = -1;
+	time_ps = 0.0;
+	page_size = sysconf(_SC_PAGESIZE);
+	offset = 0;
+	map = NULL;
+	map_size = 0;
+	position = 0;
+}
+
+Checkpoint::~Checkpoint()
+{
+	close();
+}
+
+string Checkpoint::configurationKey()
+{
+	ostringstream key;
+
+	key << "mesh=" << GlobalParams::mesh_dim_x << "x" << GlobalParams::mesh_dim_y
+	    << ";vcs=" << GlobalParams::n_virtual_channels << ";buffer_depth=" << GlobalParams::buffer_depth
+	    << ";clock_period_ps=" << GlobalParams::clock_period_ps << ";mem_size=" << GlobalParams::mem_size
+	    << ";hbm_edges=";
+	for (unsigned int i = 0; i < GlobalParams::hbm_edges.size(); i++)
+		key << (i ? "," : "") << GlobalParams::hbm_edges[i];
+	key << ";hbm_ctrl=" << GlobalParams::hbm_ctrl_packets << "/" << GlobalParams::hbm_ctrl_requests
+	    << ";hbm_banks=" << GlobalParams::hbm_pseudo_channels << "x" << GlobalParams::hbm_bank_groups << "x"
+	    << GlobalParams::hbm_banks_per_group << ";hbm_mapping=" << GlobalParams::hbm_address_mapping << "/"
+	    << GlobalParams::hbm_channel_hash;
+
+	return key.str();
+}
+
+bool Checkpoint::create(const string & _filename, const double _time_ps)
+{
+	close();
+
+	filename = _filename;
+	fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	saving = true;
+	time_ps = _time_ps;
+	offset = 0;
+	pending.clear();
+
+	char magic[8] = CHECKPOINT_MAGIC;
+	uint32_t version = CHECKPOINT_VERSION;
+	string key = configurationKey();
+	bytes(magic, sizeof(magic));
+	io(version);
+	io(time_ps);
+	io(key);
+
+	return true;
+}
+
+bool Checkpoint::open(const string & _filename)
+{
+	close();
+
+	filename = _filename;
+	fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		cerr << "Error: cannot open checkpoint " << filename << endl;
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		cerr << "Error: cannot read checkpoint " << filename << endl;
+		return false;
+	}
+
+	map_size = st.st_size;
+	void *m = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (m == MAP_FAILED) {
+		cerr << "Error: cannot map checkpoint " << filename << endl;
+		return false;
+	}
+	map = (uint8_t *)m;
+	saving = false;
+	position = 0;
+
+	char magic[8];
+	uint32_t version;
+	string key;
+	if (map_size < sizeof(magic) + sizeof(version) + sizeof(time_ps)) {
+		cerr << "Error: " << filename << " is not a checkpoint" << endl;
+		return false;
+	}
+	bytes(magic, sizeof(magic));
+	if (memcmp(magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC))) {
+		cerr << "Error: " << filename << " is not a checkpoint" << endl;
+		return false;
+	}
+	io(version);
+	if (version != CHECKPOINT_VERSION) {
+		cerr << "Error: checkpoint " << filename << " has version " << version << ", expected "
+		     << CHECKPOINT_VERSION << endl;
+		return false;
+	}
+	io(time_ps);
+	io(key);
+	if (key != configurationKey()) {
+		cerr << "Error: checkpoint " << filename << " was taken with a different configuration" << endl
+		     << "  checkpoint:    " << key << endl
+		     << "  configuration: " << configurationKey() << endl;
+		return false;
+	}
+
+	return true;
+}
+
+void Checkpoint::close()
+{
+	if (saving && fd >= 0)
+		flush();
+	if (map != NULL)
+		munmap(map, map_size);
+	if (fd >= 0)
+		::close(fd);
+
+	fd = -1;
+	map = NULL;
+	map_size = 0;
+	saving = false;
+}
+
+void Checkpoint::fail(const string & what)
+{
+	cerr << "Error: checkpoint " << filename << ": " << what << endl;
+	exit(1);
+}
+
+void Checkpoint::flush()
+{
+	size_t done = 0;
+	while (done < pending.size()) {
+		ssize_t n = pwrite(fd, pending.data() + done, pending.size() - done, offset + done);
+		if (n <= 0)
+			fail("write failed");
+		done += n;
+	}
+	offset += pending.size();
+	pending.clear();
+}
+
+void Checkpoint::bytes(void * data, const size_t size)
+{
+	if (saving) {
+		pending.insert(pending.end(), (char *)data, (char *)data + size);
+		if (pending.size() >= FLUSH_SIZE)
+			flush();
+	} else {
+		if (position + size > map_size)
+			fail("truncated file");
+		memcpy(data, map + position, size);
+		position += size;
+	}
+}
+
+void Checkpoint::section(const string & name)
+{
+	string s = name;
+	io(s);
+	if (s != name)
+		fail("found the state of " + s + " instead of " + name);
+}
+
+void Checkpoint::io(string & s)
+{
+	if (saving) {
+		bytes((void *)s.c_str(), s.size() + 1);
+	} else {
+		const uint8_t *end = (const uint8_t *)memchr(map + position, '\0', map_size - position);
+		if (end == NULL)
+			fail("truncated file");
+		s.assign((const char *)map + position, end - (map + position));
+		position += s.size() + 1;
+	}
+}
+
+void Checkpoint::io(Flit & flit)
+{
+	uint32_t payload = flit.payload.data.to_uint();
+
+	io(flit.src_id);
+	io(flit.dst_id);
+	io(flit.vc_id);
+	io(flit.flit_type);
+	io(flit.sequence_no);
+	io(flit.sequence_length);
+	io(payload);
+	io(flit.timestamp);
+	io(flit.hop_no);
+	io(flit.use_low_voltage_path);
+	io(flit.hub_relay_node);
+	io(flit.is_broadcast);
+	io(flit.local_reserved);
+	io(flit.is_reduction);
+	io(flit.cmd);
+	io(flit.addr);
+	io(flit.len);
+	io(flit.data);
+	io(flit.valid_len);
+
+	flit.payload.data = payload;
+}
+
+void Checkpoint::io(mt19937 & rng)
+{
+	ostringstream out;
+	string state;
+
+	if (saving) {
+		out << rng;
+		state = out.str();
+	}
+	io(state);
+	if (!saving) {
+		istringstream in(state);
+		in >> rng;
+	}
+}
+
+void Checkpoint::image(uint8_t * data, const size_t size)
+{
+	uint64_t n_pages = (size + page_size - 1) / page_size;
+	bool aligned = ((uintptr_t)data % page_size) == 0;
+
+	uint64_t image_size = size;
+	vector<uint64_t> runs;  // first page and number of pages of each run
+	uint64_t data_offset = 0;
+	uint64_t n_runs = 0;
+
+	if (saving) {
+		// By content: a page not resident may still hold data (swapped
+		// out, or mapped from the checkpoint restored before)
+		for (uint64_t p = 0; p < n_pages; p++) {
+			if (isZero(data + p * page_size, min((uint64_t)page_size, size - p * page_size)))
+				continue;
+
+			if (!runs.empty() && runs[runs.size() - 2] + runs.back() == p)
+				runs.back()++;
+			else {
+				runs.push_back(p);
+				runs.push_back(1);
+			}
+		}
+		n_runs = runs.size() / 2;
+
+		uint64_t header_end = offset + pending.size() + 3 * sizeof(uint64_t) + runs.size() * sizeof(uint64_t);
+		data_offset = (header_end + page_size - 1) / page_size * page_size;
+	}
+
+	io(image_size);
+	io(n_runs);
+	io(data_offset);
+	if (image_size != size)
+		fail("memory image size mismatch");
+	runs.resize(2 * n_runs);
+	ioElements(runs.data(), runs.size(), true_type());
+
+	if (saving) {
+		flush();
+		uint64_t file_offset = data_offset;
+		for (uint64_t r = 0; r < n_runs; r++) {
+			uint64_t start = runs[2 * r] * page_size;
+			uint64_t length = min(runs[2 * r + 1] * page_size, size - start);
+			for (uint64_t done = 0; done < length;) {
+				ssize_t n = pwrite(fd, data + start + done, length - done, file_offset + done);
+				if (n <= 0)
+					fail("write failed");
+				done += n;
+			}
+			file_offset += runs[2 * r + 1] * page_size;
+		}
+		offset = file_offset;
+		return;
+	}
+
+	// Restoring: pages out of the runs are zero
+	uint64_t file_offset = data_offset;
+	uint64_t next_page = 0;
+	for (uint64_t r = 0; r <= n_runs; r++) {
+		uint64_t first = r < n_runs ? runs[2 * r] : n_pages;
+		uint64_t pages = r < n_runs ? runs[2 * r + 1] : 0;
+
+		if (next_page < first)
+			clear(data, next_page * page_size, min(first * page_size, (uint64_t)size), aligned);
+
+		if (r == n_runs)
+			break;
+
+		uint64_t start = first * page_size;
+		uint64_t length = min(pages * page_size, size - start);
+		if (file_offset + length > map_size)
+			fail("truncated file");
+
+		bool mapped = false;
+		if (aligned && length == pages * page_size)
+			mapped = mmap(data + start, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd,
+			              file_offset) != MAP_FAILED;
+		if (!mapped)
+			memcpy(data + start, map + file_offset, length);
+
+		file_offset += pages * page_size;
+		next_page = first + pages;
+	}
+	position = file_offset;
+}
+
+void Checkpoint::clear(uint8_t * data, const size_t start, const size_t end, const bool aligned)
+{
+	// The whole pages of an aligned image get fresh zero pages, which
+	// also gives back the memory they held
+	size_t whole = aligned ? (end - start) / page_size * page_size : 0;
+	if (whole && mmap(data + start, whole, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE,
+	                  -1, 0) == MAP_FAILED)
+		whole = 0;
+
+	for (size_t p = start + whole; p < end; p += page_size) {
+		size_t n = min(page_size, end - p);
+		if (!isZero(data + p, n))
+			memset(data + p, 0, n);
+	}
+}
+
+template <class T> bool Checkpoint::signal(sc_object * object)
+{
+	sc_signal<T> *s = dynamic_cast<sc_signal<T> *>(object);
+	if (s == NULL)
+		return false;
+
+	T value = s->read();
+	io(value);
+	if (!saving)
+		s->write(value);
+	return true;
+}
+
+void Checkpoint::collectSignals(sc_object * object, vector<sc_object *> & found)
+{
+	if (dynamic_cast<sc_clock *>(object) == NULL &&
+	    (dynamic_cast<sc_signal<bool> *>(object) || dynamic_cast<sc_signal<int> *>(object) ||
+	     dynamic_cast<sc_signal<Flit> *>(object) || dynamic_cast<sc_signal<TBufferFullStatus> *>(object) ||
+	     dynamic_cast<sc_signal<NoP_data> *>(object)))
+		found.push_back(object);
+
+	const vector<sc_object *> & children = object->get_child_objects();
+	for (unsigned int i = 0; i < children.size(); i++)
+		collectSignals(children[i], found);
+}
+
+void Checkpoint::signals(sc_object * top)
+{
+	vector<sc_object *> found;
+	collectSignals(top, found);
+
+	uint64_t n = found.size();
+	io(n);
+	if (n != found.size())
+		fail("signal count mismatch");
+
+	// Restored values reach the signals at the next update phase
+	for (unsigned int i = 0; i < found.size(); i++) {
+		section(found[i]->name());
+		if (!signal<bool>(found[i]) && !signal<int>(found[i]) && !signal<Flit>(found[i]))
+			if (!signal<TBufferFullStatus>(found[i]))
+				signal<NoP_data>(found[i]);
+	}
+}
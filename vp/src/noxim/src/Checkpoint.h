@@ -0,0 +1,159 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the simulation checkpoints
+ */
+
+#ifndef __NOXIMCHECKPOINT_H__
+#define __NOXIMCHECKPOINT_H__
+
+#include <systemc.h>
+
+#include <cstdint>
+#include <deque>
+#include <queue>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "DataStructs.h"
+
+using namespace std;
+
+#define CHECKPOINT_MAGIC "NXCKPT"
+#define CHECKPOINT_VERSION 2
+
+/* A checkpoint file is laid out as follows (host byte order):
+ *
+ *   header:   "NXCKPT\0\0", u32 version, double time_ps, NUL terminated
+ *             configuration key (the parameters the layout depends on)
+ *   sections: NUL terminated name, then the state of a component as
+ *             written by its serialize() method
+ *
+ * The same serialize() method saves and restores a component, reading
+ * or writing each member through io(). Memory images are stored as u64
+ * size, u64 n_runs, u64 data_offset and n_runs (u64 first_page, u64
+ * pages), the pages of the runs following each other from the page
+ * aligned data_offset; zero pages are left out. The file is mapped when
+ * restoring and the runs of page aligned images (the HBM channels) are
+ * mapped copy on write in place of the memory, so that large images are
+ * neither read nor copied up front and forked simulations share them.
+ */
+class Checkpoint {
+ public:
+	Checkpoint();
+	~Checkpoint();
+
+	// Start a checkpoint of the simulation at time_ps, false on failure
+	bool create(const string & filename, const double time_ps);
+
+	// Map a checkpoint for restoring, false if it cannot be used
+	bool open(const string & filename);
+
+	// Write the pending data (saving) or drop the file mapping (restoring)
+	void close();
+
+	bool isSaving() const { return saving; }
+	double getTime() const { return time_ps; }
+
+	// Components start their state with a section, restoring checks
+	// that the names match
+	void section(const string & name);
+
+	void bytes(void * data, const size_t size);
+
+	template <class T> void io(T & value)
+	{
+		static_assert(is_trivially_copyable<T>::value, "serialize the members of this type");
+		bytes(&value, sizeof(T));
+	}
+
+	template <class T, size_t N> void io(T (& values)[N])
+	{
+		for (size_t i = 0; i < N; i++)
+			io(values[i]);
+	}
+
+	template <class T> void io(vector<T> & values)
+	{
+		uint64_t n = values.size();
+		io(n);
+		values.resize(n);
+		ioElements(values.data(), n, is_trivially_copyable<T>());
+	}
+
+	template <class T> void io(deque<T> & values)
+	{
+		uint64_t n = values.size();
+		io(n);
+		values.resize(n);
+		for (uint64_t i = 0; i < n; i++)
+			io(values[i]);
+	}
+
+	template <class T> void io(queue<T> & values)
+	{
+		deque<T> d;
+		if (saving)
+			for (queue<T> q = values; !q.empty(); q.pop())
+				d.push_back(q.front());
+		io(d);
+		if (!saving)
+			values = queue<T>(d);
+	}
+
+	void io(string & s);
+	void io(Flit & flit);
+	void io(mt19937 & rng);
+
+	// Memory image, restored in place
+	void image(uint8_t * data, const size_t size);
+
+	// Current values of the signals of the modules below top
+	void signals(sc_object * top);
+
+ private:
+	bool saving;
+	int fd;
+	string filename;
+	double time_ps;
+	size_t page_size;
+
+	// Saving: data not written yet, file offset where it goes
+	vector<char> pending;
+	uint64_t offset;
+
+	// Restoring: mapping of the whole file and read position
+	uint8_t * map;
+	uint64_t map_size;
+	uint64_t position;
+
+	template <class T> void ioElements(T * values, const uint64_t n, true_type)
+	{
+		bytes(values, n * sizeof(T));
+	}
+
+	template <class T> void ioElements(T * values, const uint64_t n, false_type)
+	{
+		for (uint64_t i = 0; i < n; i++)
+			io(values[i]);
+	}
+
+	template <class T> bool signal(sc_object * object);
+	void collectSignals(sc_object * object, vector<sc_object *> & found);
+
+	void flush();
+	void fail(const string & what);
+
+	// Zero the bytes [start, end) of an image
+	void clear(uint8_t * data, const size_t start, const size_t end, const bool aligned);
+
+	static string configurationKey();
+};
+
+#endif
@@ -9,9 +9,14 @@
  */
 
 #include "ConfigurationManager.h"
+#include "HBMAddressMap.h"
+#include "PowerModel.h"
+#include "Utils.h"
 
 #include <systemc.h>  //Included for the function time()
+#include <algorithm>
 #include <cstdlib>
+#include <sstream>
 
 YAML::Node config;
 YAML::Node power_config;
@@ -68,9 +73,12 @@ void loadConfiguration() {
 	GlobalParams::use_debug_runner = readParam<bool>(pe_config, "use_debug_runner", false);
 	GlobalParams::debug_port = readParam<unsigned int>(pe_config, "debug_port", 5005);
 	GlobalParams::pe_trace_mode = readParam<bool>(pe_config, "pe_trace_mode", false);
-	GlobalParams::tlm_global_quantum = readParam<unsigned int>(pe_config, "tlm_global_quantum", 10);
+	GlobalParams::tlm_global_quantum = readParam<int>(pe_config, "tlm_global_quantum", 10);
 	GlobalParams::use_instr_dmi = readParam<bool>(pe_config, "use_instr_dmi", false);
 	GlobalParams::use_data_dmi = readParam<bool>(pe_config, "use_data_dmi", false);
+	GlobalParams::use_jit = readParam<bool>(pe_config, "use_jit", false);
+	GlobalParams::iss_threads = readParam<int>(pe_config, "iss_threads", 1);
+	GlobalParams::dma_hbm_test = readParam<int>(pe_config, "dma_hbm_test", NOT_VALID);
 	GlobalParams::mem_size = readParam<addr_t>(pe_config, "mem_size", 1024 * 1024 * 32);
 	GlobalParams::mem_start_addr = readParam<addr_t>(pe_config, "mem_start_addr", 0x00000000);
 	GlobalParams::mem_end_addr = readParam<addr_t>(pe_config, "mem_end_addr", 0x02000000);
@@ -113,6 +121,7 @@ void loadConfiguration() {
 	GlobalParams::routing_algorithm = readParam<string>(config, "routing_algorithm");
 	GlobalParams::routing_table_filename = readParam<string>(config, "routing_table_filename");
 	GlobalParams::selection_strategy = readParam<string>(config, "selection_strategy");
+	GlobalParams::reservation_arbiter = readParam<string>(config, "reservation_arbiter", ARBITER_ROUND_ROBIN);
 	GlobalParams::packet_injection_rate = readParam<double>(config, "packet_injection_rate");
 	GlobalParams::probability_of_retransmission = readParam<double>(config, "probability_of_retransmission");
 	GlobalParams::traffic_distribution = readParam<string>(config, "traffic_distribution");
@@ -123,6 +132,35 @@ void loadConfiguration() {
 	GlobalParams::reset_time = readParam<int>(config, "reset_time");
 	GlobalParams::stats_warm_up_time = readParam<int>(config, "stats_warm_up_time");
 	GlobalParams::rnd_generator_seed = time(NULL);
+	GlobalParams::noc_threads = readParam<int>(config, "noc_threads", 1);
+	GlobalParams::telemetry_period = readParam<int>(config, "telemetry_period", 0);
+	GlobalParams::telemetry_filename = readParam<string>(config, "telemetry_filename", "telemetry");
+	GlobalParams::telemetry_format = readParam<string>(config, "telemetry_format", TELEMETRY_CSV);
+	GlobalParams::checkpoint_filename = readParam<string>(config, "checkpoint_filename", "");
+	GlobalParams::checkpoint_cycle = readParam<int>(config, "checkpoint_cycle", 0);
+	GlobalParams::restore_filename = readParam<string>(config, "restore_filename", "");
+	GlobalParams::sweep_param = readParam<string>(config, "sweep_param", "");
+	GlobalParams::sweep_values = readParam<vector<string> >(config, "sweep_values", vector<string>());
+	GlobalParams::sweep_jobs = readParam<int>(config, "sweep_jobs", 0);
+	GlobalParams::hbm_pseudo_channels = readParam<int>(config, "hbm_pseudo_channels", 2);
+	GlobalParams::hbm_bank_groups = readParam<int>(config, "hbm_bank_groups", 4);
+	GlobalParams::hbm_banks_per_group = readParam<int>(config, "hbm_banks_per_group", 4);
+	GlobalParams::hbm_row_size = readParam<int>(config, "hbm_row_size", 1024);
+	GlobalParams::hbm_burst_size = readParam<int>(config, "hbm_burst_size", 32);
+	GlobalParams::hbm_queue_depth = readParam<int>(config, "hbm_queue_depth", 32);
+	GlobalParams::hbm_tRCD = readParam<double>(config, "hbm_tRCD", 14.0);
+	GlobalParams::hbm_tRP = readParam<double>(config, "hbm_tRP", 14.0);
+	GlobalParams::hbm_tCL = readParam<double>(config, "hbm_tCL", 14.0);
+	GlobalParams::hbm_tBURST = readParam<double>(config, "hbm_tBURST", 2.0);
+	GlobalParams::hbm_tREFI = readParam<double>(config, "hbm_tREFI", 3900.0);
+	GlobalParams::hbm_tRFC = readParam<double>(config, "hbm_tRFC", 350.0);
+	GlobalParams::hbm_ctrl_packets = readParam<int>(config, "hbm_ctrl_packets", 8);
+	GlobalParams::hbm_ctrl_requests = readParam<int>(config, "hbm_ctrl_requests", 16);
+	GlobalParams::hbm_ctrl_burst = readParam<int>(config, "hbm_ctrl_burst", 64);
+	GlobalParams::hbm_edges = readParam<vector<string> >(config, "hbm_edges", vector<string>(1, "WEST"));
+	GlobalParams::hbm_ctrl_mapping = readParam<string>(config, "hbm_ctrl_mapping", HBM_CTRL_NEAREST);
+	GlobalParams::hbm_address_mapping = readParam<string>(config, "hbm_address_mapping", "RO_BA_CO_CH");
+	GlobalParams::hbm_channel_hash = readParam<string>(config, "hbm_channel_hash", HBM_HASH_XOR_FOLD);
 	GlobalParams::detailed = readParam<bool>(config, "detailed");
 	GlobalParams::dyad_threshold = readParam<double>(config, "dyad_threshold");
 	GlobalParams::max_volume_to_be_drained = readParam<unsigned int>(config, "max_volume_to_be_drained");
@@ -170,6 +208,7 @@ void loadConfiguration() {
 	}
 
 	GlobalParams::power_configuration = power_config["Energy"].as<PowerConfig>();
+	PowerModel::compile(GlobalParams::power_configuration);
 }
 
 void setBufferToTile(int depth) {
@@ -244,6 +283,9 @@ void showHelp(char selfname[]) {
 	     << "\t\tRANDOM\t\tRandom selection strategy" << endl
 	     << "\t\tBUFFER_LEVEL\tBuffer-Level Based selection strategy" << endl
 	     << "\t\tNOP\t\tNeighbors-on-Path selection strategy" << endl
+	     << "\t-arbiter TYPE\t\tSet the arbitration among the VCs reserved on an output port:" << endl
+	     << "\t\tROUND_ROBIN\tRound-robin arbiter (default)" << endl
+	     << "\t\tMATRIX\t\tLeast recently granted (matrix) arbiter" << endl
 	     << "\t-pir R TYPE\t\tSet the packet injection rate R [0..1] and the time distribution TYPE where TYPE is one "
 	        "of the following:"
 	     << endl
@@ -268,6 +310,17 @@ void showHelp(char selfname[]) {
 	     << "\t-hs ID P\t\tAdd node ID to hotspot nodes, with percentage P (0..1) (Only for 'random' traffic)" << endl
 	     << "\t-warmup N\t\tStart to collect statistics after N cycles" << endl
 	     << "\t-seed N\t\t\tSet the seed of the random generator (default time())" << endl
+	     << "\t-noc_threads N\t\tEvaluate the mesh routers on N host threads (default 1)" << endl
+	     << "\t-telemetry N\t\tSample the NoC activity every N cycles (default 0, disabled)" << endl
+	     << "\t-telemetry_file NAME\tPrefix of the telemetry files (default telemetry)" << endl
+	     << "\t-telemetry_format F\tWrite the telemetry as CSV, BINARY or BOTH (default CSV)" << endl
+	     << "\t-checkpoint FILE N\tSave the simulation state to FILE at cycle N, then go on" << endl
+	     << "\t-restore FILE\t\tResume the simulation from the checkpoint FILE" << endl
+	     << "\t-sweep P V1,V2,...\tReset once, then run a copy of the simulation for each value of P:" << endl
+	     << "\t\tbuffer, warmup, hbm_outstanding, hbm_burst, hbm_packets or quantum" << endl
+	     << "\t-sweep_jobs N\t\tRun at most N sweep runs at a time (default 0, one per host cpu)" << endl
+	     << "\t-hbm_outstanding N\tAllow N outstanding HBM requests per HBM controller (default 16)" << endl
+	     << "\t-dma_hbm_test N\t\tLet the DMA of core N write to the HBM and read it back (default -1, none)" << endl
 	     << "\t-detailed\t\tShow detailed statistics" << endl
 	     << "\t-show_buf_stats\t\tShow buffers statistics" << endl
 	     << "\t-volume N\t\tStop the simulation when either the maximum number of cycles has been reached or N flits "
@@ -296,9 +349,12 @@ void showConfig() {
          << "- use_debug_runner = " << GlobalParams::use_debug_runner << endl
          << "- debug_port = " << GlobalParams::debug_port << endl
          << "- pe_trace_mode = " << GlobalParams::pe_trace_mode << endl
-         << "- tlm_global_quantum = " << GlobalParams::tlm_global_quantum << endl
+         << "- tlm_global_quantum = " << GlobalParams::tlm_global_quantum << "ns" << endl
          << "- use_instr_dmi = " << GlobalParams::use_instr_dmi << endl
          << "- use_data_dmi = " << GlobalParams::use_data_dmi << endl
+         << "- use_jit = " << GlobalParams::use_jit << endl
+         << "- iss_threads = " << GlobalParams::iss_threads << endl
+         << "- dma_hbm_test = " << GlobalParams::dma_hbm_test << endl
          << "- mem_size = " << hex << "0x" << GlobalParams::mem_size << endl
          << "- mem_start_addr = " << hex << "0x" << GlobalParams::mem_start_addr << endl
          << "- mem_end_addr = " << hex << "0x" << GlobalParams::mem_end_addr << endl
@@ -321,13 +377,53 @@ void showConfig() {
 	     << endl
 	     // << "- routing_table_filename = " << GlobalParams::routing_table_filename << endl
 	     << "- selection_strategy = " << GlobalParams::selection_strategy << endl
+	     << "- reservation_arbiter = " << GlobalParams::reservation_arbiter << endl
 	     << "- packet_injection_rate = " << GlobalParams::packet_injection_rate << endl
 	     << "- probability_of_retransmission = " << GlobalParams::probability_of_retransmission << endl
 	     << "- traffic_distribution = " << GlobalParams::traffic_distribution << endl
 	     << "- clock_period = " << GlobalParams::clock_period_ps << "ps" << endl
 	     << "- simulation_time = " << GlobalParams::simulation_time << endl
 	     << "- warm_up_time = " << GlobalParams::stats_warm_up_time << endl
-	     << "- rnd_generator_seed = " << GlobalParams::rnd_generator_seed << endl;
+	     << "- rnd_generator_seed = " << GlobalParams::rnd_generator_seed << endl
+	     << "- noc_threads = " << GlobalParams::noc_threads << endl
+	     << "- telemetry_period = " << GlobalParams::telemetry_period << endl
+	     << "- checkpoint = " << (GlobalParams::checkpoint_filename.empty() ? "none" : GlobalParams::checkpoint_filename)
+	     << " (cycle " << GlobalParams::checkpoint_cycle << ")" << endl
+	     << "- restore = " << (GlobalParams::restore_filename.empty() ? "none" : GlobalParams::restore_filename) << endl
+	     << "- sweep = " << (GlobalParams::sweep_values.empty() ? "none" : GlobalParams::sweep_param);
+	for (unsigned int i = 0; i < GlobalParams::sweep_values.size(); i++)
+		cout << (i ? "," : " ") << GlobalParams::sweep_values[i];
+	cout << endl
+	     << "- hbm_banks = " << GlobalParams::hbm_pseudo_channels << "x" << GlobalParams::hbm_bank_groups << "x"
+	     << GlobalParams::hbm_banks_per_group << " (pseudo channels x bank groups x banks)" << endl
+	     << "- hbm_timing = tRCD " << GlobalParams::hbm_tRCD << "ns, tRP " << GlobalParams::hbm_tRP << "ns, tCL "
+	     << GlobalParams::hbm_tCL << "ns, tBURST " << GlobalParams::hbm_tBURST << "ns" << endl
+	     << "- hbm_ctrl_requests = " << GlobalParams::hbm_ctrl_requests << " (bursts of "
+	     << GlobalParams::hbm_ctrl_burst << " bytes, " << GlobalParams::hbm_ctrl_packets << " packets)" << endl
+	     << "- hbm_edges =";
+	for (unsigned int i = 0; i < GlobalParams::hbm_edges.size(); i++) cout << " " << GlobalParams::hbm_edges[i];
+	cout << endl
+	     << "- hbm_ctrl_mapping = " << GlobalParams::hbm_ctrl_mapping << endl
+	     << "- hbm_address_mapping = " << GlobalParams::hbm_address_mapping << " (" << GlobalParams::hbm_channel_hash
+	     << ")" << endl;
+}
+
+// Parameters a sweep can vary: they are only used once reset is over,
+// see NoC::reconfigure()
+int *sweepTarget(const string & param) {
+	if (param == "buffer")
+		return &GlobalParams::buffer_depth;
+	if (param == "warmup")
+		return &GlobalParams::stats_warm_up_time;
+	if (param == "hbm_outstanding")
+		return &GlobalParams::hbm_ctrl_requests;
+	if (param == "hbm_burst")
+		return &GlobalParams::hbm_ctrl_burst;
+	if (param == "hbm_packets")
+		return &GlobalParams::hbm_ctrl_packets;
+	if (param == "quantum")
+		return &GlobalParams::tlm_global_quantum;
+	return NULL;
 }
 
 void checkConfiguration() {
@@ -467,6 +563,154 @@ void checkConfiguration() {
 		exit(1);
 	}
 
+	if (GlobalParams::reservation_arbiter != ARBITER_ROUND_ROBIN && GlobalParams::reservation_arbiter != ARBITER_MATRIX) {
+		cerr << "Error: reservation_arbiter must be " << ARBITER_ROUND_ROBIN << " or " << ARBITER_MATRIX << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::telemetry_period < 0) {
+		cerr << "Error: telemetry period must be >= 0" << endl;
+		exit(1);
+	}
+	if (GlobalParams::telemetry_format != TELEMETRY_CSV && GlobalParams::telemetry_format != TELEMETRY_BINARY &&
+	    GlobalParams::telemetry_format != TELEMETRY_BOTH) {
+		cerr << "Error: telemetry format must be " << TELEMETRY_CSV << ", " << TELEMETRY_BINARY << " or "
+		     << TELEMETRY_BOTH << endl;
+		exit(1);
+	}
+
+	if (!GlobalParams::checkpoint_filename.empty() || !GlobalParams::restore_filename.empty()) {
+		if (GlobalParams::topology != TOPOLOGY_MESH || GlobalParams::use_winoc) {
+			cerr << "Error: checkpoints are only supported on a MESH without wireless" << endl;
+			exit(1);
+		}
+		if (!GlobalParams::checkpoint_filename.empty() && GlobalParams::checkpoint_cycle < GlobalParams::reset_time) {
+			cerr << "Error: checkpoint_cycle must not be smaller than reset_time" << endl;
+			exit(1);
+		}
+	}
+
+	if (!GlobalParams::sweep_values.empty()) {
+		if (sweepTarget(GlobalParams::sweep_param) == NULL) {
+			cerr << "Error: cannot sweep " << GlobalParams::sweep_param
+			     << " (buffer, warmup, hbm_outstanding, hbm_burst, hbm_packets or quantum)" << endl;
+			exit(1);
+		}
+		// The runs are forked: no shared output files nor host threads
+		if (GlobalParams::topology != TOPOLOGY_MESH || GlobalParams::use_winoc || GlobalParams::noc_threads > 1 ||
+		    GlobalParams::iss_threads > 1 || GlobalParams::noc_trace_mode || GlobalParams::telemetry_period > 0 ||
+		    !GlobalParams::checkpoint_filename.empty() || !GlobalParams::restore_filename.empty()) {
+			cerr << "Error: sweeps are only supported on a MESH without wireless, noc_threads, iss_threads, "
+			     << "tracing, telemetry and checkpoints" << endl;
+			exit(1);
+		}
+	}
+	if (GlobalParams::tlm_global_quantum < 0) {
+		cerr << "Error: tlm_global_quantum must be >= 0" << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::sweep_jobs < 0) {
+		cerr << "Error: sweep_jobs must be >= 0" << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::hbm_pseudo_channels < 1 || GlobalParams::hbm_bank_groups < 1 ||
+	    GlobalParams::hbm_banks_per_group < 1 || GlobalParams::hbm_row_size < 1 ||
+	    GlobalParams::hbm_burst_size < 1 || GlobalParams::hbm_queue_depth < 1) {
+		cerr << "Error: HBM organization parameters and queue depth must be >= 1" << endl;
+		exit(1);
+	}
+	if (GlobalParams::hbm_tRCD < 0 || GlobalParams::hbm_tRP < 0 || GlobalParams::hbm_tCL < 0 ||
+	    GlobalParams::hbm_tBURST < 0 || GlobalParams::hbm_tREFI < 0 || GlobalParams::hbm_tRFC < 0) {
+		cerr << "Error: HBM timings must be >= 0" << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::hbm_ctrl_packets < 1 || GlobalParams::hbm_ctrl_requests < 1) {
+		cerr << "Error: HBM controllers need at least one packet and one request slot" << endl;
+		exit(1);
+	}
+	// Bursts must not cross the 256 bytes HBM interleave blocks
+	if (GlobalParams::hbm_ctrl_burst < 1 || GlobalParams::hbm_ctrl_burst > 256 ||
+	    (GlobalParams::hbm_ctrl_burst & (GlobalParams::hbm_ctrl_burst - 1))) {
+		cerr << "Error: hbm_ctrl_burst must be a power of two not greater than 256" << endl;
+		exit(1);
+	}
+
+	for (unsigned int i = 0; i < GlobalParams::hbm_edges.size(); i++) {
+		int edge = hbmEdgeId(GlobalParams::hbm_edges[i]);
+		if (edge == NOT_VALID) {
+			cerr << "Error: unknown HBM edge " << GlobalParams::hbm_edges[i] << " (WEST, EAST, NORTH or SOUTH)"
+			     << endl;
+			exit(1);
+		}
+		if (count(GlobalParams::hbm_edges.begin(), GlobalParams::hbm_edges.end(), GlobalParams::hbm_edges[i]) > 1) {
+			cerr << "Error: HBM edge " << GlobalParams::hbm_edges[i] << " listed more than once" << endl;
+			exit(1);
+		}
+		if (GlobalParams::topology == TOPOLOGY_MESH && hbmEdgeLength(edge) > HBM_CHANNELS) {
+			cerr << "Error: an HBM stack serves at most " << HBM_CHANNELS << " controllers, edge "
+			     << GlobalParams::hbm_edges[i] << " has " << hbmEdgeLength(edge) << endl;
+			exit(1);
+		}
+	}
+	if (GlobalParams::hbm_ctrl_mapping != HBM_CTRL_NEAREST && GlobalParams::hbm_ctrl_mapping != HBM_CTRL_CHANNEL) {
+		cerr << "Error: hbm_ctrl_mapping must be " << HBM_CTRL_NEAREST << " or " << HBM_CTRL_CHANNEL << endl;
+		exit(1);
+	}
+	if (GlobalParams::hbm_channel_hash != HBM_HASH_NONE && GlobalParams::hbm_channel_hash != HBM_HASH_XOR_FOLD) {
+		cerr << "Error: hbm_channel_hash must be " << HBM_HASH_NONE << " or " << HBM_HASH_XOR_FOLD << endl;
+		exit(1);
+	}
+	if (!HBMAddressMap::isPowerOfTwo(GlobalParams::hbm_row_size) ||
+	    !HBMAddressMap::isPowerOfTwo(GlobalParams::hbm_pseudo_channels * GlobalParams::hbm_bank_groups *
+	                                 GlobalParams::hbm_banks_per_group)) {
+		cerr << "Error: HBM row size and number of banks must be powers of two" << endl;
+		exit(1);
+	}
+	HBMAddressMap address_map;
+	if (!address_map.configure(GlobalParams::hbm_address_mapping, GlobalParams::hbm_channel_hash, HBM_MEMORY_SIZE,
+	                           HBM_CHANNELS, HBM_INTERLEAVE_SIZE, GlobalParams::hbm_row_size,
+	                           GlobalParams::hbm_pseudo_channels * GlobalParams::hbm_bank_groups *
+	                               GlobalParams::hbm_banks_per_group)) {
+		cerr << "Error: hbm_address_mapping must order the fields RO, BA, CO and CH, as in RO_BA_CO_CH" << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::noc_threads < 1) {
+		cerr << "Error: noc_threads must be >= 1" << endl;
+		exit(1);
+	}
+	if (GlobalParams::noc_threads > 1 && GlobalParams::topology != TOPOLOGY_MESH) {
+		cerr << "Error: parallel NoC evaluation (noc_threads > 1) is only supported in MESH topology" << endl;
+		exit(1);
+	}
+	if (GlobalParams::noc_threads > 1 && GlobalParams::use_winoc) {
+		cerr << "Error: parallel NoC evaluation (noc_threads > 1) cannot be used with -winoc" << endl;
+		exit(1);
+	}
+	if (GlobalParams::noc_threads > 1 && GlobalParams::max_volume_to_be_drained) {
+		cerr << "Error: parallel NoC evaluation (noc_threads > 1) cannot be used with -volume" << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::dma_hbm_test < NOT_VALID ||
+	    GlobalParams::dma_hbm_test >= GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y) {
+		cerr << "Error: dma_hbm_test must be a core id, or -1 for none" << endl;
+		exit(1);
+	}
+
+	if (GlobalParams::iss_threads < 1) {
+		cerr << "Error: iss_threads must be >= 1" << endl;
+		exit(1);
+	}
+	// The host phases of the cores run out of DMI memory and print nothing
+	if (GlobalParams::iss_threads > 1 && (!GlobalParams::use_data_dmi || GlobalParams::pe_trace_mode)) {
+		cerr << "Error: parallel core execution (iss_threads > 1) needs use_data_dmi and no pe_trace_mode" << endl;
+		exit(1);
+	}
+
 	if (GlobalParams::ascii_monitor) {
 #ifdef DEBUG
 		cerr << "-ascii_monitor option need DEBUG flag to be disabled in Makefile " << endl;
@@ -581,6 +825,34 @@ void parseCmdLine(int arg_num, char *arg_vet[]) {
 				GlobalParams::stats_warm_up_time = atoi(arg_vet[++i]);
 			else if (!strcmp(arg_vet[i], "-seed"))
 				GlobalParams::rnd_generator_seed = atoi(arg_vet[++i]);
+			else if (!strcmp(arg_vet[i], "-arbiter"))
+				GlobalParams::reservation_arbiter = arg_vet[++i];
+			else if (!strcmp(arg_vet[i], "-telemetry"))
+				GlobalParams::telemetry_period = atoi(arg_vet[++i]);
+			else if (!strcmp(arg_vet[i], "-telemetry_file"))
+				GlobalParams::telemetry_filename = arg_vet[++i];
+			else if (!strcmp(arg_vet[i], "-telemetry_format"))
+				GlobalParams::telemetry_format = arg_vet[++i];
+			else if (!strcmp(arg_vet[i], "-checkpoint")) {
+				GlobalParams::checkpoint_filename = arg_vet[++i];
+				GlobalParams::checkpoint_cycle = atoi(arg_vet[++i]);
+			} else if (!strcmp(arg_vet[i], "-restore"))
+				GlobalParams::restore_filename = arg_vet[++i];
+			else if (!strcmp(arg_vet[i], "-sweep")) {
+				GlobalParams::sweep_param = arg_vet[++i];
+				GlobalParams::sweep_values.clear();
+				stringstream values(arg_vet[++i]);
+				string value;
+				while (getline(values, value, ','))
+					GlobalParams::sweep_values.push_back(value);
+			} else if (!strcmp(arg_vet[i], "-sweep_jobs"))
+				GlobalParams::sweep_jobs = atoi(arg_vet[++i]);
+			else if (!strcmp(arg_vet[i], "-hbm_outstanding"))
+				GlobalParams::hbm_ctrl_requests = atoi(arg_vet[++i]);
+			else if (!strcmp(arg_vet[i], "-dma_hbm_test"))
+				GlobalParams::dma_hbm_test = atoi(arg_vet[++i]);
+			else if (!strcmp(arg_vet[i], "-noc_threads"))
+				GlobalParams::noc_threads = atoi(arg_vet[++i]);
 			else if (!strcmp(arg_vet[i], "-detailed"))
 				GlobalParams::detailed = true;
 			else if (!strcmp(arg_vet[i], "-show_buf_stats"))
@@ -603,6 +875,11 @@ void parseCmdLine(int arg_num, char *arg_vet[]) {
 	}
 }
 
+void applySweepValue(const string & value) {
+	*sweepTarget(GlobalParams::sweep_param) = atoi(value.c_str());
+	checkConfiguration();
+}
+
 void configure(int arg_num, char *arg_vet[]) {
 	bool config_found = false;
 	bool power_config_found = false;
@@ -24,6 +24,9 @@ using namespace std;
 
 void configure(int arg_num, char *arg_vet[]);
 
+// Set the swept parameter to value and check the configuration again
+void applySweepValue(const string & value);
+
 template <typename T> 
 T readParam(YAML::Node node, string param, T default_value);
 
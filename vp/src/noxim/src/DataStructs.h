@@ -44,7 +44,7 @@ struct Payload {
 // Header between DMACTRL and Router
 struct Header {
     int dst_id; // destination ID
-    int hbm_id; // HBM ID:  0 (Not used), -1 (West HBM), -2 (East HBM)
+    int hbm_id; // HBM ID:  0 (Not used), -1 (West HBM), -2 (East HBM), -3 (North HBM), -4 (South HBM)
 
     tlm::tlm_command cmd;
     uint64_t addr;
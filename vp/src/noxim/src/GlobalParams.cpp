@@ -17,9 +17,12 @@ bool GlobalParams::intercept_syscalls;
 bool GlobalParams::use_debug_runner;
 unsigned int GlobalParams::debug_port;
 bool GlobalParams::pe_trace_mode;
-unsigned int GlobalParams::tlm_global_quantum;
+int GlobalParams::tlm_global_quantum;
 bool GlobalParams::use_instr_dmi;
 bool GlobalParams::use_data_dmi;
+bool GlobalParams::use_jit;
+int GlobalParams::iss_threads;
+int GlobalParams::dma_hbm_test;
 
 addr_t GlobalParams::mem_size;
 addr_t GlobalParams::mem_start_addr;
@@ -55,6 +58,7 @@ int GlobalParams::max_packet_size;
 string GlobalParams::routing_algorithm;
 string GlobalParams::routing_table_filename;
 string GlobalParams::selection_strategy;
+string GlobalParams::reservation_arbiter;
 double GlobalParams::packet_injection_rate;
 double GlobalParams::probability_of_retransmission;
 double GlobalParams::locality;
@@ -68,6 +72,35 @@ int GlobalParams::n_virtual_channels;
 int GlobalParams::reset_time;
 int GlobalParams::stats_warm_up_time;
 int GlobalParams::rnd_generator_seed;
+int GlobalParams::noc_threads;
+int GlobalParams::telemetry_period;
+string GlobalParams::telemetry_filename;
+string GlobalParams::telemetry_format;
+string GlobalParams::checkpoint_filename;
+int GlobalParams::checkpoint_cycle;
+string GlobalParams::restore_filename;
+string GlobalParams::sweep_param;
+vector<string> GlobalParams::sweep_values;
+int GlobalParams::sweep_jobs;
+int GlobalParams::hbm_pseudo_channels;
+int GlobalParams::hbm_bank_groups;
+int GlobalParams::hbm_banks_per_group;
+int GlobalParams::hbm_row_size;
+int GlobalParams::hbm_burst_size;
+int GlobalParams::hbm_queue_depth;
+double GlobalParams::hbm_tRCD;
+double GlobalParams::hbm_tRP;
+double GlobalParams::hbm_tCL;
+double GlobalParams::hbm_tBURST;
+double GlobalParams::hbm_tREFI;
+double GlobalParams::hbm_tRFC;
+int GlobalParams::hbm_ctrl_packets;
+int GlobalParams::hbm_ctrl_requests;
+int GlobalParams::hbm_ctrl_burst;
+vector<string> GlobalParams::hbm_edges;
+string GlobalParams::hbm_ctrl_mapping;
+string GlobalParams::hbm_address_mapping;
+string GlobalParams::hbm_channel_hash;
 bool GlobalParams::detailed;
 double GlobalParams::dyad_threshold;
 unsigned int GlobalParams::max_volume_to_be_drained;
@@ -60,6 +60,37 @@ using namespace std;
 #define ROUTING_TABLE_BASED    "TABLE_BASED"
 
 
+// Arbitration among the VCs reserved on an output port
+#define ARBITER_ROUND_ROBIN    "ROUND_ROBIN"
+#define ARBITER_MATRIX         "MATRIX"
+
+// Telemetry output formats
+#define TELEMETRY_CSV          "CSV"
+#define TELEMETRY_BINARY       "BINARY"
+#define TELEMETRY_BOTH         "BOTH"
+
+// HBM stacks attached to the mesh edges. Packets for a stack carry a
+// negative dst_id: -(edge + 1) for the controller of the stack closest
+// to the source, -(edge + 1) - HBM_EDGES * (ctrl + 1) for controller ctrl
+#define HBM_EDGES              4
+#define HBM_EDGE_WEST          0
+#define HBM_EDGE_EAST          1
+#define HBM_EDGE_NORTH         2
+#define HBM_EDGE_SOUTH         3
+
+// Geometry of an HBM stack
+#define HBM_MEMORY_SIZE        (1ULL << 30)
+#define HBM_CHANNELS           16
+#define HBM_INTERLEAVE_SIZE    256
+
+// Controller serving a packet for an HBM stack
+#define HBM_CTRL_NEAREST       "NEAREST"
+#define HBM_CTRL_CHANNEL       "CHANNEL"
+
+// Hash of the HBM channel index
+#define HBM_HASH_NONE          "NONE"
+#define HBM_HASH_XOR_FOLD      "XOR_FOLD"
+
 // Channel selection 
 #define CHSEL_RANDOM 0
 #define CHSEL_FIRST_FREE 1
@@ -149,9 +180,12 @@ struct GlobalParams {
 	static bool use_debug_runner;
 	static unsigned int debug_port;
 	static bool pe_trace_mode;
-	static unsigned int tlm_global_quantum;
+	static int tlm_global_quantum;  // ns
 	static bool use_instr_dmi;
 	static bool use_data_dmi;
+	static bool use_jit;
+	static int iss_threads;
+	static int dma_hbm_test;
 	static addr_t mem_size;  
 	static addr_t mem_start_addr;
 	static addr_t mem_end_addr;
@@ -182,6 +216,7 @@ struct GlobalParams {
     static string routing_algorithm;
     static string routing_table_filename;
     static string selection_strategy;
+    static string reservation_arbiter;
     static double packet_injection_rate;
     static double probability_of_retransmission;
     static double locality;
@@ -195,6 +230,35 @@ struct GlobalParams {
     static int reset_time;
     static int stats_warm_up_time;
     static int rnd_generator_seed;
+    static int noc_threads;
+    static int telemetry_period;
+    static string telemetry_filename;
+    static string telemetry_format;
+    static string checkpoint_filename;
+    static int checkpoint_cycle;
+    static string restore_filename;
+    static string sweep_param;
+    static vector<string> sweep_values;
+    static int sweep_jobs;
+    static int hbm_pseudo_channels;
+    static int hbm_bank_groups;
+    static int hbm_banks_per_group;
+    static int hbm_row_size;
+    static int hbm_burst_size;
+    static int hbm_queue_depth;
+    static double hbm_tRCD;
+    static double hbm_tRP;
+    static double hbm_tCL;
+    static double hbm_tBURST;
+    static double hbm_tREFI;
+    static double hbm_tRFC;
+    static int hbm_ctrl_packets;
+    static int hbm_ctrl_requests;
+    static int hbm_ctrl_burst;
+    static vector<string> hbm_edges;
+    static string hbm_ctrl_mapping;
+    static string hbm_address_mapping;
+    static string hbm_channel_hash;
     static bool detailed;
     static vector <pair <int, double> > hotspots;
     static double dyad_threshold;
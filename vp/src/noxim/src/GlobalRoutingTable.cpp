@@ -65,19 +65,26 @@ int oLinkId2Direction(const LinkId & out_link)
 }
 
 vector <
-    int >admissibleOutputsSet2Vector(const AdmissibleOutputs & ao)
+    int >admissibleOutputs2Vector(const AdmissibleOutputs ao)
 {
+    // Same order of the output links (sorted by destination node) of the
+    // former set based table
+    static const int order[] = { DIRECTION_NORTH, DIRECTION_WEST,
+	DIRECTION_LOCAL, DIRECTION_EAST, DIRECTION_SOUTH
+    };
+
     vector < int >dirs;
 
-    for (AdmissibleOutputs::iterator i = ao.begin(); i != ao.end();
-	 i++)
-	dirs.push_back(oLinkId2Direction(*i));
+    for (int i = 0; i < DIRECTIONS + 1; i++)
+	if (ao & (1 << order[i]))
+	    dirs.push_back(order[i]);
 
     return dirs;
 }
 
 GlobalRoutingTable::GlobalRoutingTable()
 {
+    n_nodes = 0;
     valid = false;
 }
 
@@ -88,7 +95,8 @@ bool GlobalRoutingTable::load(const char *fname)
     if (!fin)
 	return false;
 
-    rt_noc.clear();
+    n_nodes = GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y;
+    rt_noc.assign(n_nodes * (DIRECTIONS + 1) * n_nodes, 0);
 
     bool stop = false;
     while (!fin.eof() && !stop) {
@@ -104,13 +112,21 @@ bool GlobalRoutingTable::load(const char *fname)
 		if (sscanf
 		    (line + 1, "%d %d->%d %d", &node_id, &in_src, &in_dst,
 		     &dst_id) == 4) {
-		    LinkId lin(in_src, in_dst);
+		    assert(node_id >= 0 && node_id < n_nodes);
+		    assert(dst_id >= 0 && dst_id < n_nodes);
+
+		    // the input link in_src->node_id enters from the
+		    // direction node_id would use to reach in_src
+		    int in_dir = oLinkId2Direction(LinkId(in_dst, in_src));
+		    AdmissibleOutputs & ao =
+			rt_noc[(node_id * (DIRECTIONS + 1) + in_dir) * n_nodes +
+			       dst_id];
 
 		    char *pstr = line + COLUMN_AOC;
 		    while (sscanf(pstr, "%d->%d", &out_src, &out_dst) == 2) {
 			LinkId lout(out_src, out_dst);
 
-			rt_noc[node_id][lin][dst_id].insert(lout);
+			ao |= 1 << oLinkId2Direction(lout);
 
 			pstr = strstr(pstr, ",");
 			pstr++;
@@ -125,8 +141,16 @@ bool GlobalRoutingTable::load(const char *fname)
     return true;
 }
 
-RoutingTableNode GlobalRoutingTable::
-getNodeRoutingTable(const int node_id)
+AdmissibleOutputs GlobalRoutingTable::
+getAdmissibleOutputs(const int node_id, const int in_direction,
+		     const int destination_id) const
 {
-    return rt_noc[node_id];
+    assert(in_direction >= 0 && in_direction <= DIRECTION_LOCAL);
+
+    if (node_id < 0 || node_id >= n_nodes || destination_id < 0
+	|| destination_id >= n_nodes)
+	return 0;
+
+    return rt_noc[(node_id * (DIRECTIONS + 1) + in_direction) * n_nodes +
+		  destination_id];
 }
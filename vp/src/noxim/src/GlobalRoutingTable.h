@@ -26,17 +26,9 @@ using namespace std;
 // Pair of source, destination node
 typedef pair < int, int >LinkId;
 
-// Routing table
-typedef set < LinkId > AdmissibleOutputs;
-
-// Map a destination to a set of admissible outputs
-typedef map < int, AdmissibleOutputs > RoutingTableLink;
-
-// Map an input link to its routing table
-typedef map < LinkId, RoutingTableLink > RoutingTableNode;
-
-// Map a node of the network to its routing table
-typedef map < int, RoutingTableNode > RoutingTableNoC;
+// Bitmask of admissible output directions (bit d set when direction d is
+// admissible)
+typedef unsigned char AdmissibleOutputs;
 
 // Converts an input direction to a link 
 LinkId direction2ILinkId(const int node_id, const int dir);
@@ -46,7 +38,7 @@ int oLinkId2Direction(const LinkId & out_link);
 
 // Converts a set of output links to a set of directions
 vector <
-    int >admissibleOutputsSet2Vector(const AdmissibleOutputs & ao);
+    int >admissibleOutputs2Vector(const AdmissibleOutputs ao);
 
 class GlobalRoutingTable {
 
@@ -57,13 +49,19 @@ class GlobalRoutingTable {
     // Load routing table from file. Returns true if ok, false otherwise
     bool load(const char *fname);
 
-    RoutingTableNode getNodeRoutingTable(const int node_id);
+    // Returns the admissible outputs of node node_id for the packets
+    // entering from in_direction and directed to destination_id
+    AdmissibleOutputs getAdmissibleOutputs(const int node_id,
+					   const int in_direction,
+					   const int destination_id) const;
 
     bool isValid() {
 	return valid;
   } private:
 
-     RoutingTableNoC rt_noc;
+    // Dense [node_id][in_direction][destination_id] table
+    vector < AdmissibleOutputs > rt_noc;
+    int n_nodes;
     bool valid;
 
 };
@@ -136,6 +136,25 @@ double GlobalStats::getMaxDelay(const int node_id)
 
 }
 
+double GlobalStats::getDelayPercentile(const double p)
+{
+    DelayHistogram h;
+
+    if (GlobalParams::topology == TOPOLOGY_MESH)
+    {
+	for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	    for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		noc->t[x][y]->r->stats.collectDelays(h);
+    }
+    else // other delta topologies
+    {
+	for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    noc->core[y]->r->stats.collectDelays(h);
+    }
+
+    return min(h.percentile(p), getMaxDelay());
+}
+
 double GlobalStats::getMaxDelay(const int src_id, const int dst_id)
 {
     Tile *tile = noc->searchNode(dst_id);
@@ -498,12 +517,37 @@ void GlobalStats::showStats(std::ostream & out, bool detailed)
     out << "% Average wireless utilization: " << getWirelessPackets()/(double)getReceivedPackets() << endl;
     out << "% Global average delay (cycles): " << getAverageDelay() << endl;
     out << "% Max delay (cycles): " << getMaxDelay() << endl;
+    out << "% Delay percentiles p50/p95/p99 (cycles): " << getDelayPercentile(0.50)
+	<< " / " << getDelayPercentile(0.95) << " / " << getDelayPercentile(0.99) << endl;
     out << "% Network throughput (flits/cycle): " << getAggregatedThroughput() << endl;
     out << "% Average IP throughput (flits/cycle/IP): " << getThroughput() << endl;
     out << "% Total energy (J): " << getTotalPower() << endl;
     out << "% \tDynamic energy (J): " << getDynamicPower() << endl;
     out << "% \tStatic energy (J): " << getStaticPower() << endl;
 
+    if (!noc->hbm_ctrl.empty())
+    {
+	for (unsigned int i = 0; i < noc->hbm.size(); i++)
+	    noc->hbm[i]->print_stats(out, detailed);
+
+	double throughput = 0.0;
+	for (unsigned int i = 0; i < noc->hbm_ctrl.size(); i++)
+	    throughput += noc->hbm_ctrl[i]->getThroughput();
+	out << "% HBM controllers throughput (bytes/cycle): " << throughput << endl;
+
+	if (detailed)
+	{
+	    out << "hbm_ctrl_stats = [" << endl;
+	    out << "%\tCTRL\tpackets\tbytes_rd\tbytes_wr\tB/cycle\tavg_outstanding" << endl;
+	    for (unsigned int i = 0; i < noc->hbm_ctrl.size(); i++)
+	    {
+		out << "\t";
+		noc->hbm_ctrl[i]->showStats(out);
+	    }
+	    out << "];" << endl;
+	}
+    }
+
     if (GlobalParams::show_buffer_stats)
       showBufferStats(out);
 
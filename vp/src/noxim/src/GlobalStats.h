@@ -44,6 +44,10 @@ class GlobalStats {
     // Returns tha matrix of max delay for any node of the network
      vector < vector < double > > getMaxDelayMtx();
 
+    // Returns the p-th (0..1] percentile of the delay (cycles) over
+    // all the received packets
+    double getDelayPercentile(const double p);
+
     // Returns the aggregated average throughput (flits/cycles)
     double getAggregatedThroughput();
 
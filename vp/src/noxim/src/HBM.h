@@ -4,82 +4,190 @@
  *
  * This HBM module features:
  * - 16 channels that can be accessed in parallel
- * - Configurable memory interleaving
+ * - Configurable memory interleaving and address mapping, see HBMAddressMap.h
  * - 64-bit read/write data granularity
- * - Support for concurrent access with synchronization mechanisms
+ * - Per channel timing model (banks, row buffers, FR-FCFS queue, refresh),
+ *   see HBMChannel.h
+ *
+ * A request is queued in its channel by the first b_transport call and
+ * answered with TLM_INCOMPLETE_RESPONSE until the channel has moved its
+ * data: the initiator retries the same transaction every cycle and gets
+ * TLM_OK_RESPONSE once it has completed (or TLM_INCOMPLETE_RESPONSE
+ * without queueing while the channel queue is full). Each transaction
+ * carries an HBMRequestTag telling its retries apart from the other
+ * requests of the initiator.
  */
 
 #ifndef HBM_H
 #define HBM_H
 
+#include <sys/mman.h>
 #include <systemc>
 #include <tlm.h>
 #include <tlm_utils/simple_target_socket.h>
-#include <tlm_utils/peq_with_cb_and_phase.h>
+#include <array>
+#include <cstring>
+#include <iostream>
 #include <vector>
-#include <map>
-#include <mutex>
-#include <memory>
-#include <atomic>
+
+#include "Checkpoint.h"
+#include "HBMAddressMap.h"
+#include "HBMChannel.h"
+#include "Utils.h"
+
+// Id of a request among the outstanding ones of its initiator, the same
+// on every retry of the request
+struct HBMRequestTag : public tlm::tlm_extension<HBMRequestTag> {
+    int id;
+
+    explicit HBMRequestTag(int _id = 0) : id(_id) {}
+
+    tlm::tlm_extension_base *clone() const override {
+        return new HBMRequestTag(id);
+    }
+
+    void copy_from(const tlm::tlm_extension_base &ext) override {
+        id = static_cast<const HBMRequestTag &>(ext).id;
+    }
+};
 
 class HBM : public sc_core::sc_module {
 public:
     // TLM-2.0 socket, one for each channel (16 channels total)
-    std::array<tlm_utils::simple_target_socket<HBM>, 16> targ_socket;
+    std::array<tlm_utils::simple_target_socket_tagged<HBM>, HBM_CHANNELS> targ_socket;
+
+    sc_core::sc_in_clk clock;
     
     // Constructor
     SC_HAS_PROCESS(HBM);
     HBM(sc_core::sc_module_name name, 
-        uint64_t memory_size = 1 * 1024 * 1024 * 1024ULL,  // 1GB default
-        uint32_t interleave_size = 256,                    // 256 bytes default
-        uint32_t num_channels = 16)                        // 16 channels default
+        uint64_t memory_size = HBM_MEMORY_SIZE,            // 1GB default
+        uint32_t interleave_size = HBM_INTERLEAVE_SIZE,    // 256 bytes default
+        uint32_t num_channels = HBM_CHANNELS)              // 16 channels default
     : sc_core::sc_module(name),
       m_memory_size(memory_size),
       m_interleave_size(interleave_size),
       m_num_channels(num_channels)
     {
-        // Register callbacks for each socket
-        for (uint32_t i = 0; i < m_num_channels; i++) {
-            targ_socket[i].register_b_transport(this, &HBM::b_transport);
+        // Register callbacks for each socket, tagged with the socket index
+        for (uint32_t i = 0; i < targ_socket.size(); i++) {
+            targ_socket[i].register_b_transport(this, &HBM::b_transport, i);
         }
+        m_pending.resize(targ_socket.size());
         
-        // Allocate memory for each channel
+        // Reserve the address space of each channel: pages are only
+        // backed (zero-filled) by the OS when first touched
         uint64_t channel_size = m_memory_size / m_num_channels;
         m_channel_data.resize(m_num_channels);
         
         for (uint32_t i = 0; i < m_num_channels; i++) {
-            m_channel_data[i] = new uint8_t[channel_size];
-            memset(m_channel_data[i], 0, channel_size);
+            void *data = mmap(NULL, channel_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (data == MAP_FAILED) {
+                std::cerr << "Error: cannot reserve " << channel_size << " bytes for HBM channel " << i << std::endl;
+                exit(1);
+            }
+            m_channel_data[i] = (uint8_t *)data;
         }
         
-        // Initialize access locks for each interleave block
-        uint64_t num_interleave_blocks = (m_memory_size / m_interleave_size) + 1;
-        for (uint64_t i = 0; i < num_interleave_blocks; i++) {
-            m_block_read_count[i] = 0;
-            m_block_write_lock[i] = false;
+        m_address_map.configure(m_memory_size, m_num_channels, m_interleave_size);
+
+        // Timing model of each channel
+        HBMTiming timing = HBMTiming::fromGlobalParams();
+        m_channels.resize(m_num_channels);
+        for (auto& channel : m_channels) {
+            channel.configure(timing);
         }
         
         // Statistics
         m_read_count = 0;
         m_write_count = 0;
-        m_read_conflicts = 0;
-        m_write_conflicts = 0;
+        m_queue_full = 0;
+
+        SC_METHOD(tick);
+        sensitive << clock.pos();
+        dont_initialize();
     }
     
     // Destructor
     ~HBM() {
+        uint64_t channel_size = m_memory_size / m_num_channels;
         for (auto& data : m_channel_data) {
-            delete[] data;
+            munmap(data, channel_size);
+        }
+        for (auto& pending : m_pending) {
+            for (auto request : pending) {
+                delete request;
+            }
         }
     }
     
-    // Print statistics
-    void print_stats() {
-        std::cout << "HBM Statistics:" << std::endl;
-        std::cout << "  Total Reads: " << m_read_count << std::endl;
-        std::cout << "  Total Writes: " << m_write_count << std::endl;
-        std::cout << "  Read Conflicts: " << m_read_conflicts << std::endl;
-        std::cout << "  Write Conflicts: " << m_write_conflicts << std::endl;
+    // Print statistics, per channel ones when detailed
+    void print_stats(std::ostream& out = std::cout, bool detailed = false) {
+        double clock_period_ps = GlobalParams::clock_period_ps;
+        double bandwidth = 0.0;
+        double row_hits = 0.0;
+        unsigned long requests = 0;
+        double queue_depth = 0.0;
+        unsigned int max_queue_depth = 0;
+
+        for (auto& channel : m_channels) {
+            bandwidth += channel.getBandwidth(clock_period_ps);
+            row_hits += channel.getRowHitRate() * channel.getRequests();
+            requests += channel.getRequests();
+            queue_depth += channel.getAverageQueueDepth();
+            max_queue_depth = std::max(max_queue_depth, channel.getMaxQueueDepth());
+        }
+
+        out << "% " << name() << " reads/writes: " << m_read_count << " / " << m_write_count << std::endl;
+        out << "% " << name() << " bandwidth (GB/s): " << bandwidth << std::endl;
+        out << "% " << name() << " row hit rate: " << (requests ? row_hits / requests : 0.0) << std::endl;
+        out << "% " << name() << " average/max channel queue depth: " << queue_depth / m_num_channels
+            << " / " << max_queue_depth << std::endl;
+        out << "% " << name() << " requests rejected on full queue: " << m_queue_full << std::endl;
+
+        if (detailed) {
+            out << name() << "_stats = [" << std::endl;
+            out << "%\tCH\treqs\tbytes\tGB/s\thit_rate\tmisses\tconflicts\tavg_queue\tmax_queue\trefreshes" << std::endl;
+            for (uint32_t i = 0; i < m_num_channels; i++) {
+                out << "\t";
+                m_channels[i].showStats(i, clock_period_ps, out);
+            }
+            out << "];" << std::endl;
+        }
+    }
+
+    // Save or restore the queued requests, the channel timing models and
+    // the memory contents (only the pages written so far are stored)
+    void serialize(Checkpoint& ckpt) {
+        ckpt.section(name());
+
+        for (auto& pending : m_pending) {
+            uint64_t n = pending.size();
+            ckpt.io(n);
+            if (!ckpt.isSaving()) {
+                for (auto request : pending) {
+                    delete request;
+                }
+                pending.resize(n);
+                for (auto& request : pending) {
+                    request = new HBMRequest;
+                }
+            }
+            for (auto request : pending) {
+                ckpt.io(*request);
+            }
+        }
+
+        uint64_t channel_size = m_memory_size / m_num_channels;
+        for (uint32_t i = 0; i < m_num_channels; i++) {
+            m_channels[i].serialize(ckpt, m_pending);
+            ckpt.image(m_channel_data[i], channel_size);
+        }
+
+        ckpt.io(m_read_count);
+        ckpt.io(m_write_count);
+        ckpt.io(m_queue_full);
     }
     
 private:
@@ -91,151 +199,114 @@ private:
     // Memory storage (one for each channel)
     std::vector<uint8_t*> m_channel_data;
     
-    // Synchronization for memory blocks
-    std::map<uint64_t, std::atomic<int>> m_block_read_count;  // Number of current readers per block
-    std::map<uint64_t, std::atomic<bool>> m_block_write_lock; // Write lock per block
-    std::mutex m_channel_mutex;  // Mutex for channel access coordination
+    HBMAddressMap m_address_map;
+
+    // Timing model (one for each channel) and requests queued by each socket
+    std::vector<HBMChannel> m_channels;
+    std::vector<std::vector<HBMRequest*>> m_pending;
     
     // Statistics
-    std::atomic<uint64_t> m_read_count;
-    std::atomic<uint64_t> m_write_count;
-    std::atomic<uint64_t> m_read_conflicts;
-    std::atomic<uint64_t> m_write_conflicts;
+    uint64_t m_read_count;
+    uint64_t m_write_count;
+    uint64_t m_queue_full;
     
     // Calculate which channel and offset within the channel for a given address
     void map_address(const uint64_t addr, uint32_t& channel, uint64_t& offset) {
-        // Determine interleave block index
-        uint64_t block_index = addr / m_interleave_size;
-        
-        // xor-shift algorithm to generate a random number
-        uint64_t x = block_index;
-        x ^= x << 13;
-        x ^= x >> 7;
-        x ^= x << 17;
-        channel = x % m_num_channels;
-        
-        // Calculate offset within the channel
-        uint64_t channel_block_index = block_index / m_num_channels;
-        uint64_t block_offset = addr % m_interleave_size;
-        offset = (channel_block_index * m_interleave_size) + block_offset;
+        m_address_map.map(addr, channel, offset);
     }
-    
-    // Get the block index for a given address
-    uint64_t get_block_index(const uint64_t addr) {
-        return addr / m_interleave_size;
+
+    unsigned long current_cycle() {
+        return (unsigned long)(sc_core::sc_time_stamp().to_double() / GlobalParams::clock_period_ps);
+    }
+
+    // Advance the timing model of every channel
+    void tick() {
+        unsigned long now = current_cycle();
+        for (auto& channel : m_channels) {
+            channel.tick(now);
+        }
     }
     
     // TLM-2.0 blocking transport method
-    void b_transport(tlm::tlm_generic_payload& trans, sc_core::sc_time& delay) {
+    void b_transport(int id, tlm::tlm_generic_payload& trans, sc_core::sc_time& delay) {
         tlm::tlm_command cmd = trans.get_command();
         uint64_t addr = trans.get_address();
         unsigned char* data_ptr = trans.get_data_ptr();
         unsigned int data_length = trans.get_data_length();
+
+        if (cmd != tlm::TLM_READ_COMMAND && cmd != tlm::TLM_WRITE_COMMAND) {
+            trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+            return;
+        }
+        HBMRequestTag *tag = trans.get_extension<HBMRequestTag>();
+        if (tag == nullptr) {
+            trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+            return;
+        }
+        bool is_write = cmd == tlm::TLM_WRITE_COMMAND;
         
         // Map address to channel and offset
         uint32_t channel;
         uint64_t offset;
         map_address(addr, channel, offset);
         
-        // Get block index for synchronization
-        uint64_t block_index = get_block_index(addr);
-        
         // Check if address is valid
         if (offset + data_length > (m_memory_size / m_num_channels)) {
             trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
             return;
         }
+
+        // Look for the request queued by a previous attempt
+        std::vector<HBMRequest*>& pending = m_pending[id];
+        unsigned int i = 0;
+        while (i < pending.size() && pending[i]->tag != tag->id) {
+            i++;
+        }
+
+        if (i == pending.size()) {
+            HBMRequest *r = new HBMRequest;
+            r->initiator = id;
+            r->tag = tag->id;
+            r->is_write = is_write;
+            r->addr = addr;
+            r->length = data_length;
+            m_channels[channel].decode(offset, *r);
+
+            if (m_channels[channel].enqueue(r, current_cycle())) {
+                pending.push_back(r);
+            } else {
+                delete r;
+                m_queue_full++;
+            }
+            trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+            return;
+        }
+
+        assert(pending[i]->addr == addr && pending[i]->is_write == is_write && pending[i]->length == data_length);
+        if (!pending[i]->done) {
+            trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+            return;
+        }
+        delete pending[i];
+        pending.erase(pending.begin() + i);
         
-        // Process read/write command
-        if (cmd == tlm::TLM_READ_COMMAND) {
-            // Lock for reading
-            acquire_read_lock(block_index);
-            
-            // Perform read from the mapped channel
+        // The channel has moved the data: perform the access
+        if (!is_write) {
             memcpy(data_ptr, &m_channel_data[channel][offset], data_length);
-            
-            // Release read lock
-            release_read_lock(block_index);
-            
             m_read_count++;
-            
-            // Set response status
-            trans.set_response_status(tlm::TLM_OK_RESPONSE);
-            
-            // Add memory read latency
-            delay += sc_core::sc_time(30, sc_core::SC_NS);
-        }
-        else if (cmd == tlm::TLM_WRITE_COMMAND) {
-            // Lock for writing
-            bool acquired = acquire_write_lock(block_index);
-            
-            if (acquired) {
-                // Perform write to the mapped channel
-                memcpy(&m_channel_data[channel][offset], data_ptr, data_length);
-
-                // Print data_ptr in red
-                std::cout << "\033[1;31m";
-                for (unsigned int i = 0; i < data_length; ++i) {
-                    std::cout << static_cast<char>(data_ptr[i]);
-                }
-                std::cout << "\033[0m" << std::endl;
-                
-                // Release write lock
-                release_write_lock(block_index);
-                
-                m_write_count++;
-                
-                // Set response status
-                trans.set_response_status(tlm::TLM_OK_RESPONSE);
-                
-                // Add memory write latency
-                delay += sc_core::sc_time(30, sc_core::SC_NS);
-            }
-            else {
-                // Write conflict, transaction needs to be retried
-                m_write_conflicts++;
-                trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
-                
-                // Schedule retry after some delay
-                // sc_core::sc_time retry_delay = delay + sc_core::sc_time(10, sc_core::SC_NS);
-            }
         }
         else {
-            trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
-        }
-    }
-    
-    // Acquire read lock for a memory block
-    void acquire_read_lock(uint64_t block_index) {
-        // Wait until there's no writer
-        while (m_block_write_lock[block_index].load()) {
-            m_read_conflicts++;
-            sc_core::wait(sc_core::SC_ZERO_TIME);
+            memcpy(&m_channel_data[channel][offset], data_ptr, data_length);
+
+            if (GlobalParams::verbose_mode == VERBOSE_HIGH) {
+                LOG << "write 0x" << std::hex << addr << std::dec << " [" << data_length << "]: "
+                    << std::string((const char *)data_ptr, data_length) << std::endl;
+            }
+
+            m_write_count++;
         }
-        
-        // Increment read count
-        m_block_read_count[block_index]++;
-    }
-    
-    // Release read lock for a memory block
-    void release_read_lock(uint64_t block_index) {
-        m_block_read_count[block_index]--;
-    }
-    
-    // Acquire write lock for a memory block
-    bool acquire_write_lock(uint64_t block_index) {
-        // Check if any readers or another writer
-        if (m_block_read_count[block_index].load() > 0 || 
-            m_block_write_lock[block_index].exchange(true)) {
-            return false;
-        }
-        return true;
-    }
-    
-    // Release write lock for a memory block
-    void release_write_lock(uint64_t block_index) {
-        m_block_write_lock[block_index] = false;
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
     }
 };
 
-#endif // HBM_H
\ No newline at end of file
+#endif // HBM_H
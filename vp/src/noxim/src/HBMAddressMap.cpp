@@ -0,0 +1,104 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the HBM address mapping
+ */
+
+#include "HBMAddressMap.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+static int log2i(uint64_t x)
+{
+	int n = 0;
+	while (x > 1) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+}
+
+bool HBMAddressMap::configure(const string & order, const string & hash, const uint64_t memory_size,
+                              const int channels, const int interleave_size, const int row_size, const int banks)
+{
+	block_bits = log2i(interleave_size);
+	bits[FIELD_CH] = log2i(channels);
+	bits[FIELD_BA] = log2i(banks);
+	bits[FIELD_CO] = row_size > interleave_size ? log2i(row_size / interleave_size) : 0;
+	bits[FIELD_RO] = log2i(memory_size) - block_bits - bits[FIELD_CH] - bits[FIELD_BA] - bits[FIELD_CO];
+	xor_fold = hash == HBM_HASH_XOR_FOLD;
+
+	// Fields are listed from the most significant one
+	vector<int> fields;
+	stringstream ss(order);
+	string token;
+	while (getline(ss, token, '_')) {
+		if (token == "CH")
+			fields.push_back(FIELD_CH);
+		else if (token == "BA")
+			fields.push_back(FIELD_BA);
+		else if (token == "CO")
+			fields.push_back(FIELD_CO);
+		else if (token == "RO")
+			fields.push_back(FIELD_RO);
+		else
+			return false;
+	}
+
+	bool seen[FIELDS] = {false, false, false, false};
+	for (unsigned int i = 0; i < fields.size(); i++) {
+		if (seen[fields[i]])
+			return false;
+		seen[fields[i]] = true;
+	}
+	if (fields.size() != FIELDS || bits[FIELD_RO] < 0)
+		return false;
+
+	int s = block_bits;
+	for (int i = FIELDS - 1; i >= 0; i--) {
+		shift[fields[i]] = s;
+		s += bits[fields[i]];
+	}
+	address_bits = s;
+
+	return true;
+}
+
+void HBMAddressMap::configure(const uint64_t memory_size, const int channels, const int interleave_size)
+{
+	if (!configure(GlobalParams::hbm_address_mapping, GlobalParams::hbm_channel_hash, memory_size, channels,
+	               interleave_size, GlobalParams::hbm_row_size,
+	               GlobalParams::hbm_pseudo_channels * GlobalParams::hbm_bank_groups * GlobalParams::hbm_banks_per_group)) {
+		cerr << "Error: invalid HBM address mapping " << GlobalParams::hbm_address_mapping << endl;
+		exit(1);
+	}
+}
+
+void HBMAddressMap::map(const uint64_t addr, uint32_t & channel, uint64_t & offset) const
+{
+	uint64_t value[FIELDS];
+	for (int f = 0; f < FIELDS; f++)
+		value[f] = (addr >> shift[f]) & ((1ULL << bits[f]) - 1);
+
+	// Addresses above the memory size keep their upper bits in the row,
+	// so that they fall out of the channel
+	value[FIELD_RO] |= (addr >> address_bits) << bits[FIELD_RO];
+
+	channel = value[FIELD_CH];
+	if (xor_fold && bits[FIELD_CH] > 0) {
+		uint64_t x = (((value[FIELD_RO] << bits[FIELD_BA]) | value[FIELD_BA]) << bits[FIELD_CO]) | value[FIELD_CO];
+		while (x) {
+			channel ^= x & ((1ULL << bits[FIELD_CH]) - 1);
+			x >>= bits[FIELD_CH];
+		}
+	}
+
+	uint64_t row_index = (value[FIELD_RO] << bits[FIELD_BA]) | value[FIELD_BA];
+	offset = (((row_index << bits[FIELD_CO]) | value[FIELD_CO]) << block_bits) | (addr & ((1ULL << block_bits) - 1));
+}
@@ -0,0 +1,56 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the HBM address mapping
+ */
+
+#ifndef __NOXIMHBMADDRESSMAP_H__
+#define __NOXIMHBMADDRESSMAP_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GlobalParams.h"
+
+using namespace std;
+
+/* An address is split, above the offset within an interleave block, into
+ * channel (CH), bank (BA), column (CO, the interleave blocks of a row)
+ * and row (RO) fields. Their order, from the most significant one, is
+ * given by a string such as "RO_BA_CO_CH" (consecutive blocks on
+ * consecutive channels) or "CH_RO_BA_CO" (each channel a contiguous
+ * range). With the XOR_FOLD hash the channel field is xored with the
+ * other fields folded to its width, which spreads strided accesses
+ * while keeping the mapping one to one.
+ */
+class HBMAddressMap {
+ public:
+	// All sizes and counts must be powers of two, false on a bad order
+	bool configure(const string & order, const string & hash, const uint64_t memory_size,
+	               const int channels, const int interleave_size, const int row_size, const int banks);
+
+	// Mapping of GlobalParams for an HBM stack of the given geometry
+	void configure(const uint64_t memory_size, const int channels, const int interleave_size);
+
+	// Channel of an address and its offset within the channel, laid out
+	// as expected by HBMChannel::decode()
+	void map(const uint64_t addr, uint32_t & channel, uint64_t & offset) const;
+
+	static bool isPowerOfTwo(const uint64_t x) { return x && !(x & (x - 1)); }
+
+ private:
+	enum Field { FIELD_CH, FIELD_BA, FIELD_CO, FIELD_RO, FIELDS };
+
+	int block_bits;
+	int address_bits;   // Of the memory size
+	int bits[FIELDS];
+	int shift[FIELDS];  // Of each field, from the least significant bit
+	bool xor_fold;
+};
+
+#endif
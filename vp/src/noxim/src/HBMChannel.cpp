@@ -0,0 +1,274 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the HBM channel timing model
+ */
+
+#include "HBMChannel.h"
+#include "Checkpoint.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int nsToCycles(const double ns)
+{
+	return (int)ceil(ns * 1000.0 / GlobalParams::clock_period_ps);
+}
+
+HBMTiming HBMTiming::fromGlobalParams()
+{
+	HBMTiming t;
+
+	t.pseudo_channels = GlobalParams::hbm_pseudo_channels;
+	t.bank_groups = GlobalParams::hbm_bank_groups;
+	t.banks_per_group = GlobalParams::hbm_banks_per_group;
+	t.row_size = GlobalParams::hbm_row_size;
+	t.burst_size = GlobalParams::hbm_burst_size;
+	t.queue_depth = GlobalParams::hbm_queue_depth;
+	t.tRCD = nsToCycles(GlobalParams::hbm_tRCD);
+	t.tRP = nsToCycles(GlobalParams::hbm_tRP);
+	t.tCL = nsToCycles(GlobalParams::hbm_tCL);
+	t.tBURST = max(1, nsToCycles(GlobalParams::hbm_tBURST));
+	t.tREFI = nsToCycles(GlobalParams::hbm_tREFI);
+	t.tRFC = nsToCycles(GlobalParams::hbm_tRFC);
+
+	return t;
+}
+
+void HBMChannel::configure(const HBMTiming & _timing)
+{
+	timing = _timing;
+	banks_per_pc = timing.bank_groups * timing.banks_per_group;
+
+	Bank closed = { NOT_VALID, 0 };
+	banks.assign(timing.pseudo_channels * banks_per_pc, closed);
+	bus_free.assign(timing.pseudo_channels, 0);
+	candidate.assign(timing.pseudo_channels, NOT_VALID);
+	settled.assign(timing.pseudo_channels, false);
+	queue.clear();
+	in_flight.clear();
+	next_refresh = timing.tREFI;
+
+	cycles = 0;
+	requests = 0;
+	bytes = 0;
+	row_hits = 0;
+	row_misses = 0;
+	row_conflicts = 0;
+	refreshes = 0;
+	queue_depth_sum = 0;
+	max_queue_depth = 0;
+}
+
+void HBMChannel::decode(const uint64_t offset, HBMRequest & r) const
+{
+	// Consecutive rows are spread over the pseudo channels first, then
+	// over the bank groups and last over the banks of a group
+	uint64_t row_index = offset / timing.row_size;
+	int n_banks = timing.pseudo_channels * banks_per_pc;
+	int b = row_index % n_banks;
+
+	r.pseudo_channel = b % timing.pseudo_channels;
+	b /= timing.pseudo_channels;
+	int group = b % timing.bank_groups;
+	r.bank = group * timing.banks_per_group + b / timing.bank_groups;
+	r.row = row_index / n_banks;
+}
+
+bool HBMChannel::enqueue(HBMRequest * r, const unsigned long now)
+{
+	if ((int)queue.size() >= timing.queue_depth)
+		return false;
+
+	r->arrival = now;
+	r->completion = 0;
+	r->done = false;
+	queue.push_back(r);
+
+	return true;
+}
+
+void HBMChannel::issue(HBMRequest * r, const unsigned long now)
+{
+	Bank & bank = banks[r->pseudo_channel * banks_per_pc + r->bank];
+	int latency;
+
+	if (bank.open_row == r->row) {
+		latency = timing.tCL;
+		row_hits++;
+	} else if (bank.open_row == NOT_VALID) {
+		latency = timing.tRCD + timing.tCL;
+		row_misses++;
+	} else {
+		latency = timing.tRP + timing.tRCD + timing.tCL;
+		row_conflicts++;
+	}
+
+	// The data of the request is moved in bursts once the bus is free
+	unsigned long bursts = max(1u, (r->length + timing.burst_size - 1) / timing.burst_size);
+	unsigned long data_start = max(now + latency, bus_free[r->pseudo_channel]);
+
+	r->completion = data_start + bursts * timing.tBURST;
+	bus_free[r->pseudo_channel] = r->completion;
+
+	// Column commands to the open row are spaced by the bursts they move
+	bank.open_row = r->row;
+	bank.ready = now + latency - timing.tCL + bursts * timing.tBURST;
+
+	requests++;
+	bytes += r->length;
+	in_flight.push_back(r);
+}
+
+void HBMChannel::tick(const unsigned long now)
+{
+	cycles++;
+
+	if (timing.tREFI > 0 && now >= next_refresh) {
+		// All-bank refresh: rows are closed and banks are blocked for tRFC
+		for (unsigned int i = 0; i < banks.size(); i++) {
+			banks[i].ready = max(banks[i].ready, now) + timing.tRFC;
+			banks[i].open_row = NOT_VALID;
+		}
+		next_refresh = now + timing.tREFI;
+		refreshes++;
+	}
+
+	for (unsigned int i = 0; i < in_flight.size();) {
+		if (in_flight[i]->completion <= now) {
+			in_flight[i]->done = true;
+			in_flight[i] = in_flight.back();
+			in_flight.pop_back();
+		} else
+			i++;
+	}
+
+	unsigned int depth = queue.size() + in_flight.size();
+	queue_depth_sum += depth;
+	max_queue_depth = max(max_queue_depth, depth);
+
+	if (queue.empty())
+		return;
+
+	// First-Ready FCFS. A pseudo channel accepts a new command only when
+	// its data could follow the current transfer, otherwise requests
+	// would be committed in arrival order before a row hit shows up
+	bool any = false;
+	for (int pc = 0; pc < timing.pseudo_channels; pc++) {
+		candidate[pc] = NOT_VALID;
+		settled[pc] = bus_free[pc] > now + timing.tCL;
+	}
+
+	for (unsigned int i = 0; i < queue.size(); i++) {
+		HBMRequest *r = queue[i];
+		int pc = r->pseudo_channel;
+
+		if (settled[pc])
+			continue;
+
+		const Bank & bank = banks[pc * banks_per_pc + r->bank];
+		if (bank.ready > now)
+			continue;
+
+		bool hit = bank.open_row == r->row;
+		if (hit || candidate[pc] == NOT_VALID) {
+			candidate[pc] = i;
+			settled[pc] = hit;  // Nothing beats the oldest row hit
+			any = true;
+		}
+	}
+
+	if (!any)
+		return;
+
+	// Remove the issued requests from the back of the queue first
+	issued.clear();
+	for (int pc = 0; pc < timing.pseudo_channels; pc++)
+		if (candidate[pc] >= 0)
+			issued.push_back(candidate[pc]);
+	sort(issued.rbegin(), issued.rend());
+
+	for (unsigned int i = 0; i < issued.size(); i++) {
+		issue(queue[issued[i]], now);
+		queue.erase(queue.begin() + issued[i]);
+	}
+}
+
+double HBMChannel::getBandwidth(const double clock_period_ps) const
+{
+	if (cycles == 0)
+		return 0.0;
+
+	// bytes/ps * 1000 = GB/s
+	return bytes * 1000.0 / (cycles * clock_period_ps);
+}
+
+double HBMChannel::getRowHitRate() const
+{
+	if (requests == 0)
+		return 0.0;
+
+	return (double) row_hits / requests;
+}
+
+double HBMChannel::getAverageQueueDepth() const
+{
+	if (cycles == 0)
+		return 0.0;
+
+	return (double) queue_depth_sum / cycles;
+}
+
+void HBMChannel::showStats(const int id, const double clock_period_ps, std::ostream & out) const
+{
+	out << id << "\t" << requests << "\t" << bytes << "\t" << getBandwidth(clock_period_ps)
+	    << "\t" << getRowHitRate() << "\t" << row_misses << "\t" << row_conflicts
+	    << "\t" << getAverageQueueDepth() << "\t" << max_queue_depth << "\t" << refreshes << endl;
+}
+
+void HBMChannel::serializeRequests(Checkpoint & ckpt, const vector<vector<HBMRequest *> > & pending,
+                                   vector<HBMRequest *> & requests)
+{
+	uint64_t n = requests.size();
+	ckpt.io(n);
+	requests.resize(n);
+
+	for (unsigned int i = 0; i < requests.size(); i++) {
+		int initiator = 0;
+		int index = 0;
+		if (ckpt.isSaving()) {
+			initiator = requests[i]->initiator;
+			const vector<HBMRequest *> & p = pending[initiator];
+			index = find(p.begin(), p.end(), requests[i]) - p.begin();
+		}
+		ckpt.io(initiator);
+		ckpt.io(index);
+		requests[i] = pending[initiator][index];
+	}
+}
+
+void HBMChannel::serialize(Checkpoint & ckpt, const vector<vector<HBMRequest *> > & pending)
+{
+	ckpt.io(banks);
+	ckpt.io(bus_free);
+	ckpt.io(next_refresh);
+
+	vector<HBMRequest *> waiting(queue.begin(), queue.end());
+	serializeRequests(ckpt, pending, waiting);
+	queue.assign(waiting.begin(), waiting.end());
+	serializeRequests(ckpt, pending, in_flight);
+
+	ckpt.io(cycles);
+	ckpt.io(requests);
+	ckpt.io(bytes);
+	ckpt.io(row_hits);
+	ckpt.io(row_misses);
+	ckpt.io(row_conflicts);
+	ckpt.io(refreshes);
+	ckpt.io(queue_depth_sum);
+	ckpt.io(max_queue_depth);
+}
@@ -0,0 +1,125 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the HBM channel timing model
+ */
+
+#ifndef __NOXIMHBMCHANNEL_H__
+#define __NOXIMHBMCHANNEL_H__
+
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+#include "GlobalParams.h"
+
+using namespace std;
+
+class Checkpoint;
+
+// Organization and timings of a channel, timings in clock cycles
+struct HBMTiming {
+	int pseudo_channels;
+	int bank_groups;      // Per pseudo channel
+	int banks_per_group;
+	int row_size;         // Bytes of a row (page) of a bank
+	int burst_size;       // Bytes moved by one burst on a pseudo channel
+	int queue_depth;      // Requests a channel controller can hold
+	int tRCD;             // Activate to column command
+	int tRP;              // Precharge
+	int tCL;              // Column command to first data
+	int tBURST;           // Data bus occupancy of one burst
+	int tREFI;            // Refresh interval, 0 disables refresh
+	int tRFC;             // Refresh cycle time
+
+	// Timings of GlobalParams converted from ns to clock cycles
+	static HBMTiming fromGlobalParams();
+};
+
+struct HBMRequest {
+	int initiator;          // Target socket the request came from
+	int tag;                // HBMRequestTag of the transaction
+	bool is_write;
+	uint64_t addr;
+	unsigned int length;
+	int pseudo_channel;
+	int bank;               // Within the pseudo channel
+	long row;
+	unsigned long arrival;  // Cycle the request entered the queue
+	unsigned long completion;
+	bool done;              // Data transferred, the initiator can collect it
+};
+
+/* A channel holds the open row and the busy time of every bank and
+ * schedules its queue First-Ready FCFS: every cycle each pseudo channel
+ * issues the oldest request hitting an open row of a ready bank or,
+ * if there is none, the oldest request to a ready bank. Banks are left
+ * open after an access (open page policy) and all of them are closed
+ * by the periodic refresh.
+ */
+class HBMChannel {
+ public:
+	void configure(const HBMTiming & _timing);
+
+	// Locate pseudo channel, bank and row of an offset within the channel
+	void decode(const uint64_t offset, HBMRequest & r) const;
+
+	// Queue a request, false if the queue is full
+	bool enqueue(HBMRequest * r, const unsigned long now);
+
+	// Advance the channel to cycle now
+	void tick(const unsigned long now);
+
+	bool isIdle() const { return queue.empty() && in_flight.empty(); }
+
+	void showStats(const int id, const double clock_period_ps, std::ostream & out) const;
+
+	// Save or restore banks, queue and statistics. Requests are owned by
+	// the HBM and referred to by their position in pending[initiator]
+	void serialize(Checkpoint & ckpt, const vector<vector<HBMRequest *> > & pending);
+
+	double getBandwidth(const double clock_period_ps) const;  // GB/s
+	double getRowHitRate() const;
+	double getAverageQueueDepth() const;
+	unsigned int getMaxQueueDepth() const { return max_queue_depth; }
+	unsigned long getRequests() const { return requests; }
+
+ private:
+	struct Bank {
+		long open_row;  // NOT_VALID when precharged
+		unsigned long ready;
+	};
+
+	HBMTiming timing;
+	int banks_per_pc;
+	vector<Bank> banks;              // [pseudo_channel * banks_per_pc + bank]
+	vector<unsigned long> bus_free;  // Data bus of each pseudo channel
+	deque<HBMRequest *> queue;       // Waiting, in arrival order
+	vector<HBMRequest *> in_flight;  // Issued, not yet completed
+	vector<int> candidate;           // Queue slot chosen for each pseudo channel
+	vector<char> settled;            // Pseudo channel busy or row hit found
+	vector<int> issued;              // Queue slots issued in the current cycle
+	unsigned long next_refresh;
+
+	// Statistics
+	unsigned long cycles;
+	unsigned long requests;
+	unsigned long bytes;
+	unsigned long row_hits;
+	unsigned long row_misses;
+	unsigned long row_conflicts;
+	unsigned long refreshes;
+	unsigned long queue_depth_sum;
+	unsigned int max_queue_depth;
+
+	void issue(HBMRequest * r, const unsigned long now);
+	void serializeRequests(Checkpoint & ckpt, const vector<vector<HBMRequest *> > & pending,
+	                       vector<HBMRequest *> & requests);
+};
+
+#endif
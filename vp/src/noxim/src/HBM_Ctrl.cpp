@@ -9,6 +9,10 @@
  */
 
 #include "HBM_Ctrl.h"
+#include "Checkpoint.h"
+#include "HBM.h"
+
+#include <algorithm>
 
 void HBM_CTRL::process() {
 	txProcess();
@@ -22,6 +26,7 @@ void HBM_CTRL::rxProcess() {
 		// Clear outputs and indexes of receiving protocol
 		ack_rx.write(0);
 		current_level_rx = 0;
+		telemetry.clear();
 		buffer_full_status_rx.write(bfs);
 	} else {
 		// This process simply sees a flow of incoming flits. All arbitration
@@ -38,6 +43,7 @@ void HBM_CTRL::rxProcess() {
             if (!flits_buffer.IsFull()) {
                 // Store the incoming flit in the circular buffer
                 flits_buffer.Push(received_flit);
+                telemetry.rx_flits++;
 
                 // Negate the old value for Alternating Bit Protocol (ABP)
                 current_level_rx = 1 - current_level_rx;
@@ -86,10 +92,11 @@ void HBM_CTRL::txProcess() {
         }
 
 		// 2nd phase: Forwarding
-        vector<pair<int, int> > reservations = reservation_table.getReservations(0);
+        pair<int, int> reservations[1];
+        int n_reservations = reservation_table.getReservations(0, reservations);
 
-        if (reservations.size() != 0) {
-            int rnd_idx = rand() % reservations.size();
+        if (n_reservations != 0) {
+            int rnd_idx = rng() % n_reservations;
 
             int o = reservations[rnd_idx].first;
             int vc = reservations[rnd_idx].second;
@@ -103,6 +110,7 @@ void HBM_CTRL::txProcess() {
                     current_level_tx = 1 - current_level_tx;
                     req_tx.write(current_level_tx);
                     buffer.Pop();
+                    telemetry.tx_flits++;
 
                     if (flit.flit_type == FLIT_TYPE_TAIL) {
                         TReservation r;
@@ -122,177 +130,359 @@ void HBM_CTRL::txProcess() {
 void HBM_CTRL::configure(const int _id, const unsigned int _max_buffer_size) {
 	local_id = _id;
 
+	// Negative tag keeps the stream apart from the one of router _id
+	seed_seq seq{GlobalParams::rnd_generator_seed, -(_id + 1)};
+	rng.seed(seq);
+
 	reservation_table.setSize(1);
 
 	buffer.SetMaxBufferSize(_max_buffer_size);
 	buffer.setLabel(string(name()) + "->buffer[" + i_to_string(0) + "]");
+
+	// Configured again by NoC::reconfigure(): the slots kept keep their payload
+	unsigned int kept = min(bursts.size(), (size_t)GlobalParams::hbm_ctrl_requests);
+	for (unsigned int b = kept; b < bursts.size(); b++)
+		delete bursts[b].trans;
+	packets.resize(GlobalParams::hbm_ctrl_packets);
+	bursts.resize(GlobalParams::hbm_ctrl_requests);
+	for (unsigned int b = kept; b < bursts.size(); b++) {
+		bursts[b].trans = new tlm::tlm_generic_payload;
+		bursts[b].trans->set_extension(new HBMRequestTag(b));
+	}
+	resetHBM();
+}
+
+void HBM_CTRL::resetHBM() {
+    for (unsigned int p = 0; p < packets.size(); p++)
+        packets[p].valid = false;
+    for (unsigned int b = 0; b < bursts.size(); b++)
+        bursts[b].valid = false;
+    for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++)
+        vc_packet[vc] = NOT_VALID;
+
+    packet_order.clear();
+    ready_packets.clear();
+    responding = NOT_VALID;
+    n_bursts = 0;
+
+    bytes_read = 0;
+    bytes_written = 0;
+    packets_served = 0;
+    outstanding_sum = 0;
+    cycles = 0;
 }
 
 void HBM_CTRL::handleHBM() {
-    // Define HBM controller state enumeration
-    enum HBMState {
-        HBM_IDLE,
-        HBM_READ
-    };
-    
-    // Use static variable to maintain state
-    static HBMState state = HBM_IDLE;
-    static tlm::tlm_command current_cmd;
-    static uint64_t current_addr;
-    static int remaining_len;
-    static int current_sequence_no = 0;
-    static int total_sequence_length = 0;
-    static int src_id, dst_id, vc_id;
-    static double timestamp;
-    static int hop_no;
-    
-    // Create TLM transaction and delay objects
-    tlm::tlm_generic_payload trans;
-    sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
-    
-    // Check if flits_buffer is empty
-    if (flits_buffer.IsEmpty()) {
-        return; // No flits to process
+    if (reset.read()) {
+        resetHBM();
+        return;
     }
-    
-    // Get the first flit from the flits_buffer
+
+    // Stages are evaluated from the last one so that a flit takes at
+    // least one cycle to move through each of them
+    pollRequests();
+    sendResponse();
+    issueRequests();
+    acceptFlit();
+
+    cycles++;
+    outstanding_sum += n_bursts;
+}
+
+void HBM_CTRL::acceptFlit() {
+    if (flits_buffer.IsEmpty())
+        return;
+
     Flit flit = flits_buffer.Front();
-    
-    // Process flits_buffer based on current state
-    switch (state) {
-        case HBM_IDLE:
-            {
-                if (flit.flit_type == FLIT_TYPE_HEAD && flit.cmd == tlm::TLM_READ_COMMAND) {
-                    state = HBM_READ;
-
-                    // Save transaction information
-                    current_cmd = flit.cmd;
-                    current_addr = flit.addr;
-                    remaining_len = flit.len;
-                    total_sequence_length = 1 + ((remaining_len + FLIT_SIZE - 1) / FLIT_SIZE) + 1;
-                    src_id = flit.src_id;
-                    dst_id = flit.dst_id;
-                    vc_id = flit.vc_id;
-                    timestamp = flit.timestamp;
-                    hop_no = flit.hop_no;
-                    current_sequence_no = 0;
-                } else if (flit.flit_type == FLIT_TYPE_BODY && flit.cmd == tlm::TLM_WRITE_COMMAND) {
-                    // Set transaction parameters
-                    trans.set_command(flit.cmd);
-                    trans.set_address(flit.addr);
-                    trans.set_data_length(flit.valid_len);
-                    
-                    // Allocate and prepare write data
-                    uint8_t* data_ptr = new uint8_t[flit.valid_len];
-                    memcpy(data_ptr, flit.data, flit.valid_len);
-                    trans.set_data_ptr(data_ptr);
-                    
-                    // Send write transaction to HBM
-                    hbm_socket->b_transport(trans, delay);
-                    
-                    // Free allocated memory
-                    delete[] data_ptr;
-                    
-                    if (trans.get_response_status() == tlm::TLM_OK_RESPONSE) {
-                        // Remove processed flit
-                        flits_buffer.Pop();
-                    }
-                } else if (flit.flit_type == FLIT_TYPE_HEAD && flit.cmd == tlm::TLM_WRITE_COMMAND) {
-                    // Remove head flit
-                    flits_buffer.Pop();
-                } else if (flit.flit_type == FLIT_TYPE_TAIL) {
-                    // Remove tail flit
-                    flits_buffer.Pop();
-                } 
-            }
-            break;
-            
-        case HBM_READ:
-            {
-                // Defensive programming
-                assert(current_cmd == tlm::TLM_READ_COMMAND);
-                
-                // Check if there is enough buffer space for response
-                if (buffer.IsFull()) {
-                    break;
-                }
-                
-                // Determine the type of flit to create
-                FlitType current_flit_type;
-                if (current_sequence_no == 0) {
-                    current_flit_type = FLIT_TYPE_HEAD;
-                } else if (current_sequence_no == total_sequence_length - 1) {
-                    current_flit_type = FLIT_TYPE_TAIL;
-                } else {
-                    current_flit_type = FLIT_TYPE_BODY;
-                }
-                
-                // Create response flit
-                Flit response_flit;
-                response_flit.src_id = dst_id;
-                response_flit.dst_id = src_id;
-                response_flit.vc_id = vc_id;
-                response_flit.timestamp = timestamp;
-                response_flit.hop_no = hop_no;
-                response_flit.sequence_no = current_sequence_no;
-                response_flit.sequence_length = total_sequence_length;
-                response_flit.flit_type = current_flit_type;
-                
-                // Only BODY type flit contains actual data read from HBM
-                if (current_flit_type == FLIT_TYPE_BODY) {
-                    // Calculate the number of bytes to read this time
-                    int bytes_to_read = min(remaining_len, FLIT_SIZE);
-                    response_flit.valid_len = bytes_to_read;
-                    
-                    // Set transaction parameters
-                    trans.set_command(tlm::TLM_READ_COMMAND);
-                    trans.set_address(current_addr);
-                    trans.set_data_length(bytes_to_read);
-                    
-                    // Allocate buffer for read data
-                    uint8_t* data_ptr = new uint8_t[bytes_to_read];
-                    trans.set_data_ptr(data_ptr);
-                    
-                    // Send read transaction to HBM
-                    hbm_socket->b_transport(trans, delay);
-                    
-                    // Check if transaction is successful
-                    if (trans.get_response_status() == tlm::TLM_OK_RESPONSE) {
-                        // Copy read data to response flit
-                        memcpy(response_flit.data, data_ptr, bytes_to_read);
-                        
-                        // Update address and remaining length
-                        current_addr += bytes_to_read;
-                        remaining_len -= bytes_to_read;
-
-                        // Push response flit to send buffer
-                        buffer.Push(response_flit);
-                        current_sequence_no++;
-                    }
-                    
-                    // Release allocated memory
-                    delete[] data_ptr;
-                } else {
-                    // For HEAD and TAIL type flits, no actual data
-                    // You can choose to clear the data area
-                    memset(response_flit.data, 0, FLIT_SIZE);
-                    response_flit.valid_len = 0;
-
-                    // Push response flit to send buffer
-                    buffer.Push(response_flit);
-                    current_sequence_no++;
-                }
-                
-                // If all data has been read and TAIL flit has been sent, return to IDLE state
-                if (current_sequence_no >= total_sequence_length) {
-                    assert(!flits_buffer.IsEmpty());
-                    assert(flits_buffer.Front().flit_type == FLIT_TYPE_HEAD);
-                    assert(flits_buffer.Front().cmd == tlm::TLM_READ_COMMAND);
-
-                    state = HBM_IDLE;
-                    flits_buffer.Pop();
-                }
+
+    if (flit.flit_type == FLIT_TYPE_HEAD) {
+        int p = 0;
+        while (p < (int)packets.size() && packets[p].valid)
+            p++;
+
+        if (p == (int)packets.size())
+            return;  // All the packet slots are taken: stall the input
+
+        HBMPacket & packet = packets[p];
+        packet.valid = true;
+        packet.cmd = flit.cmd;
+        packet.addr = flit.addr;
+        packet.len = flit.len;
+        packet.src_id = flit.src_id;
+        packet.dst_id = flit.dst_id;
+        packet.vc_id = flit.vc_id;
+        packet.timestamp = flit.timestamp;
+        packet.hop_no = flit.hop_no;
+        packet.data.resize(flit.len);
+        packet.received = 0;
+        packet.issued = 0;
+        packet.completed = 0;
+        packet.sent = 0;
+        packet.tail_received = false;
+
+        packet_order.push_back(p);
+        vc_packet[flit.vc_id] = p;
+
+        // An empty read is answered straight away
+        if (packet.cmd == tlm::TLM_READ_COMMAND && packet.len == 0)
+            ready_packets.push_back(p);
+    } else {
+        int p = vc_packet[flit.vc_id];
+        assert(p != NOT_VALID);
+        HBMPacket & packet = packets[p];
+
+        if (flit.flit_type == FLIT_TYPE_BODY) {
+            // Body flits of a read request carry no data
+            if (packet.cmd == tlm::TLM_WRITE_COMMAND) {
+                int offset = (flit.sequence_no - 1) * FLIT_SIZE;
+                assert(offset + flit.valid_len <= packet.len);
+                memcpy(&packet.data[offset], flit.data, flit.valid_len);
+                packet.received += flit.valid_len;
             }
-            break;
+        } else {
+            packet.tail_received = true;
+            vc_packet[flit.vc_id] = NOT_VALID;
+
+            // A write is acknowledged once the HBM has taken all its data
+            if (packet.cmd == tlm::TLM_WRITE_COMMAND && packet.completed == packet.len)
+                ready_packets.push_back(p);
+            else if (packet.cmd == tlm::TLM_READ_COMMAND && packet.sent == responseLength(packet))
+                freePacket(p);
+        }
     }
+
+    flits_buffer.Pop();
+}
+
+void HBM_CTRL::issueRequests() {
+    const int burst_size = GlobalParams::hbm_ctrl_burst;
+
+    for (unsigned int i = 0; i < packet_order.size() && n_bursts < (int)bursts.size(); i++) {
+        int p = packet_order[i];
+        HBMPacket & packet = packets[p];
+
+        while (packet.issued < packet.len && n_bursts < (int)bursts.size()) {
+            // Bursts are aligned so that none of them spans two HBM channels
+            int size = min(packet.len - packet.issued, burst_size - (int)((packet.addr + packet.issued) % burst_size));
+
+            // Writes wait for the body flits covering the whole burst
+            if (packet.cmd == tlm::TLM_WRITE_COMMAND && packet.received < packet.issued + size)
+                break;
+
+            int b = 0;
+            while (bursts[b].valid)
+                b++;
+
+            HBMBurst & burst = bursts[b];
+            burst.valid = true;
+            burst.packet = p;
+            burst.offset = packet.issued;
+            burst.trans->set_command(packet.cmd);
+            burst.trans->set_address(packet.addr + packet.issued);
+            burst.trans->set_data_ptr(&packet.data[packet.issued]);
+            burst.trans->set_data_length(size);
+            burst.trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+            packet.issued += size;
+            n_bursts++;
+        }
+    }
+}
+
+void HBM_CTRL::pollRequests() {
+    for (unsigned int b = 0; b < bursts.size() && n_bursts > 0; b++) {
+        HBMBurst & burst = bursts[b];
+        if (!burst.valid)
+            continue;
+
+        // The first call queues the request in the HBM, the following
+        // ones complete it once the HBM has moved its data
+        sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
+        hbm_socket->b_transport(*burst.trans, delay);
+
+        tlm::tlm_response_status status = burst.trans->get_response_status();
+        if (status == tlm::TLM_INCOMPLETE_RESPONSE)
+            continue;
+
+        if (status != tlm::TLM_OK_RESPONSE) {
+            cerr << "Error: " << name() << " HBM access at 0x" << hex << burst.trans->get_address() << dec
+                 << " failed: " << burst.trans->get_response_string() << endl;
+            exit(1);
+        }
+
+        int p = burst.packet;
+        HBMPacket & packet = packets[p];
+        int size = burst.trans->get_data_length();
+
+        packet.completed += size;
+        if (packet.cmd == tlm::TLM_READ_COMMAND) {
+            bytes_read += size;
+            telemetry.reads++;
+        } else {
+            bytes_written += size;
+            telemetry.writes++;
+        }
+
+        burst.valid = false;
+        n_bursts--;
+
+        if (packet.completed == packet.len &&
+            (packet.cmd == tlm::TLM_READ_COMMAND || packet.tail_received))
+            ready_packets.push_back(p);
+    }
+}
+
+void HBM_CTRL::sendResponse() {
+    if (responding == NOT_VALID) {
+        if (ready_packets.empty())
+            return;
+        responding = ready_packets.front();
+        ready_packets.pop_front();
+    }
+
+    // Check if there is enough buffer space for response
+    if (buffer.IsFull())
+        return;
+
+    HBMPacket & packet = packets[responding];
+    int response_length = responseLength(packet);
+
+    Flit response_flit;
+    response_flit.src_id = packet.dst_id;
+    response_flit.dst_id = packet.src_id;
+    response_flit.vc_id = packet.vc_id;
+    response_flit.timestamp = packet.timestamp;
+    response_flit.hop_no = packet.hop_no;
+    response_flit.use_low_voltage_path = false;
+    response_flit.is_broadcast = false;
+    response_flit.is_reduction = false;
+    response_flit.sequence_no = packet.sent;
+    response_flit.sequence_length = response_length;
+
+    // Responses may leave out of order: the request command, address and
+    // length tell the receiver which request they answer
+    response_flit.cmd = packet.cmd;
+    response_flit.addr = packet.addr;
+    response_flit.len = packet.len;
+
+    if (packet.sent == 0)
+        response_flit.flit_type = FLIT_TYPE_HEAD;
+    else if (packet.sent == response_length - 1)
+        response_flit.flit_type = FLIT_TYPE_TAIL;
+    else
+        response_flit.flit_type = FLIT_TYPE_BODY;
+
+    // Only BODY type flit contains actual data read from HBM
+    memset(response_flit.data, 0, FLIT_SIZE);
+    response_flit.valid_len = 0;
+    if (response_flit.flit_type == FLIT_TYPE_BODY) {
+        int offset = (packet.sent - 1) * FLIT_SIZE;
+        response_flit.valid_len = min(packet.len - offset, FLIT_SIZE);
+        memcpy(response_flit.data, &packet.data[offset], response_flit.valid_len);
+    }
+
+    buffer.Push(response_flit);
+    packet.sent++;
+
+    if (packet.sent == response_length) {
+        if (packet.tail_received)
+            freePacket(responding);
+        responding = NOT_VALID;
+    }
+}
+
+int HBM_CTRL::responseLength(const HBMPacket & packet) const {
+    // A read is answered with its data, a write with a HEAD and a TAIL
+    if (packet.cmd == tlm::TLM_READ_COMMAND)
+        return 1 + (packet.len + FLIT_SIZE - 1) / FLIT_SIZE + 1;
+    return 2;
+}
+
+void HBM_CTRL::freePacket(const int p) {
+    packets[p].valid = false;
+    packet_order.erase(find(packet_order.begin(), packet_order.end(), p));
+    packets_served++;
+}
+
+double HBM_CTRL::getThroughput() const {
+    if (cycles == 0)
+        return 0.0;
+
+    return (double)(bytes_read + bytes_written) / cycles;
+}
+
+double HBM_CTRL::getAverageOutstanding() const {
+    if (cycles == 0)
+        return 0.0;
+
+    return (double)outstanding_sum / cycles;
+}
+
+void HBM_CTRL::showStats(std::ostream & out) const {
+    out << local_id << "\t" << packets_served << "\t" << bytes_read << "\t" << bytes_written << "\t"
+        << getThroughput() << "\t" << getAverageOutstanding() << endl;
+}
+
+void HBM_CTRL::serialize(Checkpoint & ckpt) {
+    ckpt.section(name());
+
+    flits_buffer.serialize(ckpt);
+    buffer.serialize(ckpt);
+    ckpt.io(current_level_rx);
+    ckpt.io(current_level_tx);
+    reservation_table.serialize(ckpt);
+    ckpt.io(rng);
+    ckpt.io(telemetry);
+
+    for (unsigned int p = 0; p < packets.size(); p++) {
+        HBMPacket & packet = packets[p];
+        ckpt.io(packet.valid);
+        ckpt.io(packet.cmd);
+        ckpt.io(packet.addr);
+        ckpt.io(packet.len);
+        ckpt.io(packet.src_id);
+        ckpt.io(packet.dst_id);
+        ckpt.io(packet.vc_id);
+        ckpt.io(packet.timestamp);
+        ckpt.io(packet.hop_no);
+        ckpt.io(packet.data);
+        ckpt.io(packet.received);
+        ckpt.io(packet.issued);
+        ckpt.io(packet.completed);
+        ckpt.io(packet.sent);
+        ckpt.io(packet.tail_received);
+    }
+
+    // A request may already be queued in the HBM, which matches the
+    // following attempts by the HBMRequestTag of the slot
+    for (unsigned int b = 0; b < bursts.size(); b++) {
+        HBMBurst & burst = bursts[b];
+        unsigned int length = burst.trans->get_data_length();
+
+        ckpt.io(burst.valid);
+        ckpt.io(burst.packet);
+        ckpt.io(burst.offset);
+        ckpt.io(length);
+
+        if (!ckpt.isSaving() && burst.valid) {
+            HBMPacket & packet = packets[burst.packet];
+            burst.trans->set_command(packet.cmd);
+            burst.trans->set_address(packet.addr + burst.offset);
+            burst.trans->set_data_ptr(&packet.data[burst.offset]);
+            burst.trans->set_data_length(length);
+            burst.trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+        }
+    }
+
+    ckpt.io(packet_order);
+    ckpt.io(ready_packets);
+    ckpt.io(vc_packet);
+    ckpt.io(responding);
+    ckpt.io(n_bursts);
+
+    ckpt.io(bytes_read);
+    ckpt.io(bytes_written);
+    ckpt.io(packets_served);
+    ckpt.io(outstanding_sum);
+    ckpt.io(cycles);
 }
@@ -18,9 +18,13 @@
 #include "GlobalRoutingTable.h"
 #include "LocalRoutingTable.h"
 #include "ReservationTable.h"
+#include "Telemetry.h"
 #include "Utils.h"
 #include <tlm.h>
 #include <tlm_utils/simple_initiator_socket.h>
+#include <deque>
+#include <random>
+#include <vector>
 
 using namespace std;
 
@@ -52,7 +56,50 @@ SC_MODULE(HBM_CTRL)
     bool current_level_rx;	                // Current level for Alternating Bit Protocol (ABP)
     bool current_level_tx;	                // Current level for Alternating Bit Protocol (ABP)
     ReservationTable reservation_table;		// Switch reservation table
+    mt19937 rng;                            // Per-controller random generator
+    HBMTelemetry telemetry;                 // Activity of the current telemetry window
     
+    // Packet being served: write data is coalesced into, and read data
+    // returned from, its data buffer
+    struct HBMPacket {
+        bool valid;
+        tlm::tlm_command cmd;
+        uint64_t addr;
+        int len;
+        int src_id, dst_id, vc_id;
+        double timestamp;
+        int hop_no;
+        vector<uint8_t> data;
+        int received;           // Write bytes received from the body flits
+        int issued;             // Bytes handed to HBM requests
+        int completed;          // Bytes moved by the HBM
+        int sent;               // Response flits pushed
+        bool tail_received;
+    };
+
+    // Outstanding HBM request, covering a burst of a packet
+    struct HBMBurst {
+        bool valid;
+        int packet;
+        int offset;             // Within the packet data
+        tlm::tlm_generic_payload *trans;  // Reused by the requests of this slot
+    };
+
+    vector<HBMPacket> packets;
+    vector<HBMBurst> bursts;
+    deque<int> packet_order;    // Valid packets, in arrival order
+    deque<int> ready_packets;   // Packets to answer, in completion order
+    int vc_packet[MAX_VIRTUAL_CHANNELS];  // Packet being received on each VC
+    int responding;             // Packet whose response is being sent
+    int n_bursts;               // Outstanding HBM requests
+
+    // Statistics
+    unsigned long bytes_read;
+    unsigned long bytes_written;
+    unsigned long packets_served;
+    unsigned long outstanding_sum;  // Outstanding requests summed over the cycles
+    unsigned long cycles;
+
     // Functions
 
     void process();
@@ -60,6 +107,18 @@ SC_MODULE(HBM_CTRL)
     void txProcess();		// The transmitting process
     void configure(const int _id, const unsigned int _max_buffer_size);
     void handleHBM(); 
+    void resetHBM();
+    void acceptFlit();		// Assemble the incoming request packets
+    void issueRequests();	// Split packets into burst sized HBM requests
+    void pollRequests();	// Collect the completed HBM requests
+    void sendResponse();	// Push the next flit of a read response or write ack
+    int responseLength(const HBMPacket & packet) const;
+    void freePacket(const int p);
+
+    double getThroughput() const;   // Bytes/cycle moved to and from the HBM
+    double getAverageOutstanding() const;
+    void showStats(std::ostream & out) const;
+    void serialize(Checkpoint & ckpt);  // Save or restore packets, requests and statistics
 
     // Constructor
 
@@ -375,11 +375,11 @@ void Hub::antennaToTileProcess()
 	for (unsigned int i = 0; i < rxChannels.size(); i++)
 	{
 		int channel = rxChannels[i];
-		vector<pair<int,int> > reservations = antenna2tile_reservation_table.getReservations(channel);
+		int n_reservations = antenna2tile_reservation_table.getReservations(channel, &reservations[0]);
 
-		if (reservations.size()!=0)
+		if (n_reservations!=0)
 		{
-			int rnd_idx = rand()%reservations.size();
+			int rnd_idx = rand()%n_reservations;
 
 			int port = reservations[rnd_idx].first;
 			int vc = reservations[rnd_idx].second;
@@ -549,11 +549,11 @@ void Hub::tileToAntennaProcess()
 	// 2nd phase: Forwarding
 	for (int i = 0; i < num_ports; i++)
 	{
-		vector<pair<int,int> > reservations = tile2antenna_reservation_table.getReservations(i);
+		int n_reservations = tile2antenna_reservation_table.getReservations(i, &reservations[0]);
 
-		if (reservations.size()!=0)
+		if (n_reservations!=0)
 		{
-			int rnd_idx = rand()%reservations.size();
+			int rnd_idx = rand()%n_reservations;
 
 			int o = reservations[rnd_idx].first;
 			int vc = reservations[rnd_idx].second;
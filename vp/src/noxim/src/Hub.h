@@ -71,6 +71,7 @@ SC_MODULE(Hub)
 
     ReservationTable antenna2tile_reservation_table;	// Switch reservation table
     ReservationTable tile2antenna_reservation_table;// Wireless reservation table
+    vector<pair<int,int> > reservations; // Output of getReservations, sized for both tables
 
     void updateRxPower();
     void updateTxPower();
@@ -122,6 +123,7 @@ SC_MODULE(Hub)
 	//tile2antenna_reservation_table.setSize(txChannels.size());
 #define STATIC_MAX_CHANNELS 100
       tile2antenna_reservation_table.setSize(STATIC_MAX_CHANNELS);
+	reservations.resize(max(num_ports, STATIC_MAX_CHANNELS));
 
         flit_rx = new sc_in<Flit>[num_ports];
         req_rx = new sc_in<bool>[num_ports];
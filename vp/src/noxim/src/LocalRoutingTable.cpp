@@ -12,25 +12,21 @@
 
 LocalRoutingTable::LocalRoutingTable()
 {
+    rtable = NULL;
 }
 
-void LocalRoutingTable::configure(GlobalRoutingTable & rtable,
+void LocalRoutingTable::configure(GlobalRoutingTable & _rtable,
 				       const int _node_id)
 {
-    rt_node = rtable.getNodeRoutingTable(_node_id);
+    rtable = &_rtable;
     node_id = _node_id;
 }
 
-AdmissibleOutputs LocalRoutingTable::
-getAdmissibleOutputs(const LinkId & in_link, const int destination_id)
-{
-    return rt_node[in_link][destination_id];
-}
-
 AdmissibleOutputs LocalRoutingTable::
 getAdmissibleOutputs(const int in_direction, const int destination_id)
 {
-    LinkId lid = direction2ILinkId(node_id, in_direction);
+    assert(rtable != NULL);
 
-    return getAdmissibleOutputs(lid, destination_id);
+    return rtable->getAdmissibleOutputs(node_id, in_direction,
+					destination_id);
 }
@@ -21,16 +21,10 @@ class LocalRoutingTable {
     // Constructor
     LocalRoutingTable();
 
-    // Extracts the routing table of node _node_id from the global
+    // Binds the routing table of node _node_id from the global
     // routing table rtable
     void configure(GlobalRoutingTable & rtable, const int _node_id);
 
-    // Returns the set of admissible output channels for destination
-    // destination_id and input channel in_link
-    AdmissibleOutputs getAdmissibleOutputs(const LinkId &
-						in_link,
-						const int destination_id);
-
     // Returns the set of admissible output channels for a destination
     // destination_id and a given input direction
     AdmissibleOutputs getAdmissibleOutputs(const int in_direction,
@@ -38,7 +32,7 @@ class LocalRoutingTable {
 
   private:
 
-     RoutingTableNode rt_node;
+    GlobalRoutingTable *rtable;
     int node_id;
 };
 
@@ -10,6 +10,8 @@
 
 #include "NIU.h"
 
+#include "Checkpoint.h"
+
 Flit NIU::make_flit(int src_id, int dst_id, int vc_id, FlitType flit_type, int sequence_no, int sequence_length, Header &header) {
     Flit flit;
     flit.src_id = src_id;
@@ -30,15 +32,39 @@ Flit NIU::make_flit(int src_id, int dst_id, int vc_id, FlitType flit_type, int s
     return flit;
 }
 
+int NIU::hbmDestinationFor(const Header &header) {
+    int edge = -header.hbm_id - 1;
+    assert(edge >= 0 && edge < HBM_EDGES);
+
+    if (GlobalParams::hbm_ctrl_mapping != HBM_CTRL_CHANNEL)
+        return hbmDestination(edge, NOT_VALID);
+
+    // Controller i of the edge serves the channels c with c % edge length == i
+    uint32_t channel;
+    uint64_t offset;
+    hbm_map.map(header.addr, channel, offset);
+    return hbmDestination(edge, channel % hbmEdgeLength(edge));
+}
+
 void NIU::b_transport(tlm_generic_payload& trans, sc_time& delay) {
-    if (tx_state != TxState::Tx_WAIT) {
+    if (tx_state != TxState::Tx_WAIT || has_dma) {
         trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
         return;
     }
 
+    // The header stays with the DMA: keep a copy of it and of the data it
+    // points to, a read request has none
     uint8_t* data_ptr = trans.get_data_ptr();
     memcpy(&dma_trans, data_ptr, sizeof(Header));
-    memcpy(&dma_buffer, dma_trans.data, dma_trans.len);
+    if (dma_trans.cmd == tlm::TLM_WRITE_COMMAND)
+        dma_buffer.assign(dma_trans.data, dma_trans.data + dma_trans.len);
+    else
+        dma_buffer.clear();
+    dma_trans.data = dma_buffer.data();
+
+    has_dma = true;
+    has_local_trans = true;
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
 }
 
 void NIU::broadcast_process() {
@@ -101,11 +127,10 @@ void NIU::broadcast_process() {
             trans.set_data_ptr(broadcast_buffer.data());
             
             // isock->b_transport(trans, delay);
-            printf("%d: ", local_id);
-            for (int i = 0; i < broadcast_buffer.size(); i++) {
-                printf("%c", broadcast_buffer[i]);
+            if (GlobalParams::verbose_mode == VERBOSE_HIGH) {
+                LOG << "broadcast 0x" << hex << broadcast_head.addr << dec << " [" << broadcast_buffer.size() << "]: "
+                    << string(broadcast_buffer.begin(), broadcast_buffer.end()) << endl;
             }
-            printf("\n");
             
             // if (trans.get_response_status() == tlm::TLM_OK_RESPONSE) {
             //     broadcast_state = broadcast_WAIT;
@@ -168,6 +193,35 @@ void NIU::rx_process() {
             tlm_generic_payload trans;
             sc_time delay = SC_ZERO_TIME;
 
+            // Write acknowledgement of an HBM controller: nothing to deliver
+            if (head_flit.src_id < 0 && head_flit.cmd == tlm::TLM_WRITE_COMMAND) {
+                rx_state = Rx_WAIT;
+                break;
+            }
+
+            // Read response of an HBM controller: the data goes to the DMA
+            // that asked for it, once it can take it
+            if (head_flit.src_id < 0) {
+                assert(head_flit.cmd == tlm::TLM_READ_COMMAND);
+                assert(head_flit.len == router_buffer.size());
+
+                trans.set_command(tlm::TLM_READ_COMMAND);
+                trans.set_address(head_flit.addr);
+                trans.set_data_length(head_flit.len);
+                trans.set_data_ptr(router_buffer.data());
+                trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+                isock->b_transport(trans, delay);
+                if (GlobalParams::verbose_mode == VERBOSE_HIGH) {
+                    LOG << "read 0x" << hex << head_flit.addr << dec << " [" << router_buffer.size() << "]: "
+                        << string(router_buffer.begin(), router_buffer.end()) << endl;
+                }
+
+                if (trans.get_response_status() == tlm::TLM_OK_RESPONSE)
+                    rx_state = Rx_WAIT;
+                break;
+            }
+
             assert(head_flit.cmd == tlm::TLM_WRITE_COMMAND);
             assert(head_flit.len == router_buffer.size());
             
@@ -177,11 +231,10 @@ void NIU::rx_process() {
             trans.set_data_ptr(router_buffer.data());
             
             // isock->b_transport(trans, delay);
-            printf("%d: ", local_id);
-            for (int i = 0; i < router_buffer.size(); i++) {
-                printf("%c", router_buffer[i]);
+            if (GlobalParams::verbose_mode == VERBOSE_HIGH) {
+                LOG << "write 0x" << hex << head_flit.addr << dec << " [" << router_buffer.size() << "]: "
+                    << string(router_buffer.begin(), router_buffer.end()) << endl;
             }
-            printf("\n");
             
             // if (trans.get_response_status() == tlm::TLM_OK_RESPONSE) {
             //     rx_state = Rx_WAIT;
@@ -212,7 +265,9 @@ void NIU::tx_process() {
         }
         
         case Tx_DECOMPOSE: {
-            if (local_id == 16) {
+            if (has_local_trans) {
+                has_local_trans = false;
+            } else if (local_id == 16) {
                 dma_trans.dst_id = 31;
                 dma_trans.hbm_id = 0;
                 dma_trans.cmd = tlm::TLM_WRITE_COMMAND;
@@ -229,12 +284,13 @@ void NIU::tx_process() {
                 break;
             }
 
-            int dst_id = dma_trans.dst_id;
-            int sequence_length = (dma_trans.len + FLIT_SIZE - 1) / FLIT_SIZE + 2;  // HEAD + BODY + TAIL
+            int dst_id = dma_trans.hbm_id != 0 ? hbmDestinationFor(dma_trans) : dma_trans.dst_id;
+            // A read request is a HEAD and a TAIL, the data comes back in the response
+            int remaining_len = dma_trans.cmd == tlm::TLM_WRITE_COMMAND ? dma_trans.len : 0;
+            int sequence_length = (remaining_len + FLIT_SIZE - 1) / FLIT_SIZE + 2;  // HEAD + BODY + TAIL
             Flit head_flit = make_flit(local_id, dst_id, 0, FLIT_TYPE_HEAD, 0, sequence_length, dma_trans);
             flit_queue.push(head_flit);
 
-            int remaining_len = dma_trans.len;
             int offset = 0;
             int seq_no = 1;
             while (remaining_len > 0) {
@@ -274,3 +330,34 @@ void NIU::tx_process() {
         }
     }
 }
+
+void NIU::serialize(Checkpoint &ckpt) {
+    ckpt.section(name());
+
+    ckpt.io(current_level_rx);
+    ckpt.io(current_level_tx);
+    ckpt.io(current_level_broadcast);
+    ckpt.io(head_flit);
+    ckpt.io(router_buffer);
+    ckpt.io(broadcast_head);
+    ckpt.io(broadcast_buffer);
+    ckpt.io(has_dma);
+    ckpt.io(has_local_trans);
+
+    // The payload of a DMA transaction has been split into flits by now
+    ckpt.io(dma_trans.dst_id);
+    ckpt.io(dma_trans.hbm_id);
+    ckpt.io(dma_trans.cmd);
+    ckpt.io(dma_trans.addr);
+    ckpt.io(dma_trans.len);
+    ckpt.io(dma_trans.is_broadcast);
+    ckpt.io(dma_trans.is_reduction);
+    ckpt.io(dma_buffer);
+    if (!ckpt.isSaving())
+        dma_trans.data = dma_buffer.data();
+    ckpt.io(flit_queue);
+
+    ckpt.io(rx_state);
+    ckpt.io(tx_state);
+    ckpt.io(broadcast_state);
+}
@@ -20,11 +20,14 @@
 
 #include "DataStructs.h"
 #include "GlobalTrafficTable.h"
+#include "HBMAddressMap.h"
 #include "Utils.h"
 
 using namespace std;
 using namespace tlm;
 
+class Checkpoint;
+
 enum RxState {
     Rx_IDLE,
     Rx_WAIT,
@@ -82,9 +85,11 @@ SC_MODULE(NIU) {
 
     // Used for transaction from DMA Ctrl
     bool has_dma;   
+    bool has_local_trans;             // dma_trans was sent by the DMA Ctrl
     Header dma_trans;
-    vector<uint8_t> dma_buffer;
+    vector<uint8_t> dma_buffer;       // Data of dma_trans
     queue<Flit> flit_queue;
+    HBMAddressMap hbm_map;            // Channel of an HBM address, see hbmDestinationFor()
 
 	tlm_utils::simple_target_socket<NIU> tsock; // target socket for DMA Ctrl
 	tlm_utils::simple_initiator_socket<NIU> isock; // initiator socket for DMA Ctrl
@@ -94,6 +99,8 @@ SC_MODULE(NIU) {
     BroadcastState broadcast_state;
 
     Flit make_flit(int src_id, int dst_id, int vc_id, FlitType flit_type, int sequence_no, int sequence_length, Header &header);
+    int hbmDestinationFor(const Header &header);
+    void serialize(Checkpoint &ckpt);  // Save or restore the state machines
 
     void rx_process();
     void tx_process();
@@ -107,6 +114,9 @@ SC_MODULE(NIU) {
         tx_state = TxState::Tx_IDLE;
 
         has_dma = true;
+        has_local_trans = false;
+
+        hbm_map.configure(HBM_MEMORY_SIZE, HBM_CHANNELS, HBM_INTERLEAVE_SIZE);
 
 		SC_METHOD(rx_process);
 		sensitive << reset;
@@ -9,6 +9,7 @@
  */
 
 #include "NoC.h"
+#include "Checkpoint.h"
 
 using namespace std;
 
@@ -1977,35 +1978,30 @@ void NoC::buildMesh() {
 		t[i] = new Tile *[GlobalParams::mesh_dim_y];
 	}
 
-    hbm = new HBM("HBM");
-    hbm_ctrl = new HBM_CTRL * [GlobalParams::mesh_dim_y];
-    for (int i = 0; i < GlobalParams::mesh_dim_y; i++) {
-        // Create HBM controller
-        string hbm_ctrl_name = "HBM_CTRL_" + to_string(i);
-        hbm_ctrl[i] = new HBM_CTRL(hbm_ctrl_name.c_str());
+	// HBM stacks on the edges listed in hbm_edges, with one controller per
+	// row (WEST/EAST) or column (NORTH/SOUTH) of the edge
+	for (unsigned int e = 0; e < GlobalParams::hbm_edges.size(); e++) {
+		const string & edge_name = GlobalParams::hbm_edges[e];
+		int edge = hbmEdgeId(edge_name);
 
-        // Map clock and reset
-        hbm_ctrl[i]->clock(clock);
-        hbm_ctrl[i]->reset(reset);
+		string hbm_name = "HBM_" + edge_name;
+		HBM *stack = new HBM(hbm_name.c_str());
+		stack->clock(clock);
+		hbm.push_back(stack);
 
-        // Map Rx signals
-        hbm_ctrl[i]->req_rx(req[0][i].west);
-        hbm_ctrl[i]->flit_rx(flit[0][i].west);
-        hbm_ctrl[i]->ack_rx(ack[0][i].east);
-        hbm_ctrl[i]->buffer_full_status_rx(buffer_full_status[0][i].east);
+		for (int i = 0; i < hbmEdgeLength(edge); i++) {
+			string hbm_ctrl_name = "HBM_CTRL_" + edge_name + "_" + to_string(i);
+			HBM_CTRL *ctrl = new HBM_CTRL(hbm_ctrl_name.c_str());
 
-        // Map Tx signals
-        hbm_ctrl[i]->req_tx(req[0][i].east);
-        hbm_ctrl[i]->flit_tx(flit[0][i].east);
-        hbm_ctrl[i]->ack_tx(ack[0][i].west);
-        hbm_ctrl[i]->buffer_full_status_tx(buffer_full_status[0][i].west);
+			ctrl->clock(clock);
+			ctrl->reset(reset);
+			attachHBMController(ctrl, edge, i);
+			ctrl->hbm_socket.bind(stack->targ_socket[i]);
+			ctrl->configure(hbm_ctrl.size(), GlobalParams::buffer_depth);
 
-        // Map HBM socket
-        hbm_ctrl[i]->hbm_socket.bind(hbm->targ_socket[i]);
-
-        // Configure HBM controller
-        hbm_ctrl[i]->configure(i, GlobalParams::buffer_depth);
-    }
+			hbm_ctrl.push_back(ctrl);
+		}
+	}
 
 	// Create the mesh as a matrix of tiles
 	for (int j = 0; j < GlobalParams::mesh_dim_y; j++) {
@@ -2181,6 +2177,62 @@ void NoC::buildMesh() {
 	}
 }
 
+void NoC::attachHBMController(HBM_CTRL * ctrl, const int edge, const int i) {
+	// The controller takes the place of the missing neighbour of the
+	// border router, driving the signals that neighbour would drive
+	int X = GlobalParams::mesh_dim_x;
+	int Y = GlobalParams::mesh_dim_y;
+
+	switch (edge) {
+		case HBM_EDGE_WEST:
+			ctrl->req_rx(req[0][i].west);
+			ctrl->flit_rx(flit[0][i].west);
+			ctrl->ack_rx(ack[0][i].east);
+			ctrl->buffer_full_status_rx(buffer_full_status[0][i].east);
+			ctrl->req_tx(req[0][i].east);
+			ctrl->flit_tx(flit[0][i].east);
+			ctrl->ack_tx(ack[0][i].west);
+			ctrl->buffer_full_status_tx(buffer_full_status[0][i].west);
+			break;
+
+		case HBM_EDGE_EAST:
+			ctrl->req_rx(req[X][i].east);
+			ctrl->flit_rx(flit[X][i].east);
+			ctrl->ack_rx(ack[X][i].west);
+			ctrl->buffer_full_status_rx(buffer_full_status[X][i].west);
+			ctrl->req_tx(req[X][i].west);
+			ctrl->flit_tx(flit[X][i].west);
+			ctrl->ack_tx(ack[X][i].east);
+			ctrl->buffer_full_status_tx(buffer_full_status[X][i].east);
+			break;
+
+		case HBM_EDGE_NORTH:
+			ctrl->req_rx(req[i][0].north);
+			ctrl->flit_rx(flit[i][0].north);
+			ctrl->ack_rx(ack[i][0].south);
+			ctrl->buffer_full_status_rx(buffer_full_status[i][0].south);
+			ctrl->req_tx(req[i][0].south);
+			ctrl->flit_tx(flit[i][0].south);
+			ctrl->ack_tx(ack[i][0].north);
+			ctrl->buffer_full_status_tx(buffer_full_status[i][0].north);
+			break;
+
+		case HBM_EDGE_SOUTH:
+			ctrl->req_rx(req[i][Y].south);
+			ctrl->flit_rx(flit[i][Y].south);
+			ctrl->ack_rx(ack[i][Y].north);
+			ctrl->buffer_full_status_rx(buffer_full_status[i][Y].north);
+			ctrl->req_tx(req[i][Y].north);
+			ctrl->flit_tx(flit[i][Y].north);
+			ctrl->ack_tx(ack[i][Y].south);
+			ctrl->buffer_full_status_tx(buffer_full_status[i][Y].south);
+			break;
+
+		default:
+			assert(false);
+	}
+}
+
 Tile *NoC::searchNode(const int id) const {
 	if (GlobalParams::topology == TOPOLOGY_MESH) {
 		for (int i = 0; i < GlobalParams::mesh_dim_x; i++)
@@ -2192,6 +2244,36 @@ Tile *NoC::searchNode(const int id) const {
 	return NULL;
 }
 
+void NoC::serialize(Checkpoint & ckpt) {
+	assert(GlobalParams::topology == TOPOLOGY_MESH);
+
+	for (int j = 0; j < GlobalParams::mesh_dim_y; j++)
+		for (int i = 0; i < GlobalParams::mesh_dim_x; i++) {
+			t[i][j]->r->serialize(ckpt);
+			t[i][j]->niu->serialize(ckpt);
+		}
+	for (unsigned int i = 0; i < hbm.size(); i++)
+		hbm[i]->serialize(ckpt);
+	for (unsigned int i = 0; i < hbm_ctrl.size(); i++)
+		hbm_ctrl[i]->serialize(ckpt);
+
+	ckpt.signals(this);
+}
+
+void NoC::reconfigure() {
+	assert(GlobalParams::topology == TOPOLOGY_MESH);
+
+	for (int j = 0; j < GlobalParams::mesh_dim_y; j++)
+		for (int i = 0; i < GlobalParams::mesh_dim_x; i++) {
+			Router *r = t[i][j]->r;
+			r->configure(r->local_id, GlobalParams::stats_warm_up_time, GlobalParams::buffer_depth, grtable);
+			r->power.configureRouter(GlobalParams::flit_size, GlobalParams::buffer_depth, GlobalParams::flit_size,
+			                         string(GlobalParams::routing_algorithm), "default");
+		}
+	for (unsigned int i = 0; i < hbm_ctrl.size(); i++)
+		hbm_ctrl[i]->configure(hbm_ctrl[i]->local_id, GlobalParams::buffer_depth);
+}
+
 void NoC::asciiMonitor() {
 	// cout << sc_time_stamp().to_double()/GlobalParams::clock_period_ps << endl;
 	system("clear");
@@ -2217,3 +2299,126 @@ void NoC::asciiMonitor() {
 		}
 	}
 }
+
+void NoC::collectRouters() {
+	if (!routers.empty())
+		return;
+
+	if (GlobalParams::topology == TOPOLOGY_MESH) {
+		for (int j = 0; j < GlobalParams::mesh_dim_y; j++)
+			for (int i = 0; i < GlobalParams::mesh_dim_x; i++) routers.push_back(t[i][j]->r);
+	} else  // other delta topologies
+		for (int i = 0; i < GlobalParams::n_delta_tiles; i++) routers.push_back(core[i]->r);
+}
+
+void NoC::buildPartitions() {
+	// Stripes of consecutive rows, one per thread
+	collectRouters();
+
+	int n_partitions = min(GlobalParams::noc_threads, (int)routers.size());
+	for (int p = 0; p <= n_partitions; p++) partition_start.push_back(p * routers.size() / n_partitions);
+
+	worker_pool = new WorkerPool(n_partitions);
+}
+
+void NoC::parallelStep() {
+	if (reset.read()) {
+		for (unsigned int i = 0; i < routers.size(); i++) {
+			routers[i]->process();
+			routers[i]->perCycleUpdate();
+		}
+		return;
+	}
+
+	// Reservation and forwarding only read input ports and touch
+	// router-local state, the flits to send are held by the routers: the
+	// partitions can be evaluated concurrently. The outcome does not depend
+	// on the number of threads since every router draws from its own
+	// random generator.
+	worker_pool->run([this](int p) {
+		for (int i = partition_start[p]; i < partition_start[p + 1]; i++) {
+			routers[i]->txReservation();
+			routers[i]->txForwarding();
+		}
+	});
+
+	// Writing to sc_signals is not thread safe: the output ports are
+	// driven and the rest of the cycle is evaluated sequentially
+	for (unsigned int i = 0; i < routers.size(); i++) {
+		routers[i]->driveOutputs();
+		routers[i]->rxProcess();
+		routers[i]->perCycleUpdate();
+	}
+}
+
+void NoC::buildTelemetry() {
+	static const char *port_names[DIRECTIONS + 2] = {"N", "E", "S", "W", "L", "H"};
+
+	collectRouters();
+
+	vector<string> router_columns;
+	for (int d = 0; d < DIRECTIONS + 2; d++) router_columns.push_back(string("buf_") + port_names[d]);
+	router_columns.push_back("routed");
+	for (int d = 0; d < DIRECTIONS + 2; d++) router_columns.push_back(string("link_") + port_names[d]);
+	for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+		router_columns.push_back("stall_vc" + i_to_string(vc));
+
+	vector<string> hbm_columns;
+	hbm_columns.push_back("rx_flits");
+	hbm_columns.push_back("tx_flits");
+	hbm_columns.push_back("reads");
+	hbm_columns.push_back("writes");
+	hbm_columns.push_back("buffered");
+
+	// HBM controllers are only attached to the mesh
+	int n_hbm = hbm_ctrl.size();
+
+	telemetry = new Telemetry(GlobalParams::telemetry_filename, GlobalParams::telemetry_format,
+	                          GlobalParams::telemetry_period, routers.size(), router_columns, n_hbm, hbm_columns);
+}
+
+void NoC::telemetryProcess() {
+	if (reset.read())
+		return;
+
+	long cycle = (long)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps) - GlobalParams::reset_time;
+	if (cycle <= 0 || cycle % GlobalParams::telemetry_period != 0)
+		return;
+
+	// Only the sampling happens here, files are written by the telemetry thread
+	TelemetrySnapshot *snapshot = telemetry->acquire(cycle);
+
+	int n = routers.size();
+	for (int r = 0; r < n; r++) {
+		RouterTelemetry &rt = routers[r]->telemetry;
+		int col = 0;
+
+		for (int d = 0; d < DIRECTIONS + 2; d++, col++) {
+			unsigned int occupancy = 0;
+			for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+				occupancy += routers[r]->buffer[d][vc].Size();
+			snapshot->routers[col * n + r] = occupancy;
+		}
+		snapshot->routers[col++ * n + r] = rt.routed_flits;
+		for (int d = 0; d < DIRECTIONS + 2; d++, col++) snapshot->routers[col * n + r] = rt.tx_flits[d];
+		for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++, col++)
+			snapshot->routers[col * n + r] = rt.vc_stalls[vc];
+
+		rt.clear();
+	}
+
+	int n_hbm = telemetry->getHBMCount();
+	for (int h = 0; h < n_hbm; h++) {
+		HBMTelemetry &ht = hbm_ctrl[h]->telemetry;
+
+		snapshot->hbm[0 * n_hbm + h] = ht.rx_flits;
+		snapshot->hbm[1 * n_hbm + h] = ht.tx_flits;
+		snapshot->hbm[2 * n_hbm + h] = ht.reads;
+		snapshot->hbm[3 * n_hbm + h] = ht.writes;
+		snapshot->hbm[4 * n_hbm + h] = hbm_ctrl[h]->flits_buffer.Size() + hbm_ctrl[h]->buffer.Size();
+
+		ht.clear();
+	}
+
+	telemetry->push(snapshot);
+}
@@ -20,6 +20,8 @@
 #include "TokenRing.h"
 #include "HBM_Ctrl.h"
 #include "HBM.h"
+#include "WorkerPool.h"
+#include "Telemetry.h"
 
 using namespace std;
 
@@ -85,14 +87,22 @@ SC_MODULE(NoC)
 
     TokenRing* token_ring;
 
-    // HBM Controller
-    HBM *hbm;
-    HBM_CTRL ** hbm_ctrl;
+    // HBM stacks, one for each edge in hbm_edges, and their controllers
+    vector<HBM *> hbm;
+    vector<HBM_CTRL *> hbm_ctrl;
 
     // Global tables
     GlobalRoutingTable grtable;
     GlobalTrafficTable gttable;
 
+    // Parallel evaluation of the routers (noc_threads > 1)
+    WorkerPool *worker_pool;
+    vector<Router *> routers;           // Routers sorted by local_id
+    vector<int> partition_start;        // partition p spans routers [start[p], start[p+1])
+
+    // Periodic sampling of the NoC activity (telemetry_period > 0)
+    Telemetry *telemetry;
+
 
     // Constructor
 
@@ -117,6 +127,25 @@ SC_MODULE(NoC)
 	// out of yaml configuration (experimental features)
 	//GlobalParams::channel_selection = CHSEL_FIRST_FREE;
 
+	worker_pool = NULL;
+	if (GlobalParams::noc_threads > 1)
+	{
+	    buildPartitions();
+
+	    SC_METHOD(parallelStep);
+	    sensitive << reset;
+	    sensitive << clock.pos();
+	}
+
+	telemetry = NULL;
+	if (GlobalParams::telemetry_period > 0)
+	{
+	    buildTelemetry();
+
+	    SC_METHOD(telemetryProcess);
+	    sensitive << clock.pos();
+	}
+
 	if (GlobalParams::ascii_monitor)
 	{
 	    SC_METHOD(asciiMonitor);
@@ -128,14 +157,28 @@ SC_MODULE(NoC)
     // Support methods
     Tile *searchNode(const int id) const;
 
+    // Save or restore the state of routers, NIUs, HBM stacks and
+    // controllers and the values of the signals between them
+    void serialize(Checkpoint & ckpt);
+
+    // Apply the buffer, statistics and HBM controller parameters again,
+    // to the network still empty at the end of reset (sweep runs)
+    void reconfigure();
+
   private:
 
     void buildMesh();
+    void attachHBMController(HBM_CTRL * ctrl, const int edge, const int i);
     void buildButterfly();
     void buildBaseline();
     void buildOmega();
     void buildCommon();
     void asciiMonitor();
+    void collectRouters();
+    void buildPartitions();
+    void parallelStep();
+    void buildTelemetry();
+    void telemetryProcess();
     int * hub_connected_ports;
 };
 
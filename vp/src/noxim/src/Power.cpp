@@ -10,6 +10,8 @@
 
 #include <iostream>
 #include "Power.h"
+#include "Checkpoint.h"
+#include "PowerModel.h"
 #include "Utils.h"
 #include "systemc.h"
 
@@ -69,9 +71,20 @@ Power::Power()
     ni_pwr_s = 0.0;
 
 
+    attenuation_map = NULL;
+
     sleep_end_cycle = NOT_VALID;
 
     initPowerBreakdown();
+
+    for (int i = 0; i < NO_BREAKDOWN_ENTRIES_D; i++)
+	events_d[i] = 0;
+    for (int i = 0; i < NO_BREAKDOWN_ENTRIES_S; i++)
+	events_s[i] = 0;
+    router_leakage_cycles = 0;
+    router_buffers = 0;
+
+    updateEventEnergies();
 }
 
 void Power::configureRouter(int link_width,
@@ -80,60 +93,59 @@ void Power::configureRouter(int link_width,
 	string routing_function,
 	string selection_function)
 {
-// (s)tatic, (d)ynamic power
+    // energy accumulated so far is computed with the previous values
+    fold();
 
-    // Buffer 
-    pair<int,int> key = pair<int,int>(buffer_depth, buffer_item_size);
-    
-    assert(GlobalParams::power_configuration.bufferPowerConfig.leakage.find(key) != GlobalParams::power_configuration.bufferPowerConfig.leakage.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.push.find(key) != GlobalParams::power_configuration.bufferPowerConfig.push.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.front.find(key) != GlobalParams::power_configuration.bufferPowerConfig.front.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.pop.find(key) != GlobalParams::power_configuration.bufferPowerConfig.pop.end());
+// (s)tatic, (d)ynamic power
 
     // Dynamic values are expressed in Joule
     // Static/Leakage values must be converted from Watt to Joule
 
-    buffer_router_pwr_s = W2J(GlobalParams::power_configuration.bufferPowerConfig.leakage[key]);
-    buffer_router_push_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.push[key];
-    buffer_router_front_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.front[key];
-    buffer_router_pop_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.pop[key];
+    // Buffer 
+    BufferEnergy buffer = PowerModel::buffer(buffer_depth, buffer_item_size);
+
+    buffer_router_pwr_s = W2J(buffer.leakage);
+    buffer_router_push_pwr_d = buffer.push;
+    buffer_router_front_pwr_d = buffer.front;
+    buffer_router_pop_pwr_d = buffer.pop;
 
     // Routing 
-    assert(GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm.find(routing_function) != GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm.end());
+    pair<double, double> routing = PowerModel::routing(routing_function);
 
-    routing_pwr_s = W2J(GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm[routing_function].first);
-    routing_pwr_d = GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm[routing_function].second;
+    routing_pwr_s = W2J(routing.first);
+    routing_pwr_d = routing.second;
 
     // Selection 
-    assert(GlobalParams::power_configuration.routerPowerConfig.selection_strategy_pm.find(selection_function) != GlobalParams::power_configuration.routerPowerConfig.selection_strategy_pm.end());
+    pair<double, double> selection = PowerModel::selection(selection_function);
 
-    selection_pwr_s = W2J(GlobalParams::power_configuration.routerPowerConfig.selection_strategy_pm[selection_function].first);
-    selection_pwr_d = GlobalParams::power_configuration.routerPowerConfig.selection_strategy_pm[selection_function].second;
+    selection_pwr_s = W2J(selection.first);
+    selection_pwr_d = selection.second;
 
     // CrossBar
     // TODO future work: tuning of crossbar radix
-    pair<int,int> xbar_k = pair<int,int>(5,GlobalParams::flit_size);
-    assert(GlobalParams::power_configuration.routerPowerConfig.crossbar_pm.find(xbar_k) != GlobalParams::power_configuration.routerPowerConfig.crossbar_pm.end());
-    crossbar_pwr_s = W2J(GlobalParams::power_configuration.routerPowerConfig.crossbar_pm[xbar_k].first);
-    crossbar_pwr_d = GlobalParams::power_configuration.routerPowerConfig.crossbar_pm[xbar_k].second;
+    pair<double, double> xbar = PowerModel::crossbar(5, GlobalParams::flit_size);
+    crossbar_pwr_s = W2J(xbar.first);
+    crossbar_pwr_d = xbar.second;
     
     // NetworkInterface
-    ni_pwr_s = W2J(GlobalParams::power_configuration.routerPowerConfig.network_interface[GlobalParams::flit_size].first);
-    ni_pwr_d = GlobalParams::power_configuration.routerPowerConfig.network_interface[GlobalParams::flit_size].second;
+    pair<double, double> ni = PowerModel::networkInterface(GlobalParams::flit_size);
+    ni_pwr_s = W2J(ni.first);
+    ni_pwr_d = ni.second;
 
     // Link 
     // Router has both type of links
-    double length_r2h = GlobalParams::r2h_link_length;
-    double length_r2r = GlobalParams::r2r_link_length;
-    
-    assert(GlobalParams::power_configuration.linkBitLinePowerConfig.find(length_r2r)!=GlobalParams::power_configuration.linkBitLinePowerConfig.end());
-    assert(GlobalParams::power_configuration.linkBitLinePowerConfig.find(length_r2h)!=GlobalParams::power_configuration.linkBitLinePowerConfig.end());
+    pair<double, double> link_r2r = PowerModel::linkBitLine(GlobalParams::r2r_link_length);
+    pair<double, double> link_r2h = PowerModel::linkBitLine(GlobalParams::r2h_link_length);
 
+    link_r2r_pwr_s= W2J(link_width * link_r2r.first);
+    link_r2r_pwr_d= link_width * link_r2r.second;
+    link_r2h_pwr_s= W2J(link_width * link_r2h.first);
+    link_r2h_pwr_d= link_width * link_r2h.second;
 
-    link_r2r_pwr_s= W2J(link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2r].first);
-    link_r2r_pwr_d= link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2r].second;
-    link_r2h_pwr_s= W2J(link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2h].first);
-    link_r2h_pwr_d= link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2h].second;
+    // leaking input buffers: one per virtual channel of each direction
+    router_buffers = (DIRECTIONS + 1) * GlobalParams::n_virtual_channels;
+
+    updateEventEnergies();
 }
 
 void Power::configureHub(int link_width,
@@ -145,65 +157,36 @@ void Power::configureHub(int link_width,
 	int antenna_buffer_item_size,
 	int data_rate_gbs)
 {
+    // energy accumulated so far is computed with the previous values
+    fold();
+
 // (s)tatic, (d)ynamic power
 
     // Buffer 
-    pair<int,int> key_to_tile = pair<int,int>(buffer_to_tile_depth, buffer_item_size);
-    pair<int,int> key_from_tile = pair<int,int>(buffer_from_tile_depth, buffer_item_size);
-    
-    assert(GlobalParams::power_configuration.bufferPowerConfig.leakage.find(key_to_tile) != GlobalParams::power_configuration.bufferPowerConfig.leakage.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.push.find(key_to_tile) != GlobalParams::power_configuration.bufferPowerConfig.push.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.front.find(key_to_tile) != GlobalParams::power_configuration.bufferPowerConfig.front.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.pop.find(key_to_tile) != GlobalParams::power_configuration.bufferPowerConfig.pop.end());
-
-    assert(GlobalParams::power_configuration.bufferPowerConfig.leakage.find(key_from_tile) != GlobalParams::power_configuration.bufferPowerConfig.leakage.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.push.find(key_from_tile) != GlobalParams::power_configuration.bufferPowerConfig.push.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.front.find(key_from_tile) != GlobalParams::power_configuration.bufferPowerConfig.front.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.pop.find(key_from_tile) != GlobalParams::power_configuration.bufferPowerConfig.pop.end());
-
-    buffer_to_tile_pwr_s = W2J(GlobalParams::power_configuration.bufferPowerConfig.leakage[key_to_tile]);
-    buffer_to_tile_push_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.push[key_to_tile];
-    buffer_to_tile_front_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.front[key_to_tile];
-    buffer_to_tile_pop_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.pop[key_to_tile];
-
-    buffer_from_tile_pwr_s = W2J(GlobalParams::power_configuration.bufferPowerConfig.leakage[key_from_tile]);
-    buffer_from_tile_push_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.push[key_from_tile];
-    buffer_from_tile_front_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.front[key_from_tile];
-    buffer_from_tile_pop_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.pop[key_from_tile];
+    BufferEnergy to_tile = PowerModel::buffer(buffer_to_tile_depth, buffer_item_size);
+    BufferEnergy from_tile = PowerModel::buffer(buffer_from_tile_depth, buffer_item_size);
+
+    buffer_to_tile_pwr_s = W2J(to_tile.leakage);
+    buffer_to_tile_push_pwr_d = to_tile.push;
+    buffer_to_tile_front_pwr_d = to_tile.front;
+    buffer_to_tile_pop_pwr_d = to_tile.pop;
+
+    buffer_from_tile_pwr_s = W2J(from_tile.leakage);
+    buffer_from_tile_push_pwr_d = from_tile.push;
+    buffer_from_tile_front_pwr_d = from_tile.front;
+    buffer_from_tile_pop_pwr_d = from_tile.pop;
    
-    // Buffer Antenna RX
-    pair<int,int> akey = pair<int,int>(antenna_buffer_rx_depth,antenna_buffer_item_size);
-    
-    assert(GlobalParams::power_configuration.bufferPowerConfig.leakage.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.leakage.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.push.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.push.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.front.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.front.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.pop.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.pop.end());
-
-    antenna_buffer_pwr_s = W2J(GlobalParams::power_configuration.bufferPowerConfig.leakage[akey]);
-    antenna_buffer_push_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.push[akey];
-    antenna_buffer_front_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.front[akey];
-    antenna_buffer_pop_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.pop[akey];
-
-    // Buffer Antenna TX
-    akey = pair<int,int>(antenna_buffer_tx_depth,antenna_buffer_item_size);
-    
-    assert(GlobalParams::power_configuration.bufferPowerConfig.leakage.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.leakage.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.push.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.push.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.front.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.front.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.pop.find(akey) != GlobalParams::power_configuration.bufferPowerConfig.pop.end());
+    // Buffer Antenna RX/TX
+    BufferEnergy antenna_rx = PowerModel::buffer(antenna_buffer_rx_depth, antenna_buffer_item_size);
+    BufferEnergy antenna_tx = PowerModel::buffer(antenna_buffer_tx_depth, antenna_buffer_item_size);
 
     // TODO: currently both RX/RX values are aggregated and then an average is returned 
-    antenna_buffer_pwr_s += W2J(GlobalParams::power_configuration.bufferPowerConfig.leakage[akey]);
-    antenna_buffer_push_pwr_d += GlobalParams::power_configuration.bufferPowerConfig.push[akey];
-    antenna_buffer_front_pwr_d += GlobalParams::power_configuration.bufferPowerConfig.front[akey];
-    antenna_buffer_pop_pwr_d += GlobalParams::power_configuration.bufferPowerConfig.pop[akey];
+    antenna_buffer_pwr_s = (W2J(antenna_rx.leakage) + W2J(antenna_tx.leakage))/2;
+    antenna_buffer_push_pwr_d = (antenna_rx.push + antenna_tx.push)/2; 
+    antenna_buffer_front_pwr_d = (antenna_rx.front + antenna_tx.front)/2;
+    antenna_buffer_pop_pwr_d = (antenna_rx.pop + antenna_tx.pop)/2;
 
-    antenna_buffer_pwr_s = antenna_buffer_pwr_s/2;
-    antenna_buffer_push_pwr_d = antenna_buffer_push_pwr_d/2; 
-    antenna_buffer_front_pwr_d = antenna_buffer_front_pwr_d/2;
-    antenna_buffer_pop_pwr_d = antenna_buffer_pop_pwr_d/2;
-
-    attenuation_map = GlobalParams::power_configuration.hubPowerConfig.transmitter_attenuation_map;
+    attenuation_map = &GlobalParams::power_configuration.hubPowerConfig.transmitter_attenuation_map;
 
 
     // TX
@@ -227,116 +210,180 @@ void Power::configureHub(int link_width,
     transceiver_tx_pwr_biasing = W2J(GlobalParams::power_configuration.hubPowerConfig.transceiver_biasing.second);
     // Link 
     // Hub has only Router/Hub link connections
-    double length_r2h = GlobalParams::r2h_link_length;
-    assert(GlobalParams::power_configuration.linkBitLinePowerConfig.find(length_r2h)!=GlobalParams::power_configuration.linkBitLinePowerConfig.end());
-
-    link_r2h_pwr_s= W2J(link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2h].first);
-    link_r2h_pwr_d= link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2h].second;
+    pair<double, double> link_r2h = PowerModel::linkBitLine(GlobalParams::r2h_link_length);
+
+    link_r2h_pwr_s= W2J(link_width * link_r2h.first);
+    link_r2h_pwr_d= link_width * link_r2h.second;
+
+    updateEventEnergies();
+}
+
+void Power::updateEventEnergies()
+{
+    event_energy_d[BUFFER_PUSH_PWR_D] = buffer_router_push_pwr_d;
+    event_energy_d[BUFFER_POP_PWR_D] = buffer_router_pop_pwr_d;
+    event_energy_d[BUFFER_FRONT_PWR_D] = buffer_router_front_pwr_d;
+    event_energy_d[BUFFER_TO_TILE_PUSH_PWR_D] = buffer_to_tile_push_pwr_d;
+    event_energy_d[BUFFER_TO_TILE_POP_PWR_D] = buffer_to_tile_pop_pwr_d;
+    event_energy_d[BUFFER_TO_TILE_FRONT_PWR_D] = buffer_to_tile_front_pwr_d;
+    event_energy_d[BUFFER_FROM_TILE_PUSH_PWR_D] = buffer_from_tile_push_pwr_d;
+    event_energy_d[BUFFER_FROM_TILE_POP_PWR_D] = buffer_from_tile_pop_pwr_d;
+    event_energy_d[BUFFER_FROM_TILE_FRONT_PWR_D] = buffer_from_tile_front_pwr_d;
+    event_energy_d[ANTENNA_BUFFER_PUSH_PWR_D] = antenna_buffer_push_pwr_d;
+    event_energy_d[ANTENNA_BUFFER_POP_PWR_D] = antenna_buffer_pop_pwr_d;
+    event_energy_d[ANTENNA_BUFFER_FRONT_PWR_D] = antenna_buffer_front_pwr_d;
+    event_energy_d[ROUTING_PWR_D] = routing_pwr_d;
+    event_energy_d[SELECTION_PWR_D] = selection_pwr_d;
+    event_energy_d[CROSSBAR_PWR_D] = crossbar_pwr_d;
+    event_energy_d[LINK_R2R_PWR_D] = link_r2r_pwr_d;
+    event_energy_d[LINK_R2H_PWR_D] = link_r2h_pwr_d;
+    event_energy_d[NI_PWR_D] = ni_pwr_d;
+    event_energy_d[WIRELESS_TX] = default_tx_energy;
+    event_energy_d[WIRELESS_DYNAMIC_RX_PWR] = wireless_rx_pwr;
+    event_energy_d[WIRELESS_SNOOPING] = wireless_snooping;
+
+    event_energy_s[TRANSCEIVER_RX_PWR_BIASING] = transceiver_rx_pwr_biasing;
+    event_energy_s[TRANSCEIVER_TX_PWR_BIASING] = transceiver_tx_pwr_biasing;
+    event_energy_s[BUFFER_ROUTER_PWR_S] = buffer_router_pwr_s;
+    event_energy_s[BUFFER_TO_TILE_PWR_S] = buffer_to_tile_pwr_s;
+    event_energy_s[BUFFER_FROM_TILE_PWR_S] = buffer_from_tile_pwr_s;
+    event_energy_s[ANTENNA_BUFFER_PWR_S] = antenna_buffer_pwr_s;
+    event_energy_s[LINK_R2H_PWR_S] = link_r2h_pwr_s;
+    event_energy_s[ROUTING_PWR_S] = routing_pwr_s;
+    event_energy_s[SELECTION_PWR_S] = selection_pwr_s;
+    event_energy_s[CROSSBAR_PWR_S] = crossbar_pwr_s;
+    event_energy_s[NI_PWR_S] = ni_pwr_s;
+    event_energy_s[TRANSCEIVER_RX_PWR_S] = transceiver_rx_pwr_s;
+    event_energy_s[TRANSCEIVER_TX_PWR_S] = transceiver_tx_pwr_s;
+}
+
+// Turns the events counted so far into energy
+void Power::fold()
+{
+    if (router_leakage_cycles) {
+	events_s[ROUTING_PWR_S] += router_leakage_cycles;
+	events_s[SELECTION_PWR_S] += router_leakage_cycles;
+	events_s[CROSSBAR_PWR_S] += router_leakage_cycles;
+	events_s[NI_PWR_S] += router_leakage_cycles;
+	events_s[BUFFER_ROUTER_PWR_S] += router_leakage_cycles * router_buffers;
+	events_s[LINK_R2H_PWR_S] += router_leakage_cycles;
+	router_leakage_cycles = 0;
+    }
 
+    for (int i = 0; i < NO_BREAKDOWN_ENTRIES_D; i++) {
+	power_dynamic.breakdown[i].value += events_d[i] * event_energy_d[i];
+	events_d[i] = 0;
+    }
+    for (int i = 0; i < NO_BREAKDOWN_ENTRIES_S; i++) {
+	power_static.breakdown[i].value += events_s[i] * event_energy_s[i];
+	events_s[i] = 0;
+    }
 }
 
 
 // Router buffer
 void Power::bufferRouterPush()
 {
-    power_dynamic.breakdown[BUFFER_PUSH_PWR_D].value += buffer_router_push_pwr_d;
+    events_d[BUFFER_PUSH_PWR_D]++;
 }
 
 void Power::bufferRouterPop()
 {
-    power_dynamic.breakdown[BUFFER_POP_PWR_D].value += buffer_router_pop_pwr_d;
+    events_d[BUFFER_POP_PWR_D]++;
 }
 
 void Power::bufferRouterFront()
 {
-    power_dynamic.breakdown[BUFFER_FRONT_PWR_D].value += buffer_router_front_pwr_d;
+    events_d[BUFFER_FRONT_PWR_D]++;
 }
 
 // Hub to tile
 void Power::bufferToTilePush()
 {
-    power_dynamic.breakdown[BUFFER_TO_TILE_PUSH_PWR_D].value += buffer_to_tile_push_pwr_d;
+    events_d[BUFFER_TO_TILE_PUSH_PWR_D]++;
 }
 
 void Power::bufferToTilePop()
 {
-    power_dynamic.breakdown[BUFFER_TO_TILE_POP_PWR_D].value += buffer_to_tile_pop_pwr_d;
+    events_d[BUFFER_TO_TILE_POP_PWR_D]++;
 }
 
 void Power::bufferToTileFront()
 {
 
-    power_dynamic.breakdown[BUFFER_TO_TILE_FRONT_PWR_D].value += buffer_to_tile_front_pwr_d;
+    events_d[BUFFER_TO_TILE_FRONT_PWR_D]++;
 }
 
 // Hub from tile
 void Power::bufferFromTilePush()
 {
-    power_dynamic.breakdown[BUFFER_FROM_TILE_PUSH_PWR_D].value += buffer_from_tile_push_pwr_d;
+    events_d[BUFFER_FROM_TILE_PUSH_PWR_D]++;
 }
 
 void Power::bufferFromTilePop()
 {
-    power_dynamic.breakdown[BUFFER_FROM_TILE_POP_PWR_D].value += buffer_from_tile_pop_pwr_d;
+    events_d[BUFFER_FROM_TILE_POP_PWR_D]++;
 }
 
 void Power::bufferFromTileFront()
 {
 
-    power_dynamic.breakdown[BUFFER_FROM_TILE_FRONT_PWR_D].value += buffer_from_tile_front_pwr_d;
+    events_d[BUFFER_FROM_TILE_FRONT_PWR_D]++;
 }
 
 
 // Antenna buffers (RX/TX)
 void Power::antennaBufferPush()
 {
-    power_dynamic.breakdown[ANTENNA_BUFFER_PUSH_PWR_D].value += antenna_buffer_push_pwr_d;
+    events_d[ANTENNA_BUFFER_PUSH_PWR_D]++;
 }
 
 void Power::antennaBufferPop()
 {
-    power_dynamic.breakdown[ANTENNA_BUFFER_POP_PWR_D].value += antenna_buffer_pop_pwr_d;
+    events_d[ANTENNA_BUFFER_POP_PWR_D]++;
 }
 
 void Power::antennaBufferFront()
 {
-    power_dynamic.breakdown[ANTENNA_BUFFER_FRONT_PWR_D].value += antenna_buffer_front_pwr_d;
+    events_d[ANTENNA_BUFFER_FRONT_PWR_D]++;
 }
 
 
 void Power::routing()
 {
-    power_dynamic.breakdown[ROUTING_PWR_D].value += routing_pwr_d;
+    events_d[ROUTING_PWR_D]++;
 }
 
 void Power::selection()
 {
-    power_dynamic.breakdown[SELECTION_PWR_D].value +=selection_pwr_d ;
+    events_d[SELECTION_PWR_D]++;
 }
 
 void Power::crossBar()
 {
-    power_dynamic.breakdown[CROSSBAR_PWR_D].value +=crossbar_pwr_d;
+    events_d[CROSSBAR_PWR_D]++;
 }
 
 void Power::r2rLink()
 {
-    power_dynamic.breakdown[LINK_R2R_PWR_D].value +=link_r2r_pwr_d;
+    events_d[LINK_R2R_PWR_D]++;
 }
 
 void Power::r2hLink()
 {
-    power_dynamic.breakdown[LINK_R2H_PWR_D].value +=link_r2h_pwr_d;
+    events_d[LINK_R2H_PWR_D]++;
 }
 
 void Power::networkInterface()
 {
-    power_dynamic.breakdown[NI_PWR_D].value +=ni_pwr_d;
+    events_d[NI_PWR_D]++;
 }
 
 
 double Power::getDynamicPower()
 {
+    fold();
+
     double power = 0.0;
     for (int i = 0; i<power_dynamic.size; i++)
     {
@@ -348,6 +395,8 @@ double Power::getDynamicPower()
 
 double Power::getStaticPower()
 {
+    fold();
+
     double power = 0.0;
     for (int i = 0; i<power_static.size; i++)
 	power+= power_static.breakdown[i].value;
@@ -366,36 +415,36 @@ double Power::attenuation2power(double attenuation)
 
 void Power::wirelessTx(int src,int dst,int length)
 {
-    power_dynamic.breakdown[WIRELESS_TX].value += default_tx_energy;
+    events_d[WIRELESS_TX]++;
     return;
 
     // TODO enable attenuation_map
 
     pair<int,int> key = pair<int,int>(src,dst);
-    assert(attenuation_map.find(key)!=attenuation_map.end());
+    assert(attenuation_map->find(key)!=attenuation_map->end());
 
-    power_dynamic.breakdown[WIRELESS_TX].value += attenuation2power(attenuation_map[key]) * length;
+    power_dynamic.breakdown[WIRELESS_TX].value += attenuation2power(attenuation_map->at(key)) * length;
 }
 
 void Power::wirelessDynamicRx()
 {
-    power_dynamic.breakdown[WIRELESS_DYNAMIC_RX_PWR].value += wireless_rx_pwr;
+    events_d[WIRELESS_DYNAMIC_RX_PWR]++;
 }
 
 void Power::wirelessSnooping()
 {
-    power_dynamic.breakdown[WIRELESS_SNOOPING].value += wireless_snooping;
+    events_d[WIRELESS_SNOOPING]++;
 }
 
 
 void Power::biasingRx()
 {
-    power_static.breakdown[TRANSCEIVER_RX_PWR_BIASING].value += transceiver_rx_pwr_biasing;
+    events_s[TRANSCEIVER_RX_PWR_BIASING]++;
 }
 
 void Power::biasingTx()
 {
-    power_static.breakdown[TRANSCEIVER_TX_PWR_BIASING].value += transceiver_tx_pwr_biasing;
+    events_s[TRANSCEIVER_TX_PWR_BIASING]++;
 
 }
 
@@ -405,23 +454,23 @@ void Power::biasingTx()
 // - Hub: takes the leakage value of buffer_from_tile/to_tile
 void Power::leakageBufferRouter()
 {
-    power_static.breakdown[BUFFER_ROUTER_PWR_S].value +=buffer_router_pwr_s;
+    events_s[BUFFER_ROUTER_PWR_S]++;
 }
 
 void Power::leakageBufferToTile()
 {
-    power_static.breakdown[BUFFER_TO_TILE_PWR_S].value +=buffer_to_tile_pwr_s;
+    events_s[BUFFER_TO_TILE_PWR_S]++;
 }
 
 void Power::leakageBufferFromTile()
 {
-    power_static.breakdown[BUFFER_FROM_TILE_PWR_S].value +=buffer_from_tile_pwr_s;
+    events_s[BUFFER_FROM_TILE_PWR_S]++;
 }
 
 // Account for each buffer_rx (Targets) or buffer_tx (Initiators)
 void Power::leakageAntennaBuffer()
 {
-    power_static.breakdown[ANTENNA_BUFFER_PWR_S].value +=(antenna_buffer_pwr_s);
+    events_s[ANTENNA_BUFFER_PWR_S]++;
 }
 
 void Power::leakageLinkRouter2Router()
@@ -431,31 +480,38 @@ void Power::leakageLinkRouter2Router()
 
 void Power::leakageLinkRouter2Hub()
 {
-    power_static.breakdown[LINK_R2H_PWR_S].value +=link_r2h_pwr_s;
+    events_s[LINK_R2H_PWR_S]++;
 }
 
 void Power::leakageRouter()
 {
     // note: leakage contributions depending on instance number are 
     // accounted in specific separate leakage functions
-    power_static.breakdown[ROUTING_PWR_S].value +=routing_pwr_s;
-    power_static.breakdown[SELECTION_PWR_S].value +=selection_pwr_s;
-    power_static.breakdown[CROSSBAR_PWR_S].value +=crossbar_pwr_s;
-    power_static.breakdown[NI_PWR_S].value +=ni_pwr_s;
+    events_s[ROUTING_PWR_S]++;
+    events_s[SELECTION_PWR_S]++;
+    events_s[CROSSBAR_PWR_S]++;
+    events_s[NI_PWR_S]++;
 }
 
 
 
+void Power::leakageRouterCycle()
+{
+    // same as leakageRouter() + leakageLinkRouter2Hub() and
+    // leakageBufferRouter() for each buffer, accounted at fold()
+    router_leakage_cycles++;
+}
+
 void Power::leakageTransceiverRx()
 {
 
-    power_static.breakdown[TRANSCEIVER_RX_PWR_S].value +=transceiver_rx_pwr_s;
+    events_s[TRANSCEIVER_RX_PWR_S]++;
 }
 
 void Power::leakageTransceiverTx()
 {
 
-    power_static.breakdown[TRANSCEIVER_TX_PWR_S].value +=transceiver_tx_pwr_s;
+    events_s[TRANSCEIVER_TX_PWR_S]++;
 }
 
 void Power::printBreakDown(std::ostream & out)
@@ -538,3 +594,16 @@ void Power::initPowerBreakdown()
 
 
 
+
+void Power::serialize(Checkpoint & ckpt)
+{
+    ckpt.io(events_d);
+    ckpt.io(events_s);
+    ckpt.io(router_leakage_cycles);
+    ckpt.io(sleep_end_cycle);
+
+    for (int i = 0; i < power_dynamic.size; i++)
+	ckpt.io(power_dynamic.breakdown[i].value);
+    for (int i = 0; i < power_static.size; i++)
+	ckpt.io(power_static.breakdown[i].value);
+}
@@ -21,6 +21,8 @@
 
 using namespace std;
 
+class Checkpoint;
+
 class Power {
 
   public:
@@ -79,6 +81,9 @@ class Power {
     void biasingRx();
     void biasingTx();
 
+    // Leakage of a whole router (logic, input buffers, hub link) for one cycle
+    void leakageRouterCycle();
+
     double getDynamicPower();
     double getStaticPower();
 
@@ -90,8 +95,11 @@ class Power {
     void printBreakDown(std::ostream & out);
 
 
-    PowerBreakdown* getDynamicPowerBreakDown(){ return &power_dynamic;}
-    PowerBreakdown* getStaticPowerBreakDown(){ return &power_static;}
+    PowerBreakdown* getDynamicPowerBreakDown(){ fold(); return &power_dynamic;}
+    PowerBreakdown* getStaticPowerBreakDown(){ fold(); return &power_static;}
+
+    // Saves or restores the energy and the events counted so far
+    void serialize(Checkpoint & ckpt);
 
     void rxSleep(int cycles);
     bool isSleeping();
@@ -146,7 +154,7 @@ class Power {
     double ni_pwr_d;
     double ni_pwr_s;
 
-    map< pair<int, int> , double>  attenuation_map;
+    const map< pair<int, int> , double> *attenuation_map;	// shared, from the power configuration
     double attenuation2power(double);
 
 
@@ -155,6 +163,19 @@ class Power {
     PowerBreakdown power_dynamic;
     PowerBreakdown power_static;
 
+    // Events (and leakage cycles) are only counted while simulating: the
+    // energy is obtained multiplying the counts by the per-event energies
+    // when read or before changing the configuration (see fold())
+    unsigned long events_d[NO_BREAKDOWN_ENTRIES_D];
+    unsigned long events_s[NO_BREAKDOWN_ENTRIES_S];
+    double event_energy_d[NO_BREAKDOWN_ENTRIES_D];
+    double event_energy_s[NO_BREAKDOWN_ENTRIES_S];
+    unsigned long router_leakage_cycles;
+    int router_buffers;		// input buffers leaking in a router cycle
+
+    void updateEventEnergies();
+    void fold();
+
     void initPowerBreakdownEntry(PowerBreakdownEntry* pbe,string label);
     void initPowerBreakdown();
 
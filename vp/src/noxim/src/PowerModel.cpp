@@ -0,0 +1,252 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the compiled power model
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include "PowerModel.h"
+
+using namespace std;
+
+PowerTable PowerModel::buffer_table;
+PowerTable PowerModel::link_table;
+PowerTable PowerModel::crossbar_table;
+PowerTable PowerModel::ni_table;
+bool PowerModel::compiled = false;
+
+void PowerTable::init(const vector<double> & _xs, const vector<double> & _ys, int _n_values)
+{
+    assert(!_xs.empty() && !_ys.empty());
+
+    xs = _xs;
+    ys = _ys;
+    n_values = _n_values;
+    values.assign(xs.size() * ys.size() * n_values, 0.0);
+    filled.assign(xs.size() * ys.size(), false);
+}
+
+void PowerTable::set(double x, double y, const double *v)
+{
+    int i = lower_bound(xs.begin(), xs.end(), x) - xs.begin();
+    int j = lower_bound(ys.begin(), ys.end(), y) - ys.begin();
+    int p = i * ys.size() + j;
+
+    for (int k = 0; k < n_values; k++)
+	values[p * n_values + k] = v[k];
+    filled[p] = true;
+}
+
+bool PowerTable::complete(double & missing_x, double & missing_y) const
+{
+    for (unsigned int p = 0; p < filled.size(); p++)
+	if (!filled[p]) {
+	    missing_x = xs[p / ys.size()];
+	    missing_y = ys[p % ys.size()];
+	    return false;
+	}
+    return true;
+}
+
+// Returns in i the index of the segment [axis[i], axis[i+1]] containing v
+// and in t the position of v in it, both clamped to the axis
+void PowerTable::locate(const vector<double> & axis, double v, int & i, double & t)
+{
+    if (axis.size() == 1 || v <= axis.front()) {
+	i = 0;
+	t = 0.0;
+    } else if (v >= axis.back()) {
+	i = axis.size() - 2;
+	t = 1.0;
+    } else {
+	i = upper_bound(axis.begin(), axis.end(), v) - axis.begin() - 1;
+	t = (v - axis[i]) / (axis[i + 1] - axis[i]);
+    }
+}
+
+void PowerTable::lookup(double x, double y, double *v) const
+{
+    int i, j;
+    double tx, ty;
+
+    locate(xs, x, i, tx);
+    locate(ys, y, j, ty);
+
+    int i1 = min(i + 1, (int) xs.size() - 1);
+    int j1 = min(j + 1, (int) ys.size() - 1);
+    int ny = ys.size();
+
+    for (int k = 0; k < n_values; k++) {
+	double v00 = values[(i * ny + j) * n_values + k];
+	double v01 = values[(i * ny + j1) * n_values + k];
+	double v10 = values[(i1 * ny + j) * n_values + k];
+	double v11 = values[(i1 * ny + j1) * n_values + k];
+
+	v[k] = (1 - tx) * ((1 - ty) * v00 + ty * v01) + tx * ((1 - ty) * v10 + ty * v11);
+    }
+}
+
+template <typename K> static vector<double> axis(const vector<K> & keys)
+{
+    vector<double> a(keys.begin(), keys.end());
+    sort(a.begin(), a.end());
+    a.erase(unique(a.begin(), a.end()), a.end());
+    return a;
+}
+
+static void checkComplete(const PowerTable & table, const char *what)
+{
+    double x, y;
+
+    if (!table.complete(x, y)) {
+	cerr << "Error: power configuration " << what << " table has no entry for [" << x << ", " << y
+	     << "], the table must be a full grid" << endl;
+	exit(1);
+    }
+}
+
+void PowerModel::compile(const PowerConfig & config)
+{
+    // Buffer: depth x item size -> leakage, push, front, pop
+    {
+	const BufferPowerConfig & b = config.bufferPowerConfig;
+	vector<int> depths, sizes;
+
+	for (map<pair<int, int>, double>::const_iterator it = b.leakage.begin(); it != b.leakage.end(); it++) {
+	    depths.push_back(it->first.first);
+	    sizes.push_back(it->first.second);
+	}
+	buffer_table.init(axis(depths), axis(sizes), 4);
+
+	for (map<pair<int, int>, double>::const_iterator it = b.leakage.begin(); it != b.leakage.end(); it++) {
+	    double v[4] = { it->second, b.push.at(it->first), b.front.at(it->first), b.pop.at(it->first) };
+	    buffer_table.set(it->first.first, it->first.second, v);
+	}
+	checkComplete(buffer_table, "Buffer");
+    }
+
+    // Link bit line: length -> leakage, dynamic
+    {
+	vector<double> lengths;
+
+	for (LinkBitLinePowerConfig::const_iterator it = config.linkBitLinePowerConfig.begin();
+	     it != config.linkBitLinePowerConfig.end(); it++)
+	    lengths.push_back(it->first);
+	link_table.init(axis(lengths), vector<double>(1, 0.0), 2);
+
+	for (LinkBitLinePowerConfig::const_iterator it = config.linkBitLinePowerConfig.begin();
+	     it != config.linkBitLinePowerConfig.end(); it++) {
+	    double v[2] = { it->second.first, it->second.second };
+	    link_table.set(it->first, 0.0, v);
+	}
+    }
+
+    // Crossbar: ports x flit size -> leakage, dynamic
+    {
+	const map<pair<double, double>, pair<double, double> > & c = config.routerPowerConfig.crossbar_pm;
+	vector<double> ports, sizes;
+
+	for (map<pair<double, double>, pair<double, double> >::const_iterator it = c.begin(); it != c.end(); it++) {
+	    ports.push_back(it->first.first);
+	    sizes.push_back(it->first.second);
+	}
+	crossbar_table.init(axis(ports), axis(sizes), 2);
+
+	for (map<pair<double, double>, pair<double, double> >::const_iterator it = c.begin(); it != c.end(); it++) {
+	    double v[2] = { it->second.first, it->second.second };
+	    crossbar_table.set(it->first.first, it->first.second, v);
+	}
+	checkComplete(crossbar_table, "crossbar");
+    }
+
+    // Network interface: flit size -> leakage, dynamic
+    {
+	const map<int, pair<double, double> > & n = config.routerPowerConfig.network_interface;
+	vector<int> sizes;
+
+	for (map<int, pair<double, double> >::const_iterator it = n.begin(); it != n.end(); it++)
+	    sizes.push_back(it->first);
+	ni_table.init(axis(sizes), vector<double>(1, 0.0), 2);
+
+	for (map<int, pair<double, double> >::const_iterator it = n.begin(); it != n.end(); it++) {
+	    double v[2] = { it->second.first, it->second.second };
+	    ni_table.set(it->first, 0.0, v);
+	}
+    }
+
+    compiled = true;
+}
+
+BufferEnergy PowerModel::buffer(int depth, int item_size)
+{
+    assert(compiled);
+
+    double v[4];
+    buffer_table.lookup(depth, item_size, v);
+
+    BufferEnergy e;
+    e.leakage = v[0];
+    e.push = v[1];
+    e.front = v[2];
+    e.pop = v[3];
+    return e;
+}
+
+pair<double, double> PowerModel::linkBitLine(double length)
+{
+    assert(compiled);
+
+    double v[2];
+    link_table.lookup(length, 0.0, v);
+    return make_pair(v[0], v[1]);
+}
+
+pair<double, double> PowerModel::crossbar(int ports, int flit_size)
+{
+    assert(compiled);
+
+    double v[2];
+    crossbar_table.lookup(ports, flit_size, v);
+    return make_pair(v[0], v[1]);
+}
+
+pair<double, double> PowerModel::networkInterface(int flit_size)
+{
+    assert(compiled);
+
+    double v[2];
+    ni_table.lookup(flit_size, 0.0, v);
+    return make_pair(v[0], v[1]);
+}
+
+pair<double, double> PowerModel::byName(const map<string, pair<double, double> > & m,
+					 const string & name, const char *what)
+{
+    map<string, pair<double, double> >::const_iterator it = m.find(name);
+
+    if (it == m.end())
+	it = m.find("default");
+    if (it == m.end()) {
+	cerr << "Error: no " << what << " power figures for " << name << " and no default entry" << endl;
+	exit(1);
+    }
+    return it->second;
+}
+
+pair<double, double> PowerModel::routing(const string & routing_function)
+{
+    return byName(GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm, routing_function,
+		  "routing");
+}
+
+pair<double, double> PowerModel::selection(const string & selection_function)
+{
+    return byName(GlobalParams::power_configuration.routerPowerConfig.selection_strategy_pm, selection_function,
+		  "selection");
+}
@@ -0,0 +1,85 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the compiled power model
+ */
+
+#ifndef __NOXIMPOWERMODEL_H__
+#define __NOXIMPOWERMODEL_H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include "GlobalParams.h"
+
+using namespace std;
+
+// Values sampled on a dense x/y grid (y has a single point for 1D tables).
+// Reads interpolate (bi)linearly and clamp to the characterized range.
+class PowerTable {
+
+  public:
+
+    PowerTable() : n_values(0) {
+    }
+
+    // Axes must be sorted, every point must then be filled with set()
+    void init(const vector<double> & xs, const vector<double> & ys, int n_values);
+    void set(double x, double y, const double *v);
+    void lookup(double x, double y, double *v) const;
+
+    // Checks that set() has been called on every point of the grid
+    bool complete(double & missing_x, double & missing_y) const;
+
+  private:
+
+    vector<double> xs;
+    vector<double> ys;
+    int n_values;
+    vector<double> values;	// [x][y][value]
+    vector<bool> filled;
+
+    static void locate(const vector<double> & axis, double v, int & i, double & t);
+};
+
+struct BufferEnergy {
+    double leakage;		// W
+    double push;		// J
+    double front;		// J
+    double pop;			// J
+};
+
+// The power configuration compiled once at startup into dense tables,
+// shared by all the Router and Hub instances. Pairs are [Static (W), Dynamic (J)].
+class PowerModel {
+
+  public:
+
+    static void compile(const PowerConfig & config);
+
+    static BufferEnergy buffer(int depth, int item_size);
+    static pair<double, double> linkBitLine(double length);
+    static pair<double, double> crossbar(int ports, int flit_size);
+    static pair<double, double> networkInterface(int flit_size);
+
+    // Falls back to the "default" entry for unlisted algorithms/strategies
+    static pair<double, double> routing(const string & routing_function);
+    static pair<double, double> selection(const string & selection_function);
+
+  private:
+
+    static PowerTable buffer_table;
+    static PowerTable link_table;
+    static PowerTable crossbar_table;
+    static PowerTable ni_table;
+    static bool compiled;
+
+    static pair<double, double> byName(const map<string, pair<double, double> > & m,
+				       const string & name, const char *what);
+};
+
+#endif
@@ -10,63 +10,92 @@
 
 #include "ReservationTable.h"
 
-ReservationTable::ReservationTable() {}
+#include "Checkpoint.h"
+
+// VC masks are stored in an unsigned char
+static_assert(MAX_VIRTUAL_CHANNELS <= 8, "ReservationTable supports up to 8 virtual channels");
+
+#define ALL_VCS ((1 << MAX_VIRTUAL_CHANNELS) - 1)
+
+ReservationTable::ReservationTable() : n_outputs(0), matrix_arbiter(false) {}
 
 void ReservationTable::setSize(const int n_outputs) {
 	this->n_outputs = n_outputs;
-	rtable = new TRTEntry[this->n_outputs];
-
-	for (int i = 0; i < this->n_outputs; i++) {
-		rtable[i].index = 0;
-		rtable[i].reservations.clear();
+	matrix_arbiter = (GlobalParams::reservation_arbiter == ARBITER_MATRIX);
+
+	TRTEntry empty;
+	empty.reserved = 0;
+	empty.rr_next = 0;
+	for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++) {
+		empty.input[vc] = NOT_RESERVED;
+		// lower VCs win at startup
+		empty.beats[vc] = ALL_VCS & ~((2 << vc) - 1);
 	}
+
+	rtable.assign(this->n_outputs, empty);
 }
 
 bool ReservationTable::isNotReserved(const int port_out) {
 	assert(port_out < n_outputs);
-	return (rtable[port_out].reservations.size() == 0);
+	return (rtable[port_out].reserved == 0);
+}
+
+int ReservationTable::activeVC(const TRTEntry &entry) const {
+	unsigned int reserved = entry.reserved;
+
+	if (reserved == 0)
+		return NOT_VALID;
+
+	if (matrix_arbiter) {
+		// the winner is the reserved VC which no other reserved VC beats
+		for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++) {
+			if ((reserved & (1 << vc)) && (reserved & ~entry.beats[vc] & ~(1 << vc)) == 0)
+				return vc;
+		}
+		assert(false);  // the priority matrix must be a total order
+	}
+
+	// first reserved VC starting from rr_next
+	unsigned int rotated = ((reserved >> entry.rr_next) | (reserved << (MAX_VIRTUAL_CHANNELS - entry.rr_next))) & ALL_VCS;
+	return (entry.rr_next + __builtin_ctz(rotated)) % MAX_VIRTUAL_CHANNELS;
 }
 
 /* For a given input, returns the set of output/vc reserved from that input.
- * An index is required for each output entry, to avoid that multiple invokations
- * with different inputs returns the same output in the same clock cycle. */
-vector<pair<int, int> > ReservationTable::getReservations(const int port_in) {
-	vector<pair<int, int> > reservations;
+ * Only the VC granted by the arbiter of each output is considered, to avoid
+ * that multiple invokations with different inputs returns the same output in
+ * the same clock cycle. */
+int ReservationTable::getReservations(const int port_in, pair<int, int> *reservations) {
+	int n_reservations = 0;
 
 	for (int o = 0; o < n_outputs; o++) {
-		if (rtable[o].reservations.size() > 0) {
-			int current_index = rtable[o].index;
-			if (rtable[o].reservations[current_index].input == port_in)
-				reservations.push_back(pair<int, int>(o, rtable[o].reservations[current_index].vc));
-		}
+		int vc = activeVC(rtable[o]);
+		if (vc != NOT_VALID && rtable[o].input[vc] == port_in)
+			reservations[n_reservations++] = pair<int, int>(o, vc);
 	}
-	return reservations;
+	return n_reservations;
 }
 
 int ReservationTable::checkReservation(const TReservation r, const int port_out) {
+	assert(port_out < n_outputs);
+	assert(r.vc >= 0 && r.vc < MAX_VIRTUAL_CHANNELS);
+
 	/* Sanity Check for forbidden table status:
 	 * - same input/VC in a different output line */
 	for (int o = 0; o < n_outputs; o++) {
-		for (vector<TReservation>::size_type i = 0; i < rtable[o].reservations.size(); i++) {
-			// In the current implementation this should never happen
-			if (o != port_out && rtable[o].reservations[i] == r) {
-				return RT_ALREADY_OTHER_OUT;
-			}
-		}
+		// In the current implementation this should never happen
+		if (o != port_out && (rtable[o].reserved & (1 << r.vc)) && rtable[o].input[r.vc] == r.input)
+			return RT_ALREADY_OTHER_OUT;
 	}
 
 	/* On a given output entry, reservations must differ by VC
-	 *  Motivation: they will be interleaved cycle-by-cycle as index moves */
-
-	int n_reservations = rtable[port_out].reservations.size();
-	for (int i = 0; i < n_reservations; i++) {
+	 *  Motivation: they will be interleaved cycle-by-cycle by the arbiter */
+	if (rtable[port_out].reserved & (1 << r.vc)) {
 		// the reservation is already present
-		if (rtable[port_out].reservations[i] == r)
+		if (rtable[port_out].input[r.vc] == r.input)
 			return RT_ALREADY_SAME;
 
 		// the same VC for that output has been reserved by another input
-		if (rtable[port_out].reservations[i].input != r.input && rtable[port_out].reservations[i].vc == r.vc)
-			return RT_OUTVC_BUSY;
+		return RT_OUTVC_BUSY;
 	}
 	return RT_AVAILABLE;
 }
@@ -74,10 +103,11 @@ int ReservationTable::checkReservation(const TReservation r, const int port_out)
 void ReservationTable::print() {
 	for (int o = 0; o < n_outputs; o++) {
 		cout << o << ": ";
-		for (vector<TReservation>::size_type i = 0; i < rtable[o].reservations.size(); i++) {
-			cout << "<" << rtable[o].reservations[i].input << "," << rtable[o].reservations[i].vc << ">, ";
+		for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++) {
+			if (rtable[o].reserved & (1 << vc))
+				cout << "<" << rtable[o].input[vc] << "," << vc << ">, ";
 		}
-		cout << " | " << rtable[o].index;
+		cout << " | " << activeVC(rtable[o]);
 		cout << endl;
 	}
 }
@@ -89,34 +119,41 @@ void ReservationTable::reserve(const TReservation r, const int port_out) {
 	// should be assured by ReservationTable users
 	assert(checkReservation(r, port_out) == RT_AVAILABLE);
 
-	// TODO: a better policy could insert in a specific position as far a possible
-	// from the current index
-	rtable[port_out].reservations.push_back(r);
+	rtable[port_out].reserved |= 1 << r.vc;
+	rtable[port_out].input[r.vc] = r.input;
 }
 
 void ReservationTable::release(const TReservation r, const int port_out) {
 	assert(port_out < n_outputs);
 
-	for (vector<TReservation>::iterator i = rtable[port_out].reservations.begin();
-	     i != rtable[port_out].reservations.end(); i++) {
-		if (*i == r) {
-			rtable[port_out].reservations.erase(i);
-			vector<TReservation>::size_type removed_index = i - rtable[port_out].reservations.begin();
+	// trying to release a never made reservation  ?
+	assert((rtable[port_out].reserved & (1 << r.vc)) && rtable[port_out].input[r.vc] == r.input);
 
-			if (removed_index < rtable[port_out].index)
-				rtable[port_out].index--;
-			else if (rtable[port_out].index >= rtable[port_out].reservations.size())
-				rtable[port_out].index = 0;
-
-			return;
-		}
-	}
-	assert(false);  // trying to release a never made reservation  ?
+	rtable[port_out].reserved &= ~(1 << r.vc);
+	rtable[port_out].input[r.vc] = NOT_RESERVED;
 }
 
 void ReservationTable::updateIndex() {
 	for (int o = 0; o < n_outputs; o++) {
-		if (rtable[o].reservations.size() > 0)
-			rtable[o].index = (rtable[o].index + 1) % (rtable[o].reservations.size());
+		TRTEntry &entry = rtable[o];
+		int granted = activeVC(entry);
+
+		if (granted == NOT_VALID)
+			continue;
+
+		if (matrix_arbiter) {
+			// the granted VC gets the lowest priority
+			entry.beats[granted] = 0;
+			for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++)
+				if (vc != granted)
+					entry.beats[vc] |= 1 << granted;
+		} else
+			entry.rr_next = (granted + 1) % MAX_VIRTUAL_CHANNELS;
 	}
 }
+
+void ReservationTable::serialize(Checkpoint &ckpt) {
+	ckpt.io(rtable);
+	ckpt.io(n_outputs);
+	ckpt.io(matrix_arbiter);
+}
@@ -18,6 +18,8 @@
 
 using namespace std;
 
+class Checkpoint;
+
 struct TReservation {
 	int input;
 	int vc;
@@ -26,9 +28,12 @@ struct TReservation {
 	}
 };
 
+// Reservations of an output port: at most one input per VC
 typedef struct RTEntry {
-	vector<TReservation> reservations;
-	vector<TReservation>::size_type index;
+	unsigned char reserved;               // bit vc set when the VC vc is reserved
+	int input[MAX_VIRTUAL_CHANNELS];      // input holding each reserved VC
+	int rr_next;                          // round-robin: VC with the highest priority
+	unsigned char beats[MAX_VIRTUAL_CHANNELS];  // matrix: bit j of beats[i] set when VC i wins over VC j
 } TRTEntry;
 
 class ReservationTable {
@@ -49,8 +54,9 @@ class ReservationTable {
 	// Asserts if port_out is not reserved or not valid
 	void release(const TReservation r, const int port_out);
 
-	// Returns the pairs of output port and virtual channel reserved by port_in
-	vector<pair<int, int> > getReservations(const int port_int);
+	// Writes into reservations (at least getSize() entries) the pairs of
+	// output port and virtual channel reserved by port_in, returns their number
+	int getReservations(const int port_in, pair<int, int> *reservations);
 
 	// update the index of the reservation having highest priority in the current cycle
 	void updateIndex();
@@ -59,14 +65,21 @@ class ReservationTable {
 	bool isNotReserved(const int port_out);
 
 	void setSize(const int n_outputs);
+	int getSize() const { return n_outputs; }
 
 	void print();
 
+	void serialize(Checkpoint &ckpt);
+
    private:
-	TRTEntry *rtable;  // reservation vector: rtable[i] gives a RTEntry containing the set of input/VC
-	                   // which reserved output port
+	// VC of port_out granted in the current cycle, NOT_VALID if none
+	int activeVC(const TRTEntry &entry) const;
+
+	vector<TRTEntry> rtable;  // reservation vector: rtable[i] gives a RTEntry containing the set of input/VC
+	                          // which reserved output port
 
 	int n_outputs;
+	bool matrix_arbiter;  // arbitration among the VCs of an output, round-robin otherwise
 };
 
 #endif
@@ -10,6 +10,8 @@
 
 #include "Router.h"
 
+#include "Checkpoint.h"
+
 inline int toggleKthBit(int n, int k) {
 	return (n ^ (1 << (k - 1)));
 }
@@ -29,6 +31,7 @@ void Router::rxProcess() {
 			buffer_full_status_rx[i].write(bfs);
 		}
 		routed_flits = 0;
+		telemetry.clear();
 		local_drained = 0;
 	} else {
 		// This process simply sees a flow of incoming flits. All arbitration
@@ -89,174 +92,205 @@ void Router::txProcess() {
 
         req_broadcast.write(0);
         current_level_broadcast = 0;
+
+		pending_tx = 0;
+		pending_broadcast = false;
 	} else {
-		// 1st phase: Reservation
-		for (int j = 0; j < DIRECTIONS + 2; j++) {
-			int i = (start_from_port + j) % (DIRECTIONS + 2);
-
-			for (int k = 0; k < GlobalParams::n_virtual_channels; k++) {
-				int vc = (start_from_vc[i] + k) % (GlobalParams::n_virtual_channels);
-
-				// Uncomment to enable deadlock checking on buffers.
-				// Please also set the appropriate threshold.
-				// buffer[i].deadlockCheck();
-
-				if (!buffer[i][vc].IsEmpty()) {
-					Flit flit = buffer[i][vc].Front();
-					power.bufferRouterFront();
-
-					if (flit.flit_type == FLIT_TYPE_HEAD) {
-						// prepare data for routing
-						RouteData route_data;
-						route_data.current_id = local_id;
-						// LOG<< "current_id= "<< route_data.current_id <<" for sending " << flit << endl;
-						route_data.src_id = flit.src_id;
-						route_data.dst_id = flit.dst_id;
-						route_data.dir_in = i;
-						route_data.vc_id = flit.vc_id;
-
-						// TODO: see PER POSTERI (adaptive routing should not recompute route if already reserved)
-						int o = route(route_data);
-
-						// manage special case of target hub not directly connected to destination
-						if (o >= DIRECTION_HUB_RELAY) {
-							Flit f = buffer[i][vc].Pop();
-							f.hub_relay_node = o - DIRECTION_HUB_RELAY;
-							buffer[i][vc].Push(f);
-							o = DIRECTION_HUB;
-						}
-
-						TReservation r;
-						r.input = i;
-						r.vc = vc;
-
-						LOG << " checking availability of Output[" << o << "] for Input[" << i << "][" << vc
-						    << "] flit " << flit << endl;
-
-						int rt_status = reservation_table.checkReservation(r, o);
-
-						if (rt_status == RT_AVAILABLE) {
-							LOG << " reserving direction " << o << " for flit " << flit << endl;
-							reservation_table.reserve(r, o);
-						} else if (rt_status == RT_ALREADY_SAME) {
-							LOG << " RT_ALREADY_SAME reserved direction " << o << " for flit " << flit << endl;
-						} else if (rt_status == RT_OUTVC_BUSY) {
-							LOG << " RT_OUTVC_BUSY reservation direction " << o << " for flit " << flit << endl;
-						} else if (rt_status == RT_ALREADY_OTHER_OUT) {
-							LOG << "RT_ALREADY_OTHER_OUT: another output previously reserved for the same flit "
-							    << endl;
-						} else
-							assert(false);  // no meaningful status here
+		txReservation();
+		txForwarding();
+		driveOutputs();
+	}
+}
+
+void Router::txReservation() {
+	// 1st phase: Reservation
+	for (int j = 0; j < DIRECTIONS + 2; j++) {
+		int i = (start_from_port + j) % (DIRECTIONS + 2);
+
+		for (int k = 0; k < GlobalParams::n_virtual_channels; k++) {
+			int vc = (start_from_vc[i] + k) % (GlobalParams::n_virtual_channels);
+
+			// Uncomment to enable deadlock checking on buffers.
+			// Please also set the appropriate threshold.
+			// buffer[i].deadlockCheck();
+
+			if (!buffer[i][vc].IsEmpty()) {
+				Flit flit = buffer[i][vc].Front();
+				power.bufferRouterFront();
+
+				if (flit.flit_type == FLIT_TYPE_HEAD) {
+					// prepare data for routing
+					RouteData route_data;
+					route_data.current_id = local_id;
+					// LOG<< "current_id= "<< route_data.current_id <<" for sending " << flit << endl;
+					route_data.src_id = flit.src_id;
+					route_data.dst_id = flit.dst_id;
+					route_data.dir_in = i;
+					route_data.vc_id = flit.vc_id;
+
+					// TODO: see PER POSTERI (adaptive routing should not recompute route if already reserved)
+					int o = route(route_data);
+
+					// manage special case of target hub not directly connected to destination
+					if (o >= DIRECTION_HUB_RELAY) {
+						Flit f = buffer[i][vc].Pop();
+						f.hub_relay_node = o - DIRECTION_HUB_RELAY;
+						buffer[i][vc].Push(f);
+						o = DIRECTION_HUB;
 					}
+
+					TReservation r;
+					r.input = i;
+					r.vc = vc;
+
+					LOG << " checking availability of Output[" << o << "] for Input[" << i << "][" << vc
+					    << "] flit " << flit << endl;
+
+					int rt_status = reservation_table.checkReservation(r, o);
+
+					if (rt_status == RT_AVAILABLE) {
+						LOG << " reserving direction " << o << " for flit " << flit << endl;
+						reservation_table.reserve(r, o);
+					} else if (rt_status == RT_ALREADY_SAME) {
+						LOG << " RT_ALREADY_SAME reserved direction " << o << " for flit " << flit << endl;
+					} else if (rt_status == RT_OUTVC_BUSY) {
+						LOG << " RT_OUTVC_BUSY reservation direction " << o << " for flit " << flit << endl;
+					} else if (rt_status == RT_ALREADY_OTHER_OUT) {
+						LOG << "RT_ALREADY_OTHER_OUT: another output previously reserved for the same flit "
+						    << endl;
+					} else
+						assert(false);  // no meaningful status here
 				}
 			}
-			start_from_vc[i] = (start_from_vc[i] + 1) % GlobalParams::n_virtual_channels;
 		}
+		start_from_vc[i] = (start_from_vc[i] + 1) % GlobalParams::n_virtual_channels;
+	}
 
-		start_from_port = (start_from_port + 1) % (DIRECTIONS + 2);
+	start_from_port = (start_from_port + 1) % (DIRECTIONS + 2);
+}
 
-		// 2nd phase: Forwarding
-		// if (local_id==6) LOG<<"*TX*****local_id="<<local_id<<"__ack_tx[0]= "<<ack_tx[0].read()<<endl;
-		for (int i = 0; i < DIRECTIONS + 2; i++) {
-			vector<pair<int, int> > reservations = reservation_table.getReservations(i);
-
-			if (reservations.size() != 0) {
-				int rnd_idx = rand() % reservations.size();
-
-				int o = reservations[rnd_idx].first;
-				int vc = reservations[rnd_idx].second;
-				// LOG<< "found reservation from input= " << i << "_to output= "<<o<<endl;
-				// can happen
-				if (!buffer[i][vc].IsEmpty()) {
-					// power contribution already computed in 1st phase
-					Flit& flit = buffer[i][vc].Front();
-					// LOG<< "*****TX***Direction= "<<i<< "************"<<endl;
-					// LOG<<"_cl_tx="<<current_level_tx[o]<<"req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<<
-					// endl;
-
-                    if (flit.src_id != local_id && flit.dst_id != local_id) {
-                        if (flit.is_broadcast && !flit.local_reserved) {
-                            // forward flit to local first
-                            if (ack_broadcast.read() == current_level_broadcast) {
-                                flit_broadcast.write(flit);
-                                current_level_broadcast = 1 - current_level_broadcast;
-                                req_broadcast.write(current_level_broadcast);
-
-                                flit.local_reserved = true;
-                            }
+void Router::txForwarding() {
+	// 2nd phase: Forwarding
+	// if (local_id==6) LOG<<"*TX*****local_id="<<local_id<<"__ack_tx[0]= "<<ack_tx[0].read()<<endl;
+	for (int i = 0; i < DIRECTIONS + 2; i++) {
+		pair<int, int> reservations[DIRECTIONS + 2];
+		int n_reservations = reservation_table.getReservations(i, reservations);
+
+		if (n_reservations != 0) {
+			int rnd_idx = randomIndex(n_reservations);
+
+			int o = reservations[rnd_idx].first;
+			int vc = reservations[rnd_idx].second;
+			// LOG<< "found reservation from input= " << i << "_to output= "<<o<<endl;
+			// can happen
+			if (!buffer[i][vc].IsEmpty()) {
+				// power contribution already computed in 1st phase
+				Flit& flit = buffer[i][vc].Front();
+				// LOG<< "*****TX***Direction= "<<i<< "************"<<endl;
+				// LOG<<"_cl_tx="<<current_level_tx[o]<<"req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<<
+				// endl;
+
+                if (flit.src_id != local_id && flit.dst_id != local_id) {
+                    if (flit.is_broadcast && !flit.local_reserved) {
+                        // forward flit to local first
+                        if (ack_broadcast.read() == current_level_broadcast) {
+                            pending_flit_broadcast = flit;
+                            pending_broadcast = true;
+                            current_level_broadcast = 1 - current_level_broadcast;
+
+                            flit.local_reserved = true;
+                        }
+                    }
+                } 
+
+                if (flit.src_id == local_id || flit.dst_id == local_id || !flit.is_broadcast || (flit.is_broadcast && flit.local_reserved)) {
+                    if ((current_level_tx[o] == ack_tx[o].read()) &&
+                        (buffer_full_status_tx[o].read().mask[vc] == false)) {
+                        // if (GlobalParams::verbose_mode > VERBOSE_OFF)
+                        LOG << "Input[" << i << "][" << vc << "] forwarded to Output[" << o << "], flit: " << flit
+                            << endl;
+
+                        // Cleat broadcast attribute
+                        flit.local_reserved = false;
+
+                        pending_flit_tx[o] = flit;
+                        pending_tx |= 1 << o;
+                        current_level_tx[o] = 1 - current_level_tx[o];
+                        buffer[i][vc].Pop();
+                        telemetry.tx_flits[o]++;
+
+                        if (flit.flit_type == FLIT_TYPE_TAIL) {
+                            TReservation r;
+                            r.input = i;
+                            r.vc = vc;
+                            reservation_table.release(r, o);
                         }
-                    } 
-
-                    if (flit.src_id == local_id || flit.dst_id == local_id || !flit.is_broadcast || (flit.is_broadcast && flit.local_reserved)) {
-                        if ((current_level_tx[o] == ack_tx[o].read()) &&
-                            (buffer_full_status_tx[o].read().mask[vc] == false)) {
-                            // if (GlobalParams::verbose_mode > VERBOSE_OFF)
-                            LOG << "Input[" << i << "][" << vc << "] forwarded to Output[" << o << "], flit: " << flit
-                                << endl;
-
-                            // Cleat broadcast attribute
-                            flit.local_reserved = false;
-
-                            flit_tx[o].write(flit);
-                            current_level_tx[o] = 1 - current_level_tx[o];
-                            req_tx[o].write(current_level_tx[o]);
-                            buffer[i][vc].Pop();
-
-                            if (flit.flit_type == FLIT_TYPE_TAIL) {
-                                TReservation r;
-                                r.input = i;
-                                r.vc = vc;
-                                reservation_table.release(r, o);
-                            }
 
-                            /* Power & Stats ------------------------------------------------- */
-                            if (o == DIRECTION_HUB)
-                                power.r2hLink();
-                            else
-                                power.r2rLink();
-
-                            power.bufferRouterPop();
-                            power.crossBar();
-
-                            if (o == DIRECTION_LOCAL) {
-                                power.networkInterface();
-                                LOG << "Consumed flit " << flit << endl;
-                                stats.receivedFlit(sc_time_stamp().to_double() / GlobalParams::clock_period_ps, flit);
-                                if (GlobalParams::max_volume_to_be_drained) {
-                                    if (drained_volume >= GlobalParams::max_volume_to_be_drained)
-                                        sc_stop();
-                                    else {
-                                        drained_volume++;
-                                        local_drained++;
-                                    }
+                        /* Power & Stats ------------------------------------------------- */
+                        if (o == DIRECTION_HUB)
+                            power.r2hLink();
+                        else
+                            power.r2rLink();
+
+                        power.bufferRouterPop();
+                        power.crossBar();
+
+                        if (o == DIRECTION_LOCAL) {
+                            power.networkInterface();
+                            LOG << "Consumed flit " << flit << endl;
+                            stats.receivedFlit(sc_time_stamp().to_double() / GlobalParams::clock_period_ps, flit);
+                            if (GlobalParams::max_volume_to_be_drained) {
+                                if (drained_volume >= GlobalParams::max_volume_to_be_drained)
+                                    sc_stop();
+                                else {
+                                    drained_volume++;
+                                    local_drained++;
                                 }
-                            } else if (i != DIRECTION_LOCAL)  // not generated locally
-                                routed_flits++;
-                            /* End Power & Stats ------------------------------------------------- */
-                            // LOG<<"END_OK_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack=
-                            // "<<ack_tx[o].read()<< endl;
-                        } else {
-                            LOG << " Cannot forward Input[" << i << "][" << vc << "] to Output[" << o << "], flit: " << flit
-                                << endl;
-                            // LOG << " **DEBUG APB: current_level_tx: " << current_level_tx[o] << " ack_tx: " <<
-                            // ack_tx[o].read() << endl;
-                            LOG << " **DEBUG buffer_full_status_tx " << buffer_full_status_tx[o].read().mask[vc] << endl;
-
-                            // LOG<<"END_NO_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack=
-                            // "<<ack_tx[o].read()<< endl;
-                            /*
-                            if (flit.flit_type == FLIT_TYPE_HEAD)
-                            reservation_table.release(i,flit.vc_id,o);
-                            */
+                            }
+                        } else if (i != DIRECTION_LOCAL) {  // not generated locally
+                            routed_flits++;
+                            telemetry.routed_flits++;
                         }
+                        /* End Power & Stats ------------------------------------------------- */
+                        // LOG<<"END_OK_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack=
+                        // "<<ack_tx[o].read()<< endl;
+                    } else {
+                        telemetry.vc_stalls[vc]++;
+                        LOG << " Cannot forward Input[" << i << "][" << vc << "] to Output[" << o << "], flit: " << flit
+                            << endl;
+                        // LOG << " **DEBUG APB: current_level_tx: " << current_level_tx[o] << " ack_tx: " <<
+                        // ack_tx[o].read() << endl;
+                        LOG << " **DEBUG buffer_full_status_tx " << buffer_full_status_tx[o].read().mask[vc] << endl;
+
+                        // LOG<<"END_NO_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack=
+                        // "<<ack_tx[o].read()<< endl;
+                        /*
+                        if (flit.flit_type == FLIT_TYPE_HEAD)
+                        reservation_table.release(i,flit.vc_id,o);
+                        */
                     }
-				}
-			}  // if not reserved
-			// else LOG<<"we have no reservation for direction "<<i<< endl;
-		}  // for loop directions
+                }
+			}
+		}  // if not reserved
+		// else LOG<<"we have no reservation for direction "<<i<< endl;
+	}  // for loop directions
+
+	if ((int)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps) % 2 == 0)
+		reservation_table.updateIndex();
+}
+
+void Router::driveOutputs() {
+	for (int o = 0; pending_tx != 0; o++, pending_tx >>= 1) {
+		if (pending_tx & 1) {
+			flit_tx[o].write(pending_flit_tx[o]);
+			req_tx[o].write(current_level_tx[o]);
+		}
+	}
 
-		if ((int)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps) % 2 == 0)
-			reservation_table.updateIndex();
+	if (pending_broadcast) {
+		flit_broadcast.write(pending_flit_broadcast);
+		req_broadcast.write(current_level_broadcast);
+		pending_broadcast = false;
 	}
 }
 
@@ -285,15 +319,8 @@ void Router::perCycleUpdate() {
 	} else {
 		selectionStrategy->perCycleUpdate(this);
 
-		power.leakageRouter();
-		for (int i = 0; i < DIRECTIONS + 1; i++) {
-			for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++) {
-				power.leakageBufferRouter();
-				power.leakageLinkRouter2Router();
-			}
-		}
-
-		power.leakageLinkRouter2Hub();
+		// logic, (DIRECTIONS + 1) x n_virtual_channels buffers and hub link
+		power.leakageRouterCycle();
 	}
 }
 
@@ -428,7 +455,30 @@ int Router::route(const RouteData &route_data) {
 		return DIRECTION_LOCAL;
 
 	power.routing();
-	vector<int> candidate_channels = routingFunction(route_data);
+
+	if (route_lut.size()) {
+		// HBM destinations (negative ids) follow the nodes
+		int n_nodes = GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y;
+		int slot = route_data.dst_id >= 0 ? route_data.dst_id : n_nodes - 1 - route_data.dst_id;
+		RouteLUTEntry &entry = route_lut[slot * (DIRECTIONS + 2) + route_data.dir_in];
+
+		if (entry.size == 0) {
+			vector<int> directions = routingFunction(route_data);
+			assert(directions.size() > 0 && directions.size() <= DIRECTIONS + 1);
+
+			entry.size = directions.size();
+			for (unsigned int k = 0; k < directions.size(); k++) entry.dirs[k] = directions[k];
+		}
+
+		power.selection();
+		if (entry.size == 1)
+			return entry.dirs[0];
+
+		candidate_channels.assign(entry.dirs, entry.dirs + entry.size);
+		return selectionStrategy->apply(this, candidate_channels, route_data);
+	}
+
+	candidate_channels = routingFunction(route_data);
 
 	power.selection();
 	return selectionFunction(candidate_channels, route_data);
@@ -479,6 +529,9 @@ void Router::configure(const int _id, const double _warm_up_time, const unsigned
 	local_id = _id;
 	stats.configure(_id, _warm_up_time);
 
+	seed_seq seq{GlobalParams::rnd_generator_seed, _id};
+	rng.seed(seq);
+
 	start_from_port = DIRECTION_LOCAL;
 
 	if (grt.isValid())
@@ -486,6 +539,16 @@ void Router::configure(const int _id, const double _warm_up_time, const unsigned
 
 	reservation_table.setSize(DIRECTIONS + 2);
 
+	// routingFunction() diverts to the hubs when winoc is enabled, hence its
+	// result is not a function of (dst_id, dir_in) only
+	route_lut.clear();
+	if (GlobalParams::topology == TOPOLOGY_MESH && !GlobalParams::use_winoc && routingAlgorithm->isStatic()) {
+		RouteLUTEntry empty = {0, {0}};
+		int n_hbm_destinations = HBM_EDGES * (max(GlobalParams::mesh_dim_x, GlobalParams::mesh_dim_y) + 1);
+		route_lut.assign((GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y + n_hbm_destinations) * (DIRECTIONS + 2),
+		                 empty);
+	}
+
 	for (int i = 0; i < DIRECTIONS + 2; i++) {
 		for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++) {
 			buffer[i][vc].SetMaxBufferSize(_max_buffer_size);
@@ -511,6 +574,11 @@ void Router::configure(const int _id, const double _warm_up_time, const unsigned
 	}
 }
 
+int Router::randomIndex(const int size) {
+	assert(size > 0);
+	return rng() % size;
+}
+
 unsigned long Router::getRoutedFlits() {
 	return routed_flits;
 }
@@ -588,17 +656,33 @@ bool Router::connectedHubs(int src_hub, int dst_hub) {
 	vector<int> &first = GlobalParams::hub_configuration[src_hub].txChannels;
 	vector<int> &second = GlobalParams::hub_configuration[dst_hub].rxChannels;
 
-	vector<int> intersection;
-
+	// hubs are connected as soon as they share a channel
 	for (unsigned int i = 0; i < first.size(); i++) {
 		for (unsigned int j = 0; j < second.size(); j++) {
 			if (first[i] == second[j])
-				intersection.push_back(first[i]);
+				return true;
 		}
 	}
 
-	if (intersection.size() == 0)
-		return false;
-	else
-		return true;
+	return false;
+}
+
+void Router::serialize(Checkpoint &ckpt) {
+	ckpt.section(name());
+
+	for (int i = 0; i < DIRECTIONS + 2; i++)
+		for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++)
+			buffer[i][vc].serialize(ckpt);
+	ckpt.io(current_level_rx);
+	ckpt.io(current_level_tx);
+	ckpt.io(current_level_broadcast);
+	stats.serialize(ckpt);
+	power.serialize(ckpt);
+	reservation_table.serialize(ckpt);
+	ckpt.io(routed_flits);
+	ckpt.io(telemetry);
+	ckpt.io(start_from_port);
+	ckpt.io(start_from_vc);
+	ckpt.io(rng);
+	ckpt.io(local_drained);
 }
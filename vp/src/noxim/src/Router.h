@@ -13,6 +13,7 @@
 
 #include <systemc.h>
 #include <tlm.h>
+#include <random>
 #include <tlm_utils/simple_initiator_socket.h>
 #include <tlm_utils/simple_target_socket.h>
 
@@ -22,6 +23,7 @@
 #include "LocalRoutingTable.h"
 #include "ReservationTable.h"
 #include "Stats.h"
+#include "Telemetry.h"
 #include "Utils.h"
 #include "routingAlgorithms/RoutingAlgorithm.h"
 #include "routingAlgorithms/RoutingAlgorithms.h"
@@ -77,14 +79,18 @@ SC_MODULE(Router) {
 	LocalRoutingTable routing_table;     // Routing table
 	ReservationTable reservation_table;  // Switch reservation table
 	unsigned long routed_flits;
+	RouterTelemetry telemetry;           // Activity of the current telemetry window
 	RoutingAlgorithm *routingAlgorithm;
 	SelectionStrategy *selectionStrategy;
 
 	// Functions
 
 	void process();
-	void rxProcess();  // The receiving process
-	void txProcess();  // The transmitting process
+	void rxProcess();       // The receiving process
+	void txProcess();       // The transmitting process
+	void txReservation();   // 1st phase of txProcess(), only touches router-local state
+	void txForwarding();    // 2nd phase of txProcess(), picks the flits to send
+	void driveOutputs();    // Last phase of txProcess(), writes the flits picked to the output ports
 	void perCycleUpdate();
 	void configure(const int _id, const double _warm_up_time, const unsigned int _max_buffer_size,
 	               GlobalRoutingTable &grt);
@@ -94,13 +100,19 @@ SC_MODULE(Router) {
 	// Constructor
 
 	SC_CTOR(Router) {
-		SC_METHOD(process);
-		sensitive << reset;
-		sensitive << clock.pos();
-
-		SC_METHOD(perCycleUpdate);
-		sensitive << reset;
-		sensitive << clock.pos();
+		pending_tx = 0;
+		pending_broadcast = false;
+
+		// With noc_threads > 1 the NoC steps all the routers itself
+		if (GlobalParams::noc_threads <= 1) {
+			SC_METHOD(process);
+			sensitive << reset;
+			sensitive << clock.pos();
+
+			SC_METHOD(perCycleUpdate);
+			sensitive << reset;
+			sensitive << clock.pos();
+		}
 
 		routingAlgorithm = RoutingAlgorithms::get(GlobalParams::routing_algorithm);
 
@@ -139,11 +151,33 @@ SC_MODULE(Router) {
 
 	vector<int> nextDeltaHops(RouteData rd);
 
+	mt19937 rng;  // Per-router generator, results do not depend on evaluation order
+
+	// Flits picked by txForwarding() for the output ports until
+	// driveOutputs(), which only has to be sequential
+	Flit pending_flit_tx[DIRECTIONS + 2];
+	int pending_tx;  // Bit mask of the outputs with a pending flit
+	Flit pending_flit_broadcast;
+	bool pending_broadcast;
+
+	// Cached routes of static routing algorithms (see RoutingAlgorithm::isStatic),
+	// indexed by [dst_id][dir_in], the HBM destinations (negative dst_id)
+	// following the nodes, and filled on first use
+	struct RouteLUTEntry {
+		unsigned char size;  // 0 = not computed yet
+		unsigned char dirs[DIRECTIONS + 1];
+	};
+	vector<RouteLUTEntry> route_lut;
+	vector<int> candidate_channels;  // Reused by route() to avoid per-flit allocations
+
    public:
 	unsigned int local_drained;
 
+	int randomIndex(const int size);  // Uniform index in [0, size)
+
 	bool inCongestion();
 	void ShowBuffersStats(std::ostream & out);
+	void serialize(Checkpoint &ckpt);  // Save or restore buffers, reservations and statistics
 
 	bool connectedHubs(int src_hub, int dst_hub);
 };
@@ -9,9 +9,81 @@
  */
 
 #include "Stats.h"
+#include "Checkpoint.h"
 
 // TODO: nan in averageDelay
 
+unsigned int DelayHistogram::bucketIndex(const unsigned long value)
+{
+    if (value < 2 * DH_SUB_BUCKETS)
+	return value;
+
+    // keep DH_SUB_BUCKETS_BITS + 1 significant bits
+    int shift = 63 - __builtin_clzl(value) - DH_SUB_BUCKETS_BITS;
+
+    return shift * DH_SUB_BUCKETS + (value >> shift);
+}
+
+double DelayHistogram::bucketValue(const unsigned int index)
+{
+    if (index < 2 * DH_SUB_BUCKETS)
+	return index;
+
+    int shift = index / DH_SUB_BUCKETS - 1;
+    unsigned long low =
+	(unsigned long) (DH_SUB_BUCKETS + index % DH_SUB_BUCKETS) << shift;
+
+    // middle of the range of values falling in the bucket
+    return low + ((1UL << shift) - 1) / 2.0;
+}
+
+void DelayHistogram::add(const double delay)
+{
+    unsigned long value = delay > 0.0 ? (unsigned long) (delay + 0.5) : 0;
+    unsigned int i = bucketIndex(value);
+
+    if (i >= buckets.size())
+	buckets.resize(i + 1, 0);
+
+    buckets[i]++;
+    total++;
+}
+
+void DelayHistogram::merge(const DelayHistogram & h)
+{
+    if (h.buckets.size() > buckets.size())
+	buckets.resize(h.buckets.size(), 0);
+
+    for (unsigned int i = 0; i < h.buckets.size(); i++)
+	buckets[i] += h.buckets[i];
+    total += h.total;
+}
+
+void DelayHistogram::serialize(Checkpoint & ckpt)
+{
+    ckpt.io(buckets);
+    ckpt.io(total);
+}
+
+double DelayHistogram::percentile(const double p) const
+{
+    if (total == 0)
+	return -1.0;
+
+    unsigned long rank = (unsigned long) ceil(p * total);
+    if (rank == 0)
+	rank = 1;
+
+    unsigned long seen = 0;
+    for (unsigned int i = 0; i < buckets.size(); i++) {
+	seen += buckets[i];
+	if (seen >= rank)
+	    return bucketValue(i);
+    }
+
+    return bucketValue(buckets.size() - 1);
+}
+
 void Stats::configure(const int node_id, const double _warm_up_time)
 {
     id = node_id;
@@ -32,14 +104,33 @@ void Stats::receivedFlit(const double arrival_time,
 	CommHistory ch;
 
 	ch.src_id = flit.src_id;
+	ch.received_packets = 0;
 	ch.total_received_flits = 0;
+	ch.delay_mean = 0.0;
+	ch.delay_m2 = 0.0;
+	ch.delay_max = -1.0;
 	chist.push_back(ch);
 
 	i = chist.size() - 1;
+
+	int key = chistKey(flit.src_id);
+	if (key >= (int) chist_index.size())
+	    chist_index.resize(key + 1, -1);
+	chist_index[key] = i;
     }
 
-    if (flit.flit_type == FLIT_TYPE_HEAD)
-	chist[i].delays.push_back(arrival_time - flit.timestamp);
+    if (flit.flit_type == FLIT_TYPE_HEAD) {
+	CommHistory & ch = chist[i];
+	double delay = arrival_time - flit.timestamp;
+	double delta = delay - ch.delay_mean;
+
+	ch.received_packets++;
+	ch.delay_mean += delta / ch.received_packets;
+	ch.delay_m2 += delta * (delay - ch.delay_mean);
+	if (delay > ch.delay_max)
+	    ch.delay_max = delay;
+	ch.delay_histogram.add(delay);
+    }
 
     chist[i].total_received_flits++;
     chist[i].last_received_flit_time = arrival_time - warm_up_time;
@@ -47,16 +138,14 @@ void Stats::receivedFlit(const double arrival_time,
 
 double Stats::getAverageDelay(const int src_id)
 {
-    double sum = 0.0;
-
     int i = searchCommHistory(src_id);
 
     assert(i >= 0);
 
-    for (unsigned int j = 0; j < chist[i].delays.size(); j++)
-	sum += chist[i].delays[j];
+    if (chist[i].received_packets == 0)
+	return NAN;
 
-    return sum / (double) chist[i].delays.size();
+    return chist[i].delay_mean;
 }
 
 double Stats::getAverageDelay()
@@ -64,9 +153,9 @@ double Stats::getAverageDelay()
     double avg = 0.0;
 
     for (unsigned int k = 0; k < chist.size(); k++) {
-	unsigned int samples = chist[k].delays.size();
+	unsigned long samples = chist[k].received_packets;
 	if (samples)
-	    avg += (double) samples *getAverageDelay(chist[k].src_id);
+	    avg += (double) samples *chist[k].delay_mean;
     }
 
     return avg / (double) getReceivedPackets();
@@ -74,35 +163,51 @@ double Stats::getAverageDelay()
 
 double Stats::getMaxDelay(const int src_id)
 {
-    double maxd = -1.0;
-
     int i = searchCommHistory(src_id);
 
     assert(i >= 0);
 
-    for (unsigned int j = 0; j < chist[i].delays.size(); j++)
-	if (chist[i].delays[j] > maxd) {
-	    maxd = chist[i].delays[j];
-	}
-    return maxd;
+    return chist[i].delay_max;
 }
 
 double Stats::getMaxDelay()
 {
     double maxd = -1.0;
 
-    for (unsigned int k = 0; k < chist.size(); k++) {
-	unsigned int samples = chist[k].delays.size();
-	if (samples) {
-	    double m = getMaxDelay(chist[k].src_id);
-	    if (m > maxd)
-		maxd = m;
-	}
-    }
+    for (unsigned int k = 0; k < chist.size(); k++)
+	if (chist[k].delay_max > maxd)
+	    maxd = chist[k].delay_max;
 
     return maxd;
 }
 
+double Stats::getDelayVariance(const int src_id)
+{
+    int i = searchCommHistory(src_id);
+
+    assert(i >= 0);
+
+    if (chist[i].received_packets < 2)
+	return 0.0;
+
+    return chist[i].delay_m2 / (chist[i].received_packets - 1);
+}
+
+double Stats::getDelayPercentile(const int src_id, const double p)
+{
+    int i = searchCommHistory(src_id);
+
+    assert(i >= 0);
+
+    return min(chist[i].delay_histogram.percentile(p), chist[i].delay_max);
+}
+
+void Stats::collectDelays(DelayHistogram & h) const
+{
+    for (unsigned int k = 0; k < chist.size(); k++)
+	h.merge(chist[k].delay_histogram);
+}
+
 double Stats::getAverageThroughput(const int src_id)
 {
     int i = searchCommHistory(src_id);
@@ -139,7 +244,7 @@ unsigned int Stats::getReceivedPackets()
     int n = 0;
 
     for (unsigned int i = 0; i < chist.size(); i++)
-	n += chist[i].delays.size();
+	n += chist[i].received_packets;
 
     return n;
 }
@@ -185,11 +290,11 @@ double Stats::getCommunicationEnergy(int src_id, int dst_id)
 
 int Stats::searchCommHistory(int src_id)
 {
-    for (unsigned int i = 0; i < chist.size(); i++)
-	if (chist[i].src_id == src_id)
-	    return i;
+    int key = chistKey(src_id);
+    if (key >= (int) chist_index.size())
+	return -1;
 
-    return -1;
+    return chist_index[key];
 }
 
 void Stats::showStats(int curr_node, std::ostream & out, bool header)
@@ -202,7 +307,11 @@ void Stats::showStats(int curr_node, std::ostream & out, bool header)
 	    << setw(10) << "delay max"
 	    << setw(15) << "throughput"
 	    << setw(13) << "energy"
-	    << setw(12) << "received" << setw(12) << "received" << endl;
+	    << setw(12) << "received" << setw(12) << "received"
+	    << setw(10) << "delay std"
+	    << setw(10) << "delay p50"
+	    << setw(10) << "delay p95"
+	    << setw(10) << "delay p99" << endl;
 	out << "%"
 	    << setw(5) << ""
 	    << setw(5) << ""
@@ -210,7 +319,11 @@ void Stats::showStats(int curr_node, std::ostream & out, bool header)
 	    << setw(10) << "cycles"
 	    << setw(15) << "flits/cycle"
 	    << setw(13) << "Joule"
-	    << setw(12) << "packets" << setw(12) << "flits" << endl;
+	    << setw(12) << "packets" << setw(12) << "flits"
+	    << setw(10) << "cycles"
+	    << setw(10) << "cycles"
+	    << setw(10) << "cycles"
+	    << setw(10) << "cycles" << endl;
     }
     for (unsigned int i = 0; i < chist.size(); i++) {
 	out << " "
@@ -221,8 +334,12 @@ void Stats::showStats(int curr_node, std::ostream & out, bool header)
 	    << setw(15) << getAverageThroughput(chist[i].src_id)
 	    << setw(13) << getCommunicationEnergy(chist[i].src_id,
 						  curr_node)
-	    << setw(12) << chist[i].delays.size()
-	    << setw(12) << chist[i].total_received_flits << endl;
+	    << setw(12) << chist[i].received_packets
+	    << setw(12) << chist[i].total_received_flits
+	    << setw(10) << sqrt(getDelayVariance(chist[i].src_id))
+	    << setw(10) << getDelayPercentile(chist[i].src_id, 0.50)
+	    << setw(10) << getDelayPercentile(chist[i].src_id, 0.95)
+	    << setw(10) << getDelayPercentile(chist[i].src_id, 0.99) << endl;
     }
 
     out << "% Aggregated average delay (cycles): " << getAverageDelay() <<
@@ -230,3 +347,24 @@ void Stats::showStats(int curr_node, std::ostream & out, bool header)
     out << "% Aggregated average throughput (flits/cycle): " <<
 	getAverageThroughput() << endl;
 }
+
+void Stats::serialize(Checkpoint & ckpt)
+{
+    uint64_t n = chist.size();
+
+    ckpt.io(id);
+    ckpt.io(n);
+    chist.resize(n);
+    for (unsigned int i = 0; i < chist.size(); i++) {
+	ckpt.io(chist[i].src_id);
+	ckpt.io(chist[i].received_packets);
+	ckpt.io(chist[i].total_received_flits);
+	ckpt.io(chist[i].last_received_flit_time);
+	ckpt.io(chist[i].delay_mean);
+	ckpt.io(chist[i].delay_m2);
+	ckpt.io(chist[i].delay_max);
+	chist[i].delay_histogram.serialize(ckpt);
+    }
+    ckpt.io(chist_index);
+    ckpt.io(warm_up_time);
+}
@@ -11,6 +11,7 @@
 #ifndef __NOXIMSTATS_H__
 #define __NOXIMSTATS_H__
 
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -18,11 +19,58 @@
 #include "Power.h"
 using namespace std;
 
+class Checkpoint;
+
+// Log-bucketed delay histogram (HDR-style): values below
+// 2*DH_SUB_BUCKETS cycles are exact, above that each power of two is
+// split into DH_SUB_BUCKETS buckets, giving a relative error below
+// 1/DH_SUB_BUCKETS. Buckets are only allocated up to the largest
+// magnitude seen, so memory does not depend on the number of samples.
+#define DH_SUB_BUCKETS_BITS 4
+#define DH_SUB_BUCKETS (1 << DH_SUB_BUCKETS_BITS)
+
+class DelayHistogram {
+
+  public:
+
+    DelayHistogram() : total(0) {
+    }
+
+    void add(const double delay);
+
+    // Adds the samples of another histogram
+    void merge(const DelayHistogram & h);
+
+    void serialize(Checkpoint & ckpt);
+
+    // Returns the delay below which the fraction p (0..1] of the
+    // samples lies, -1.0 if no sample has been recorded
+    double percentile(const double p) const;
+
+    unsigned long samples() const {
+	return total;
+    }
+
+  private:
+
+    vector < unsigned long >buckets;
+    unsigned long total;
+
+    static unsigned int bucketIndex(const unsigned long value);
+    static double bucketValue(const unsigned int index);
+};
+
 struct CommHistory {
     int src_id;
-     vector < double >delays;
+    unsigned long received_packets;
     unsigned int total_received_flits;
     double last_received_flit_time;
+
+    // Running delay statistics of the head flits (Welford)
+    double delay_mean;
+    double delay_m2;
+    double delay_max;
+    DelayHistogram delay_histogram;
 };
 
 class Stats {
@@ -51,6 +99,18 @@ class Stats {
     // Returns the max delay (cycles) for the current node
     double getMaxDelay();
 
+    // Returns the delay variance (cycles^2) for the current node as
+    // regards the communication whose source node is src_id
+    double getDelayVariance(const int src_id);
+
+    // Returns the p-th (0..1] delay percentile (cycles) for the
+    // current node as regards the communication whose source node is
+    // src_id
+    double getDelayPercentile(const int src_id, const double p);
+
+    // Adds to h the delays received by the current node
+    void collectDelays(DelayHistogram & h) const;
+
     // Returns the average throughput (flits/cycle) for the current node
     // and for the communication whose source is src_id
     double getAverageThroughput(const int src_id);
@@ -78,14 +138,21 @@ class Stats {
     void showStats(int curr_node, std::ostream & out =
 		   std::cout, bool header = false);
 
+    // Saves or restores the communication histories
+    void serialize(Checkpoint & ckpt);
+
 
   private:
 
     int id;
     vector < CommHistory > chist;
+    vector < int >chist_index;	// chistKey(src_id) -> position in chist, -1 if none
     double warm_up_time;
 
     int searchCommHistory(int src_id);
+
+    // HBM controllers have negative ids: interleave them with the nodes
+    static int chistKey(int src_id) { return src_id >= 0 ? 2 * src_id : -2 * src_id - 1; }
 };
 
 #endif
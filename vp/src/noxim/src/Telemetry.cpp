@@ -0,0 +1,159 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the periodic telemetry stream
+ */
+
+#include "Telemetry.h"
+
+#include <iostream>
+
+static void writeU32(ofstream &out, const uint32_t value) {
+	out.write((const char *)&value, sizeof(value));
+}
+
+Telemetry::Telemetry(const string &filename, const string &format, const int period, const int n_routers,
+                     const vector<string> &router_columns, const int n_hbm, const vector<string> &hbm_columns)
+    : n_routers(n_routers), n_hbm(n_hbm), router_columns(router_columns), hbm_columns(hbm_columns), stop(false) {
+	if (format == TELEMETRY_CSV || format == TELEMETRY_BOTH) {
+		routers_csv.open((filename + ".routers.csv").c_str());
+		hbm_csv.open((filename + ".hbm.csv").c_str());
+		if (!routers_csv || !hbm_csv) {
+			cerr << "Error: cannot open telemetry file " << filename << ".*.csv" << endl;
+			exit(1);
+		}
+
+		routers_csv << "cycle,node";
+		for (unsigned int c = 0; c < router_columns.size(); c++) routers_csv << "," << router_columns[c];
+		routers_csv << endl;
+
+		// HBM_CTRL ids, the channels a controller serves depend on hbm_ctrl_mapping
+		hbm_csv << "cycle,controller";
+		for (unsigned int c = 0; c < hbm_columns.size(); c++) hbm_csv << "," << hbm_columns[c];
+		hbm_csv << endl;
+	}
+
+	if (format == TELEMETRY_BINARY || format == TELEMETRY_BOTH) {
+		bin.open((filename + ".bin").c_str(), ios::binary);
+		if (!bin) {
+			cerr << "Error: cannot open telemetry file " << filename << ".bin" << endl;
+			exit(1);
+		}
+
+		bin.write("NXTM", 4);
+		writeU32(bin, 1);
+		writeU32(bin, period);
+		writeU32(bin, n_routers);
+		writeU32(bin, router_columns.size());
+		writeU32(bin, n_hbm);
+		writeU32(bin, hbm_columns.size());
+		for (unsigned int c = 0; c < router_columns.size(); c++)
+			bin.write(router_columns[c].c_str(), router_columns[c].size() + 1);
+		for (unsigned int c = 0; c < hbm_columns.size(); c++)
+			bin.write(hbm_columns[c].c_str(), hbm_columns[c].size() + 1);
+	}
+
+	writer_thread = thread(&Telemetry::writer, this);
+}
+
+Telemetry::~Telemetry() {
+	close();
+
+	for (unsigned int i = 0; i < recycled.size(); i++) delete recycled[i];
+}
+
+TelemetrySnapshot *Telemetry::acquire(const unsigned long cycle) {
+	TelemetrySnapshot *snapshot = NULL;
+	{
+		lock_guard<mutex> lock(m);
+		if (!recycled.empty()) {
+			snapshot = recycled.back();
+			recycled.pop_back();
+		}
+	}
+
+	if (snapshot == NULL) {
+		snapshot = new TelemetrySnapshot;
+		snapshot->routers.resize(router_columns.size() * n_routers);
+		snapshot->hbm.resize(hbm_columns.size() * n_hbm);
+	}
+	snapshot->cycle = cycle;
+
+	return snapshot;
+}
+
+void Telemetry::push(TelemetrySnapshot *snapshot) {
+	{
+		lock_guard<mutex> lock(m);
+		pending.push_back(snapshot);
+	}
+	cv.notify_one();
+}
+
+void Telemetry::close() {
+	if (!writer_thread.joinable())
+		return;
+
+	{
+		lock_guard<mutex> lock(m);
+		stop = true;
+	}
+	cv.notify_one();
+	writer_thread.join();
+
+	if (routers_csv.is_open()) {
+		routers_csv.close();
+		hbm_csv.close();
+	}
+	if (bin.is_open())
+		bin.close();
+}
+
+void Telemetry::writer() {
+	while (true) {
+		TelemetrySnapshot *snapshot;
+		{
+			unique_lock<mutex> lock(m);
+			cv.wait(lock, [this] { return stop || !pending.empty(); });
+			if (pending.empty())
+				return;  // stop requested and nothing left to write
+			snapshot = pending.front();
+			pending.pop_front();
+		}
+
+		if (routers_csv.is_open())
+			writeCSV(*snapshot);
+		if (bin.is_open())
+			writeBinary(*snapshot);
+
+		lock_guard<mutex> lock(m);
+		recycled.push_back(snapshot);
+	}
+}
+
+void Telemetry::writeCSV(const TelemetrySnapshot &snapshot) {
+	for (int n = 0; n < n_routers; n++) {
+		routers_csv << snapshot.cycle << "," << n;
+		for (unsigned int c = 0; c < router_columns.size(); c++)
+			routers_csv << "," << snapshot.routers[c * n_routers + n];
+		routers_csv << "\n";
+	}
+
+	for (int n = 0; n < n_hbm; n++) {
+		hbm_csv << snapshot.cycle << "," << n;
+		for (unsigned int c = 0; c < hbm_columns.size(); c++) hbm_csv << "," << snapshot.hbm[c * n_hbm + n];
+		hbm_csv << "\n";
+	}
+}
+
+void Telemetry::writeBinary(const TelemetrySnapshot &snapshot) {
+	uint64_t cycle = snapshot.cycle;
+
+	bin.write((const char *)&cycle, sizeof(cycle));
+	bin.write((const char *)snapshot.routers.data(), snapshot.routers.size() * sizeof(uint32_t));
+	bin.write((const char *)snapshot.hbm.data(), snapshot.hbm.size() * sizeof(uint32_t));
+}
@@ -0,0 +1,104 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the periodic telemetry stream
+ */
+
+#ifndef __NOXIMTELEMETRY_H__
+#define __NOXIMTELEMETRY_H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GlobalParams.h"
+
+using namespace std;
+
+// Router activity accumulated over the current telemetry window
+struct RouterTelemetry {
+	unsigned long tx_flits[DIRECTIONS + 2];         // Flits sent on each output port
+	unsigned long vc_stalls[MAX_VIRTUAL_CHANNELS];  // Cycles a reserved flit could not be forwarded
+	unsigned long routed_flits;
+
+	void clear() { memset(this, 0, sizeof(*this)); }
+};
+
+// HBM controller activity accumulated over the current telemetry window
+struct HBMTelemetry {
+	unsigned long rx_flits;
+	unsigned long tx_flits;
+	unsigned long reads;   // Read transactions issued to the HBM
+	unsigned long writes;  // Write transactions issued to the HBM
+
+	void clear() { memset(this, 0, sizeof(*this)); }
+};
+
+// Values sampled at the end of a window, stored column by column:
+// value of column c for node n is at [c * n_nodes + n]
+struct TelemetrySnapshot {
+	unsigned long cycle;
+	vector<uint32_t> routers;
+	vector<uint32_t> hbm;
+};
+
+/* Snapshots are handed to a background thread which writes them to
+ * <filename>.routers.csv and <filename>.hbm.csv (one row per node, or
+ * HBM controller, and window) and/or to <filename>.bin, laid out as
+ * follows (host byte order):
+ *
+ *   header:  "NXTM", u32 version, u32 period, u32 n_routers,
+ *            u32 n_router_columns, u32 n_hbm, u32 n_hbm_columns,
+ *            NUL terminated column names (routers first, then hbm)
+ *   windows: u64 cycle, u32 routers[n_router_columns][n_routers],
+ *            u32 hbm[n_hbm_columns][n_hbm]
+ */
+class Telemetry {
+   public:
+	Telemetry(const string &filename, const string &format, const int period, const int n_routers,
+	          const vector<string> &router_columns, const int n_hbm, const vector<string> &hbm_columns);
+	~Telemetry();
+
+	// Returns a snapshot sized for the configured columns, to be filled
+	// and handed back with push()
+	TelemetrySnapshot *acquire(const unsigned long cycle);
+	void push(TelemetrySnapshot *snapshot);
+
+	// Writes the pending snapshots and closes the files
+	void close();
+
+	int getHBMCount() const { return n_hbm; }
+
+   private:
+	void writer();
+	void writeCSV(const TelemetrySnapshot &snapshot);
+	void writeBinary(const TelemetrySnapshot &snapshot);
+
+	int n_routers;
+	int n_hbm;
+	vector<string> router_columns;
+	vector<string> hbm_columns;
+
+	ofstream routers_csv;
+	ofstream hbm_csv;
+	ofstream bin;
+
+	mutex m;
+	condition_variable cv;
+	deque<TelemetrySnapshot *> pending;
+	vector<TelemetrySnapshot *> recycled;  // Written snapshots, reused to avoid allocations
+	bool stop;
+	thread writer_thread;
+};
+
+#endif
@@ -209,6 +209,40 @@ inline int coord2Id(const Coord & coord)
     return id;
 }
 
+// HBM destinations, see HBM_EDGES
+
+inline int hbmDestination(const int edge, const int ctrl)
+{
+    return -(edge + 1) - (ctrl == NOT_VALID ? 0 : HBM_EDGES * (ctrl + 1));
+}
+
+inline int hbmEdge(const int dst_id)
+{
+    assert(dst_id < 0);
+    return (-dst_id - 1) % HBM_EDGES;
+}
+
+inline int hbmController(const int dst_id)
+{
+    assert(dst_id < 0);
+    return (-dst_id - 1) / HBM_EDGES - 1;  // NOT_VALID when the nearest one
+}
+
+// Controllers on an edge: one per row (WEST/EAST) or column (NORTH/SOUTH)
+inline int hbmEdgeLength(const int edge)
+{
+    return (edge == HBM_EDGE_WEST || edge == HBM_EDGE_EAST) ? GlobalParams::mesh_dim_y : GlobalParams::mesh_dim_x;
+}
+
+inline int hbmEdgeId(const string & name)
+{
+    if (name == "WEST") return HBM_EDGE_WEST;
+    if (name == "EAST") return HBM_EDGE_EAST;
+    if (name == "NORTH") return HBM_EDGE_NORTH;
+    if (name == "SOUTH") return HBM_EDGE_SOUTH;
+    return NOT_VALID;
+}
+
 inline bool sameRadioHub(int id1, int id2)
 {
     map<int, int>::iterator it1 = GlobalParams::hub_for_tile.find(id1); 
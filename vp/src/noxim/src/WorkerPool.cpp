@@ -0,0 +1,75 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the persistent worker pool used
+ * for the parallel evaluation of the NoC
+ */
+
+#include "WorkerPool.h"
+
+#include <cassert>
+
+WorkerPool::WorkerPool(const int n_threads)
+    : n_threads(n_threads), current_job(0), generation(0), pending(0), stop(false) {
+	assert(n_threads >= 1);
+
+	for (int i = 1; i < n_threads; i++) threads.push_back(thread(&WorkerPool::worker, this, i));
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		lock_guard<mutex> lock(m);
+		stop = true;
+	}
+	cv_start.notify_all();
+
+	for (unsigned int i = 0; i < threads.size(); i++) threads[i].join();
+}
+
+void WorkerPool::run(const function<void(int)> &job) {
+	if (n_threads == 1) {
+		job(0);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m);
+		current_job = &job;
+		pending = n_threads - 1;
+		generation++;
+	}
+	cv_start.notify_all();
+
+	job(0);
+
+	unique_lock<mutex> lock(m);
+	cv_done.wait(lock, [this] { return pending == 0; });
+	current_job = 0;
+}
+
+void WorkerPool::worker(const int id) {
+	unsigned long seen = 0;
+
+	while (true) {
+		const function<void(int)> *job;
+		{
+			unique_lock<mutex> lock(m);
+			cv_start.wait(lock, [this, seen] { return stop || generation != seen; });
+			if (stop)
+				return;
+			seen = generation;
+			job = current_job;
+		}
+
+		(*job)(id);
+
+		if (--pending == 0) {
+			lock_guard<mutex> lock(m);
+			cv_done.notify_one();
+		}
+	}
+}
@@ -0,0 +1,51 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the persistent worker pool used
+ * for the parallel evaluation of the NoC
+ */
+
+#ifndef __NOXIMWORKERPOOL_H__
+#define __NOXIMWORKERPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class WorkerPool {
+   public:
+	// Spawns n_threads - 1 workers, the calling thread acts as worker 0
+	WorkerPool(const int n_threads);
+	~WorkerPool();
+
+	// Executes job(p) for every partition p in [0, size()) and returns
+	// once all of them are done (i.e. acts as a barrier)
+	void run(const function<void(int)> &job);
+
+	int size() const { return n_threads; }
+
+   private:
+	void worker(const int id);
+
+	int n_threads;
+	vector<thread> threads;
+
+	mutex m;
+	condition_variable cv_start;
+	condition_variable cv_done;
+	const function<void(int)> *current_job;
+	unsigned long generation;
+	atomic<int> pending;
+	bool stop;
+};
+
+#endif
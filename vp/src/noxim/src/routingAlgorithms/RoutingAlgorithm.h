@@ -13,6 +13,10 @@ class RoutingAlgorithm
 {
 	public:
 		virtual vector<int> route(Router * router, const RouteData & routeData) = 0;
+
+		// True when the result only depends on current_id, dst_id and dir_in,
+		// so that the router can cache it (see Router::route)
+		virtual bool isStatic() const { return false; }
 };
 
 #endif
@@ -18,14 +18,14 @@ vector<int> Routing_TABLE_BASED::route(Router * router, const RouteData & routeD
 
     AdmissibleOutputs ao = router->routing_table.getAdmissibleOutputs(routeData.dir_in, routeData.dst_id);
 
-    if (ao.size() == 0) {
+    if (ao == 0) {
         LOG << "dir: " << routeData.dir_in << ", (" << current.x << "," << current.
             y << ") --> " << "(" << destination.x << "," << destination.
             y << ")" << endl << routeData.current_id << "->" <<
             routeData.dst_id << endl;
     }
 
-    assert(ao.size() > 0);
+    assert(ao != 0);
 
-    return admissibleOutputsSet2Vector(ao);
+    return admissibleOutputs2Vector(ao);
 }
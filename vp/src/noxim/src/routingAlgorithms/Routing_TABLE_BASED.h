@@ -12,6 +12,7 @@ using namespace std;
 class Routing_TABLE_BASED : RoutingAlgorithm {
 	public:
 		vector<int> route(Router * router, const RouteData & routeData);
+		bool isStatic() const { return true; }
 
 		static Routing_TABLE_BASED * getInstance();
 
@@ -10,6 +10,7 @@ using namespace std;
 class Routing_WEST_FIRST : RoutingAlgorithm {
 	public:
 		vector<int> route(Router * router, const RouteData & routeData);
+		bool isStatic() const { return true; }
 
 		static Routing_WEST_FIRST * getInstance();
 
@@ -16,14 +16,15 @@ vector<int> Routing_XY::route(Router* router, const RouteData& routeData) {
 	Coord current;
 	Coord destination;
 
-    // If the destination is -1, we are sending to the HBM (west)
-    if (routeData.dst_id == -1) {
-        directions.push_back(DIRECTION_WEST);
+	current = id2Coord(routeData.current_id);
+
+    // Negative destinations are HBM controllers on the mesh edges
+    if (routeData.dst_id < 0) {
+        directions.push_back(routeHBM(current, routeData.dst_id));
         return directions;
     }
 
     // Otherwise, we are routing within the mesh
-	current = id2Coord(routeData.current_id);
 	destination = id2Coord(routeData.dst_id);
 
 	if (destination.x > current.x)
@@ -37,3 +38,38 @@ vector<int> Routing_XY::route(Router* router, const RouteData& routeData) {
 
 	return directions;
 }
+
+int Routing_XY::routeHBM(const Coord & current, const int dst_id) {
+	int edge = hbmEdge(dst_id);
+	int ctrl = hbmController(dst_id);
+
+	// Without a given controller, leave the mesh straight through the edge.
+	// Otherwise, for NORTH/SOUTH reach the column of the controller first
+	// (as XY does), for WEST/EAST reach the edge and then move along it
+	switch (edge) {
+		case HBM_EDGE_NORTH:
+		case HBM_EDGE_SOUTH:
+			if (ctrl != NOT_VALID && ctrl > current.x)
+				return DIRECTION_EAST;
+			if (ctrl != NOT_VALID && ctrl < current.x)
+				return DIRECTION_WEST;
+			return edge == HBM_EDGE_NORTH ? DIRECTION_NORTH : DIRECTION_SOUTH;
+
+		case HBM_EDGE_WEST:
+		case HBM_EDGE_EAST: {
+			int edge_x = (edge == HBM_EDGE_WEST) ? 0 : GlobalParams::mesh_dim_x - 1;
+			int exit = (edge == HBM_EDGE_WEST) ? DIRECTION_WEST : DIRECTION_EAST;
+
+			if (ctrl == NOT_VALID || current.x != edge_x)
+				return exit;
+			if (ctrl > current.y)
+				return DIRECTION_SOUTH;
+			if (ctrl < current.y)
+				return DIRECTION_NORTH;
+			return exit;
+		}
+	}
+
+	assert(false);
+	return NOT_VALID;
+}
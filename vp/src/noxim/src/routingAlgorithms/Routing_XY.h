@@ -10,6 +10,7 @@ using namespace std;
 class Routing_XY : RoutingAlgorithm {
 	public:
 		vector<int> route(Router * router, const RouteData & routeData);
+		bool isStatic() const { return true; }
 
 		static Routing_XY * getInstance();
 
@@ -17,6 +18,9 @@ class Routing_XY : RoutingAlgorithm {
 		Routing_XY(){};
 		~Routing_XY(){};
 
+		// Output port towards the HBM controller dst_id (negative)
+		int routeHBM(const Coord & current, const int dst_id);
+
 		static Routing_XY * routing_XY;
 		static RoutingAlgorithmsRegister routingAlgorithmsRegister;
 };
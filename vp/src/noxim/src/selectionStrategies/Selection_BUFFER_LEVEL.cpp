@@ -41,9 +41,9 @@ int Selection_BUFFER_LEVEL::apply(Router * router, const vector < int >&directio
     }
 
     if (best_dirs.size())
-	return (best_dirs[rand() % best_dirs.size()]);
+	return (best_dirs[router->randomIndex(best_dirs.size())]);
     else
-	return (directions[rand() % directions.size()]);
+	return (directions[router->randomIndex(directions.size())]);
 
     //-------------------------
     // TODO: unfair if multiple directions have same buffer level
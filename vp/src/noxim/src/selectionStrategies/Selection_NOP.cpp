@@ -59,7 +59,7 @@ int Selection_NOP::apply(Router * router, const vector < int >&directions, const
 	    equivalent_directions.push_back(directions[i]);
 
     direction_selected =
-	equivalent_directions[rand() % equivalent_directions.size()];
+	equivalent_directions[router->randomIndex(equivalent_directions.size())];
 
     return direction_selected;
 }
@@ -14,7 +14,7 @@ Selection_RANDOM * Selection_RANDOM::getInstance() {
 int Selection_RANDOM::apply(Router * router, const vector < int >&directions, const RouteData & route_data){
     assert(directions.size()!=0);
 
-    int output = directions[rand() % directions.size()];
+    int output = directions[router->randomIndex(directions.size())];
     return output;
 
 }
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <stdexcept>
+#include <vector>
 
 #include <tlm_utils/simple_initiator_socket.h>
 #include <tlm_utils/simple_target_socket.h>
@@ -90,7 +91,11 @@ struct PeripheralWriteConnector : sc_core::sc_module {
 	}
 
 	void transport(tlm::tlm_generic_payload &trans, sc_core::sc_time &delay) {
-		bus_lock->wait_until_unlocked();
+		// the lines locked by the harts
+		uint64_t first = trans.get_address() >> bus_lock_if::LINE_SHIFT;
+		uint64_t last = (trans.get_address() + trans.get_data_length() - 1) >> bus_lock_if::LINE_SHIFT;
+		for (uint64_t line = first; line <= last; ++line)
+			bus_lock->wait_for_access_rights(bus_lock_if::NO_HART, line << bus_lock_if::LINE_SHIFT);
 
 		isock->b_transport(trans, delay);
 
@@ -100,38 +105,49 @@ struct PeripheralWriteConnector : sc_core::sc_module {
 };
 
 class BusLock : public bus_lock_if {
-	bool locked = false;
-	unsigned owner = 0;
+	std::vector<std::pair<unsigned, uint64_t>> locks;  // hart and line, one for each locking hart
 	sc_core::sc_event lock_event;
 
    public:
-	virtual void lock(unsigned hart_id) override {
-		if (locked && (hart_id != owner)) {
-			wait_until_unlocked();
-		}
+	virtual void lock(unsigned hart_id, uint64_t addr) override {
+		wait_until_unlocked(hart_id, addr);
 
-		assert(!locked || (hart_id == owner));
-		locked = true;
-		owner = hart_id;
+		unlock(hart_id);
+		locks.emplace_back(hart_id, addr >> LINE_SHIFT);
 	}
 
 	virtual void unlock(unsigned hart_id) override {
-		if (locked && (owner == hart_id)) {
-			locked = false;
-			lock_event.notify(sc_core::SC_ZERO_TIME);
+		for (auto it = locks.begin(); it != locks.end(); ++it) {
+			if (it->first == hart_id) {
+				locks.erase(it);
+				lock_event.notify(sc_core::SC_ZERO_TIME);
+				return;
+			}
 		}
 	}
 
 	virtual bool is_locked() override {
-		return locked;
+		return !locks.empty();
 	}
 
 	virtual bool is_locked(unsigned hart_id) override {
-		return locked && (owner == hart_id);
+		for (auto &l : locks) {
+			if (l.first == hart_id)
+				return true;
+		}
+		return false;
+	}
+
+	virtual bool is_locked_by_other(unsigned hart_id, uint64_t addr) override {
+		for (auto &l : locks) {
+			if (l.second == (addr >> LINE_SHIFT) && l.first != hart_id)
+				return true;
+		}
+		return false;
 	}
 
-	virtual void wait_until_unlocked() override {
-		while (locked) sc_core::wait(lock_event);
+	virtual void wait_until_unlocked(unsigned hart_id, uint64_t addr) override {
+		while (is_locked_by_other(hart_id, addr)) sc_core::wait(lock_event);
 	}
 };
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <systemc>
+
+#include "WorkerPool.h"
+#include "iss.h"
+
+/*
+ * Runs the host phases of the cores (see rv64::host_phase_if) on a pool of
+ * host threads. The cores asking in the same delta cycle, i.e. all of them
+ * at a quantum boundary, run theirs together while the SystemC kernel
+ * waits. A core only meets the kernel, hence the engines and the NoC, in
+ * its SystemC thread: the results are the same whatever the number of
+ * threads.
+ */
+struct ParallelCores : public sc_core::sc_module, public rv64::host_phase_if {
+	WorkerPool pool;
+	std::vector<rv64::ISS *> queued;
+	std::vector<rv64::ISS *> batch;
+	std::atomic<size_t> next;
+	unsigned long batches = 0;  // run so far
+
+	sc_core::sc_event queued_event;
+	sc_core::sc_event done_event;
+
+	SC_HAS_PROCESS(ParallelCores);
+
+	ParallelCores(sc_core::sc_module_name, int n_threads) : pool(n_threads), next(0) {
+		SC_METHOD(run_batch);
+		sensitive << queued_event;
+		dont_initialize();
+	}
+
+	void run_host_phase(rv64::ISS &core) override {
+		unsigned long n = batches;  // the batch of core
+		queued.push_back(&core);
+		queued_event.notify(sc_core::SC_ZERO_TIME);
+		while (batches == n) sc_core::wait(done_event);
+	}
+
+	void run_batch() {
+		if (queued.empty())
+			return;
+
+		batch.swap(queued);
+		next = 0;
+		pool.run([this](int) {
+			for (size_t i = next++; i < batch.size(); i = next++) batch[i]->run_host_phase();
+		});
+		batch.clear();
+
+		++batches;
+		done_event.notify(sc_core::SC_ZERO_TIME);
+	}
+};
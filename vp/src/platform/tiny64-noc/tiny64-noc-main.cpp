@@ -8,6 +8,7 @@
  * This file contains the implementation of the top-level of Noxim
  */
 
+#include "Checkpoint.h"
 #include "ConfigurationManager.h"
 #include "NoC.h"
 #include "GlobalStats.h"
@@ -20,10 +21,17 @@
 #include "spu.h"
 #include "ae.h"
 
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <atomic>
+#include <chrono>
+#include <cmath>
 #include <csignal>
 #include <cstdlib>
 #include <ctime>
+#include <map>
 
 #include "platform/common/bus.h"
 #include "platform/common/memory.h"
@@ -36,6 +44,7 @@
 #include "memory.h"
 #include "mmu.h"
 #include "syscall.h"
+#include "parallel_cores.h"
 
 #define MB * 1024 * 1024
 #define MODULE_NAME(MODULE,i,j) \
@@ -48,6 +57,15 @@ using namespace rv64;
 unsigned int drained_volume;
 NoC *n;
 
+// Components of a core whose state goes into checkpoints
+struct CoreContext {
+	ISS *core;
+	SimpleMemory *mem;
+	SharedMemory<5> *sharedmem;
+	SyscallHandler *sys;
+};
+std::vector<CoreContext> cores;
+
 struct Runner : public sc_core::sc_module {
 	sc_in_clk clock;    
 	sc_in<bool> reset;  
@@ -63,10 +81,18 @@ struct Runner : public sc_core::sc_module {
 
 	void run() {
         if (!reset.read()) {
-            if (*nr_done == nr_cores)
+            if (*nr_done == nr_cores && !dmaBusy())
                 sc_stop();
         }
 	}
+
+	// A DMA self-test goes on after the cores are done
+	bool dmaBusy() const {
+		for (auto &c : cores)
+			if (c.core->dma_ctrl->busy())
+				return true;
+		return false;
+	}
 };
 
 void signalHandler( int signum )
@@ -98,6 +124,15 @@ void config_core(ISS &core, int i, int j) {
 
 	instr_memory_if *instr_mem_if = core_mem_if;
 	data_memory_if *data_mem_if = core_mem_if;
+	if (GlobalParams::use_instr_dmi)
+		instr_mem_if = instr_mem;
+	if (GlobalParams::use_data_dmi) {
+		core_mem_if->dmi_ranges.emplace_back(*dmi);
+	}
+	delete dmi;  // copied by the users above
+
+	// the engines work on the shared memory concurrently
+	core_mem_if->sync_ranges.emplace_back(GlobalParams::shared_mem_start_addr, GlobalParams::shared_mem_end_addr);
 
 	loader->load_executable_image(mem->data, mem->size, GlobalParams::mem_start_addr);
 	core.init(instr_mem_if, data_mem_if, clint, loader->get_entrypoint(), rv64_align_address(GlobalParams::mem_end_addr));
@@ -126,8 +161,17 @@ void config_core(ISS &core, int i, int j) {
 	// switch for printing instructions
 	core.trace = GlobalParams::pe_trace_mode;
 
+	// compile hot blocks to host code
+	core.use_jit = GlobalParams::use_jit;
+
     // engine
-    SharedMemory<4> *sharedmem = new SharedMemory<4>(MODULE_NAME(SharedMemory, i, j), 1 MB);
+    SharedMemory<5> *sharedmem = new SharedMemory<5>(MODULE_NAME(SharedMemory, i, j), 1 MB);
+    if (GlobalParams::use_data_dmi) {
+        MemoryDMI *shared_dmi =
+            MemoryDMI::create_start_size_mapping(sharedmem->data, GlobalParams::shared_mem_start_addr, sharedmem->size);
+        core_mem_if->dmi_ranges.emplace_back(*shared_dmi);
+        delete shared_dmi;
+    }
     Scheduler *scheduler = new Scheduler(MODULE_NAME(Scheduler, i, j));
     DMACTRL *dma_ctrl = new DMACTRL(MODULE_NAME(DMACTRL, i, j));
     AE *ae = new AE(MODULE_NAME(AE, i, j));
@@ -141,12 +185,232 @@ void config_core(ISS &core, int i, int j) {
     dma_ctrl->isock.bind(sharedmem->tsocks[1]);
     ae->isock.bind(sharedmem->tsocks[2]);
     spu->isock.bind(sharedmem->tsocks[3]);
+    scheduler->mem_isock.bind(sharedmem->tsocks[4]);
 
     dma_ctrl->long_instr_complete = &(core.long_instr_complete);
+    dma_ctrl->hbm_test = j * GlobalParams::mesh_dim_x + i == GlobalParams::dma_hbm_test;
     ae->long_instr_complete = &(core.long_instr_complete);
     spu->long_instr_complete = &(core.long_instr_complete);
 
     core.dma_ctrl = dma_ctrl;
+
+	cores.push_back(CoreContext{&core, mem, sharedmem, sys});
+}
+
+// A core is suspended between two instructions, or within one waiting
+// for its engines or syncing on a shared memory access: checkpoints are
+// only taken at instruction boundaries with no engine instruction in
+// flight, as the engines keep their state in their threads
+bool coresQuiescent() {
+	for (auto &c : cores) {
+		if (c.core->in_step || c.core->long_instr_cnt != c.core->long_instr_complete.load() ||
+		    c.core->dma_ctrl->current_state != IDLE)
+			return false;
+	}
+	return true;
+}
+
+void serializeCore(Checkpoint &ckpt, CoreContext &c) {
+	ISS &core = *c.core;
+	ckpt.section(core.name());
+
+	ckpt.io(core.regs.regs);
+	ckpt.io(core.fp_regs);
+	ckpt.io(core.pc);
+	ckpt.io(core.last_pc);
+	ckpt.io(core.shall_exit);
+	ckpt.io(core.prv);
+	ckpt.io(core.lr_sc_counter);
+	ckpt.io(core.status);
+
+	// CSRs by address, some addresses share a register
+	std::map<unsigned, uint64_t *> csrs(core.csrs.register_mapping.begin(), core.csrs.register_mapping.end());
+	uint64_t n_csrs = csrs.size();
+	ckpt.io(n_csrs);
+	if (n_csrs != csrs.size()) {
+		cerr << "Error: checkpoint CSR count mismatch in " << core.name() << endl;
+		exit(1);
+	}
+	for (auto &csr : csrs) {
+		ckpt.section(std::to_string(csr.first));
+		ckpt.io(*csr.second);
+	}
+
+	double cycles = core.cycle_counter / core.cycle_time;
+	ckpt.io(cycles);
+	core.cycle_counter = core.cycle_time * cycles;
+
+	ckpt.io(core.idagi_ext.regs);
+	ckpt.io(core.long_instr_cnt);
+	uint32_t long_instr_complete = core.long_instr_complete.load();
+	ckpt.io(long_instr_complete);
+	core.long_instr_complete = long_instr_complete;
+
+	ckpt.image(c.mem->data, c.mem->size);
+	ckpt.image(c.sharedmem->data, c.sharedmem->size);
+
+	ckpt.io(c.sys->hp);
+	ckpt.io(c.sys->shall_exit);
+	ckpt.io(c.sys->shall_break);
+	ckpt.io(c.sys->start_heap);
+	ckpt.io(c.sys->max_heap);
+
+	DMACTRL &dma_ctrl = *core.dma_ctrl;
+	ckpt.io(dma_ctrl.current_state);
+	ckpt.io(dma_ctrl.has_send);
+	ckpt.io(dma_ctrl.has_read);
+	ckpt.io(dma_ctrl.has_received_local_trans);
+	ckpt.io(dma_ctrl.router_data_buffer);
+
+	if (!ckpt.isSaving()) {
+		dma_ctrl.current_cmd = nullptr;
+		core.mem->flush_tlb();
+	}
+}
+
+void serializeCores(Checkpoint &ckpt) {
+	ckpt.section("platform");
+	ckpt.io(drained_volume);
+
+	for (auto &c : cores)
+		serializeCore(ckpt, c);
+}
+
+// Results a sweep run sends back to the parent
+struct SweepResult {
+	double cycles;
+	double host_seconds;
+	unsigned int received_packets;
+	unsigned int received_flits;
+	double average_delay;
+	double max_delay;
+	double throughput;
+	double dynamic_energy;
+	double static_energy;
+};
+
+// Fork a run for each sweep value from the end of reset, at most
+// sweep_jobs at a time, the children sharing the initialized simulator
+// copy on write. A child returns the pipe its results go to, after
+// applying its value; the parent waits for all of them, prints their
+// results and returns -1
+int forkSweep() {
+	const vector<string> &values = GlobalParams::sweep_values;
+	unsigned int jobs = GlobalParams::sweep_jobs > 0 ? GlobalParams::sweep_jobs : max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+	vector<SweepResult> results(values.size());
+	vector<bool> completed(values.size(), false);
+	std::map<pid_t, pair<unsigned int, int>> running;  // value index and pipe of each child
+
+	cout << "Sweeping " << GlobalParams::sweep_param << " over " << values.size() << " runs, " << jobs
+	     << " at a time" << endl;
+	cout.flush();
+	fflush(stdout);
+
+	unsigned int next = 0;
+	while (next < values.size() || !running.empty()) {
+		if (next < values.size() && running.size() < jobs) {
+			int fds[2];
+			if (pipe(fds) != 0) {
+				cerr << "Error: cannot create the pipe of a sweep run" << endl;
+				exit(1);
+			}
+			pid_t pid = fork();
+			if (pid < 0) {
+				cerr << "Error: cannot fork a sweep run" << endl;
+				exit(1);
+			}
+			if (pid == 0) {
+				close(fds[0]);
+				for (auto &r : running)
+					close(r.second.second);
+
+				string log = "sweep_" + GlobalParams::sweep_param + "_" + values[next] + ".log";
+				int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+				if (fd < 0) {
+					cerr << "Error: cannot create " << log << endl;
+					exit(1);
+				}
+				dup2(fd, STDOUT_FILENO);
+				dup2(fd, STDERR_FILENO);
+				close(fd);
+
+				cout << "Sweep run with " << GlobalParams::sweep_param << " = " << values[next] << endl;
+				applySweepValue(values[next]);
+				n->reconfigure();
+				tlm::tlm_global_quantum::instance().set(
+				    sc_core::sc_time(GlobalParams::tlm_global_quantum, sc_core::SC_NS));
+				return fds[1];
+			}
+			close(fds[1]);
+			running[pid] = make_pair(next, fds[0]);
+			next++;
+			continue;
+		}
+
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			cerr << "Error: lost the sweep runs" << endl;
+			exit(1);
+		}
+		auto it = running.find(pid);
+		if (it == running.end())
+			continue;
+		unsigned int v = it->second.first;
+		completed[v] = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+		               read(it->second.second, &results[v], sizeof(SweepResult)) == sizeof(SweepResult);
+		close(it->second.second);
+		running.erase(it);
+	}
+
+	cout << endl << "% Sweep of " << GlobalParams::sweep_param << " (logs in sweep_" << GlobalParams::sweep_param
+	     << "_<value>.log)" << endl;
+	cout << "sweep_stats = [" << endl;
+	cout << "%\tvalue\tcycles\thost_s\tpackets\tflits\tavg_delay\tmax_delay\tthroughput\tdynamic_J\tstatic_J" << endl;
+	for (unsigned int v = 0; v < values.size(); v++) {
+		cout << "\t" << values[v];
+		if (!completed[v]) {
+			cout << "\t% failed" << endl;
+			continue;
+		}
+		const SweepResult &r = results[v];
+		cout << "\t" << r.cycles << "\t" << r.host_seconds << "\t" << r.received_packets << "\t" << r.received_flits << "\t"
+		     << r.average_delay << "\t" << r.max_delay << "\t" << r.throughput << "\t" << r.dynamic_energy << "\t"
+		     << r.static_energy << endl;
+	}
+	cout << "];" << endl;
+
+	return -1;
+}
+
+// Run to the middle of cycle checkpoint_cycle, or of the first cycle
+// after it with the cores quiescent, and save the simulation there
+void saveCheckpoint() {
+	double period = GlobalParams::clock_period_ps;
+	double target = (GlobalParams::checkpoint_cycle + 0.5) * period;
+
+	if (target > sc_time_stamp().to_double())
+		sc_start(target - sc_time_stamp().to_double(), SC_PS);
+	while (sc_get_status() != SC_STOPPED && !coresQuiescent())
+		sc_start(period, SC_PS);
+
+	if (sc_get_status() == SC_STOPPED) {
+		cout << "Simulation completed before cycle " << GlobalParams::checkpoint_cycle << ", no checkpoint saved"
+		     << endl;
+		return;
+	}
+
+	Checkpoint ckpt;
+	if (!ckpt.create(GlobalParams::checkpoint_filename, sc_time_stamp().to_double())) {
+		cerr << "Error: cannot create checkpoint " << GlobalParams::checkpoint_filename << endl;
+		exit(1);
+	}
+	serializeCores(ckpt);
+	n->serialize(ckpt);
+	ckpt.close();
+
+	cout << "Checkpoint saved to " << GlobalParams::checkpoint_filename << " at cycle "
+	     << (long)(sc_time_stamp().to_double() / period) << endl;
 }
 
 int sc_main(int arg_num, char *arg_vet[])
@@ -168,10 +432,23 @@ int sc_main(int arg_num, char *arg_vet[])
 
     configure(arg_num, arg_vet);
 
+    // The cores run ahead of the NoC by up to a quantum
+    tlm::tlm_global_quantum::instance().set(sc_core::sc_time(GlobalParams::tlm_global_quantum, sc_core::SC_NS));
+
 	std::srand(std::time(nullptr));  // use current time as seed for random generator
 
+    // A restored simulation resumes at the time of its checkpoint, in the
+    // middle of a cycle: its clock starts with the next cycle
+    Checkpoint restore;
+    double first_edge_ps = 0.0;
+    if (!GlobalParams::restore_filename.empty()) {
+        if (!restore.open(GlobalParams::restore_filename))
+            exit(1);
+        first_edge_ps = ceil(restore.getTime() / GlobalParams::clock_period_ps) * GlobalParams::clock_period_ps;
+    }
+
     // Signals
-    sc_clock clock("clock", GlobalParams::clock_period_ps, SC_PS);
+    sc_clock clock("clock", GlobalParams::clock_period_ps, SC_PS, 0.5, first_edge_ps, SC_PS, true);
     sc_signal <bool> reset;
 
     std::atomic<int> nr_done;
@@ -202,6 +479,13 @@ int sc_main(int arg_num, char *arg_vet[])
         }
     }
 
+    // The cores run their quanta on host threads
+    if (GlobalParams::iss_threads > 1) {
+        ParallelCores *parallel = new ParallelCores("ParallelCores", GlobalParams::iss_threads);
+        for (auto &c : cores)
+            c.core->host_phases = parallel;
+    }
+
     // Runner instance
     Runner runner("runnner");
     runner.clock(clock);
@@ -241,34 +525,92 @@ int sc_main(int arg_num, char *arg_vet[])
         }
     }
 
-    // Reset the chip and run the simulation
-    reset.write(1);
-    cout << "Reset for " << (int)(GlobalParams::reset_time) << " cycles... " << std::endl; 
     srand(GlobalParams::rnd_generator_seed);
 
-    // fix clock periods different from 1ns
-    //sc_start(GlobalParams::reset_time, SC_NS);
-    sc_start(GlobalParams::reset_time * GlobalParams::clock_period_ps, SC_PS);
+    if (!GlobalParams::restore_filename.empty()) {
+        // Everything is reset up to the checkpoint time, which holds no
+        // clock edge. The cores start running as soon as reset is
+        // released, so they are restored before; the clocked modules
+        // once they have seen reset released
+        reset.write(1);
+        sc_start(restore.getTime(), SC_PS);
+
+        serializeCores(restore);
+        for (auto &c : cores)
+            if (c.core->status != CoreExecStatus::Runnable)
+                nr_done++;
+
+        reset.write(0);
+        do {
+            sc_start(SC_ZERO_TIME);
+        } while (sc_pending_activity_at_current_time());
+
+        n->serialize(restore);
+        restore.close();
+        cout << "Restored " << GlobalParams::restore_filename << " at cycle "
+             << (long)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps) << std::endl;
+    } else {
+        // Reset the chip and run the simulation
+        reset.write(1);
+        cout << "Reset for " << (int)(GlobalParams::reset_time) << " cycles... " << std::endl;
+
+        // fix clock periods different from 1ns
+        //sc_start(GlobalParams::reset_time, SC_NS);
+        sc_start(GlobalParams::reset_time * GlobalParams::clock_period_ps, SC_PS);
+
+        reset.write(0);
+        cout << " done! " << std::endl;
+    }
+
+    if (!GlobalParams::checkpoint_filename.empty())
+        saveCheckpoint();
+
+    // A sweep goes on in its children, one for each value
+    int sweep_pipe = -1;
+    if (!GlobalParams::sweep_values.empty()) {
+        sweep_pipe = forkSweep();
+        if (sweep_pipe < 0)
+            return 0;
+    }
+    auto run_start = std::chrono::steady_clock::now();
 
-    reset.write(0);
-    cout << " done! " << std::endl;
     // cout << " Now running for " << GlobalParams:: simulation_time << " cycles..." << std::endl;
     cout << " Now running until all cores done " << std::endl;
     // fix clock periods different from 1ns
     //sc_start(GlobalParams::simulation_time, SC_NS);
     // sc_start(GlobalParams::simulation_time * GlobalParams::clock_period_ps, SC_PS);
-    sc_start();
+    if (sc_get_status() != SC_STOPPED)
+        sc_start();
+    double host_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
 
     // Close the simulation
     if (GlobalParams::noc_trace_mode) sc_close_vcd_trace_file(tf);
+    if (n->telemetry) n->telemetry->close();
     cout << "Noxim simulation completed.";
-    cout << " (" << sc_time_stamp().to_double() / GlobalParams::clock_period_ps << " cycles executed)" << endl;
+    cout << " (" << sc_time_stamp().to_double() / GlobalParams::clock_period_ps << " cycles executed in "
+         << host_seconds << "s)" << endl;
     cout << endl;
 
     // Show statistics
     GlobalStats gs(n);
     gs.showStats(std::cout, GlobalParams::detailed);
 
+    if (sweep_pipe >= 0) {
+        SweepResult result;
+        result.cycles = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+        result.host_seconds = host_seconds;
+        result.received_packets = gs.getReceivedPackets();
+        result.received_flits = gs.getReceivedFlits();
+        result.average_delay = gs.getAverageDelay();
+        result.max_delay = gs.getMaxDelay();
+        result.throughput = gs.getAggregatedThroughput();
+        result.dynamic_energy = gs.getDynamicPower();
+        result.static_energy = gs.getStaticPower();
+        if (write(sweep_pipe, &result, sizeof(result)) != sizeof(result))
+            cerr << "Error: cannot send the results of the sweep run" << endl;
+        close(sweep_pipe);
+    }
+
 
     if ((GlobalParams::max_volume_to_be_drained > 0) &&
 	(sc_time_stamp().to_double() / GlobalParams::clock_period_ps - GlobalParams::reset_time >=
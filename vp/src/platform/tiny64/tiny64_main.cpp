@@ -149,7 +149,7 @@ int sc_main(int argc, char **argv) {
 	core.trace = opt.trace_mode;
 
     // engine
-    SharedMemory<4> *sharedmem = new SharedMemory<4>("SharedMemory", 1 MB);
+    SharedMemory<5> *sharedmem = new SharedMemory<5>("SharedMemory", 1 MB);
     Scheduler *scheduler = new Scheduler("Scheduler");
     DMACTRL *dma_ctrl = new DMACTRL("DMACTRL");
     AE *ae = new AE("AE");
@@ -164,6 +164,7 @@ int sc_main(int argc, char **argv) {
     dma_ctrl->isock.bind(sharedmem->tsocks[1]);
     ae->isock.bind(sharedmem->tsocks[2]);
     spu->isock.bind(sharedmem->tsocks[3]);
+    scheduler->mem_isock.bind(sharedmem->tsocks[4]);
 
 	dma_ctrl->local_isock.bind(dummy->tsock);
 	dummy->isock.bind(dma_ctrl->local_tsock);
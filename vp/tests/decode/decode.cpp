@@ -0,0 +1,79 @@
+/*
+ * Decodes a sweep of instruction words with the decoder it is built with.
+ *
+ *   decode print   prints word, architecture, mapping and type of each
+ *                  word, and the expansion of each compressed word
+ *   decode bench   prints the decode time per word
+ *
+ * test.sh builds it with the current decoder and with the switch based
+ * one it replaced (reference/), and compares both.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "instr.h"
+
+// The fields that select an instruction (opcode, funct3, funct7, rs2)
+// exhaustively, with the other ones random, and random words
+static std::vector<uint32_t> sweep() {
+	std::vector<uint32_t> words;
+	std::mt19937 rng(1);
+	for (uint32_t opcode = 3; opcode < 128; opcode += 4)
+		for (uint32_t funct3 = 0; funct3 < 8; funct3++)
+			for (uint32_t funct7 = 0; funct7 < 128; funct7++)
+				for (uint32_t rs2 = 0; rs2 < 32; rs2++) {
+					// rd and rs1 are zero half of the time (FENCE, ECALL, ...)
+					uint32_t others = rng() & 1 ? rng() & 0x000f8f80 : 0;
+					words.push_back(opcode | funct3 << 12 | funct7 << 25 | rs2 << 20 | others);
+				}
+	for (int i = 0; i < 1000000; i++) words.push_back(rng() | 3);
+	return words;
+}
+
+static int print() {
+	std::vector<uint32_t> words = sweep();
+	for (Architecture arch : {RV32, RV64}) {
+		for (uint32_t word : words) {
+			Instruction instr(word);
+			Opcode::Mapping op = instr.decode_normal(arch);
+			printf("%08x %d %s %d\n", word, arch, Opcode::mappingStr[op], (int)Opcode::getType(op));
+		}
+		for (uint32_t word = 0; word < 0x10000; word++) {
+			if ((word & 3) == 3)
+				continue;
+			Instruction instr(word);
+			Opcode::Mapping op = instr.decode_and_expand_compressed(arch);
+			printf("%04x %d %s %08x\n", word, arch, Opcode::mappingStr[op], instr.data());
+		}
+	}
+	return 0;
+}
+
+static int bench() {
+	std::vector<uint32_t> words = sweep();
+	const int rounds = 20;
+	uint64_t sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (uint32_t word : words) sum += Instruction(word).decode_normal(RV64);
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count() / ((double)rounds * words.size());
+	printf("%.3f ns per decode (%lu)\n", ns, (unsigned long)sum);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "print"))
+		return print();
+	if (argc == 2 && !strcmp(argv[1], "bench"))
+		return bench();
+	fprintf(stderr, "usage: %s print|bench\n", argv[0]);
+	return 1;
+}
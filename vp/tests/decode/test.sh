@@ -0,0 +1,34 @@
+#!/bin/bash
+#
+# The table driven decoder (core/common/instr_table.h) must decode every
+# word as the switch based decoder it replaced did. reference/ holds a
+# copy of that decoder. The decode times of both are printed, not
+# checked, as they depend on the host.
+
+set -e
+
+SRC=../../src
+CXX=${CXX:-g++}
+CXXFLAGS="-std=c++14 -O2 -w"
+
+tmp=$(mktemp -d)
+trap 'rm -rf "${tmp}"' EXIT
+
+printf "Building the decoders: "
+${CXX} ${CXXFLAGS} -Ireference -I"${SRC}/core/common" -I"${SRC}" \
+	decode.cpp reference/instr.cpp -o "${tmp}/decode-old"
+${CXX} ${CXXFLAGS} -I"${SRC}/core/common" -I"${SRC}" \
+	decode.cpp "${SRC}/core/common/instr.cpp" -o "${tmp}/decode-new"
+printf "OK.\n"
+
+printf "Comparing the decoded words: "
+if ! cmp -s <("${tmp}/decode-old" print) <("${tmp}/decode-new" print); then
+	printf "FAIL.\n"
+	diff <("${tmp}/decode-old" print) <("${tmp}/decode-new" print) | head -20
+	exit 1
+fi
+printf "OK.\n"
+
+old=$("${tmp}/decode-old" bench)
+new=$("${tmp}/decode-new" bench)
+printf "Decode time: switch %s, table %s\n" "${old%% *}" "${new%% *}"
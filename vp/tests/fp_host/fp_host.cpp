@@ -0,0 +1,175 @@
+/*
+ * Checks the host FPU fast path (core/common/fp_host.h) against softfloat.
+ *
+ *   fp_host [n]     compares n random operations of each kind, default 1M
+ *   fp_host bench   prints the time per operation of both
+ *
+ * The operands are biased towards the cases the fast path has to leave to
+ * softfloat or gets its flags wrong for: NaNs, infinities, zeros,
+ * subnormals, results near underflow and overflow, and exact results. The
+ * fflags of the hart change randomly, since the fast path only clears the
+ * host flags the hart has not got yet.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <array>  // for fp.h
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "core/common/fp_host.h"
+
+static std::mt19937_64 rng(7);
+
+template <typename T>
+T operand();
+
+template <>
+float32_t operand<float32_t>() {
+	static const uint32_t special[] = {0x00000000, 0x80000000, 0x7f800000, 0xff800000, 0x7fc00000, 0x7f800001,
+	                                   0x00000001, 0x00800000, 0x7f7fffff, 0x3f800000, 0xbf800000, 0x007fffff};
+	const uint32_t sign_mantissa = 0x807fffff;
+	uint32_t v = rng();
+
+	switch (rng() % 8) {
+		case 0:
+			return float32_t{v};
+		case 1:
+			return float32_t{special[rng() % 12]};
+		case 2:  // near underflow
+			return float32_t{(v & sign_mantissa) | (uint32_t)(rng() % 12) << 23};
+		case 3:  // near overflow
+			return float32_t{(v & sign_mantissa) | (uint32_t)(243 + rng() % 12) << 23};
+		case 4:  // few mantissa bits, exact results
+			return float32_t{(v & 0x80000fff) | (uint32_t)(120 + rng() % 16) << 23};
+		default:
+			return float32_t{(v & sign_mantissa) | (uint32_t)(64 + rng() % 128) << 23};
+	}
+}
+
+template <>
+float64_t operand<float64_t>() {
+	static const uint64_t special[] = {0x0000000000000000, 0x8000000000000000, 0x7ff0000000000000,
+	                                   0xfff0000000000000, 0x7ff8000000000000, 0x7ff0000000000001,
+	                                   0x0000000000000001, 0x0010000000000000, 0x7fefffffffffffff,
+	                                   0x3ff0000000000000, 0xbff0000000000000, 0x000fffffffffffff};
+	const uint64_t sign_mantissa = 0x800fffffffffffff;
+	uint64_t v = rng();
+
+	switch (rng() % 8) {
+		case 0:
+			return float64_t{v};
+		case 1:
+			return float64_t{special[rng() % 12]};
+		case 2:  // near underflow
+			return float64_t{(v & sign_mantissa) | (rng() % 60) << 52};
+		case 3:  // near overflow
+			return float64_t{(v & sign_mantissa) | (2047 - 60 + rng() % 60) << 52};
+		case 4:  // few mantissa bits, exact results
+			return float64_t{(v & 0x800000000000ffff) | (1000 + rng() % 40) << 52};
+		default:
+			return float64_t{(v & sign_mantissa) | (512 + rng() % 1024) << 52};
+	}
+}
+
+static uint_fast8_t fflags = 0;
+static unsigned long total = 0, failed = 0;
+
+// The result and the fflags of the hart after the operation must be the same
+template <typename T, typename Host, typename Soft, typename... Ts>
+void check(const char *name, Host host, Soft soft, Ts... operands) {
+	for (uint_fast8_t rm : {softfloat_round_near_even, softfloat_round_minMag, softfloat_round_min,
+	                        softfloat_round_max, softfloat_round_near_maxMag}) {
+		softfloat_roundingMode = rm;
+
+		softfloat_exceptionFlags = 0;
+		T host_result = host(operands..., fflags);
+		uint_fast8_t host_flags = softfloat_exceptionFlags;
+
+		softfloat_exceptionFlags = 0;
+		T soft_result = soft(operands...);
+		uint_fast8_t soft_flags = softfloat_exceptionFlags;
+
+		++total;
+		if (host_result.v != soft_result.v || (fflags | host_flags) != (fflags | soft_flags)) {
+			if (failed++ < 20)
+				printf("%s rm %d fflags %x: host %llx flags %x, softfloat %llx flags %x\n", name, (int)rm,
+				       (unsigned)fflags, (unsigned long long)host_result.v, (unsigned)host_flags,
+				       (unsigned long long)soft_result.v, (unsigned)soft_flags);
+		}
+		fflags |= soft_flags;
+	}
+}
+
+static int conformance(unsigned long n) {
+	for (unsigned long i = 0; i < n; i++) {
+		if (rng() % 64 == 0)
+			fflags = rng() % 32;  // as after a write of fflags
+
+		float32_t a = operand<float32_t>(), b = operand<float32_t>(), c = operand<float32_t>();
+		check<float32_t>("f32_add", host_f32_add, f32_add, a, b);
+		check<float32_t>("f32_sub", host_f32_sub, f32_sub, a, b);
+		check<float32_t>("f32_mul", host_f32_mul, f32_mul, a, b);
+		check<float32_t>("f32_div", host_f32_div, f32_div, a, b);
+		check<float32_t>("f32_sqrt", host_f32_sqrt, f32_sqrt, a);
+		check<float32_t>("f32_mulAdd", host_f32_mulAdd, f32_mulAdd, a, b, c);
+
+		float64_t x = operand<float64_t>(), y = operand<float64_t>(), z = operand<float64_t>();
+		check<float64_t>("f64_add", host_f64_add, f64_add, x, y);
+		check<float64_t>("f64_sub", host_f64_sub, f64_sub, x, y);
+		check<float64_t>("f64_mul", host_f64_mul, f64_mul, x, y);
+		check<float64_t>("f64_div", host_f64_div, f64_div, x, y);
+		check<float64_t>("f64_sqrt", host_f64_sqrt, f64_sqrt, x);
+		check<float64_t>("f64_mulAdd", host_f64_mulAdd, f64_mulAdd, x, y, z);
+	}
+	printf("%lu operations, %lu mismatches\n", total, failed);
+	return failed != 0;
+}
+
+template <typename Op>
+static void time(const char *name, Op op) {
+	const int rounds = 2000, n = 4096;
+	uint64_t sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (int i = 0; i + 2 < n; i++) sum += op(i);
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count() / ((double)rounds * (n - 2));
+	printf("%-16s %.2f ns (%llu)\n", name, ns, (unsigned long long)sum & 1);
+}
+
+// Normal operands, the common case of the fast path
+static int bench() {
+	std::vector<float64_t> d;
+	std::vector<float32_t> f;
+	for (int i = 0; i < 4096; i++) {
+		double v = 1.0 + (rng() % 1000000) / 1e5;
+		float w = v;
+		float64_t x;
+		float32_t y;
+		memcpy(&x.v, &v, sizeof(v));
+		memcpy(&y.v, &w, sizeof(w));
+		d.push_back(x);
+		f.push_back(y);
+	}
+	softfloat_roundingMode = softfloat_round_near_even;
+
+	time("f64_mul", [&](int i) { return f64_mul(d[i], d[i + 1]).v; });
+	time("host_f64_mul", [&](int i) { return host_f64_mul(d[i], d[i + 1], 1).v; });
+	time("f64_div", [&](int i) { return f64_div(d[i], d[i + 1]).v; });
+	time("host_f64_div", [&](int i) { return host_f64_div(d[i], d[i + 1], 1).v; });
+	time("f32_mulAdd", [&](int i) { return (uint64_t)f32_mulAdd(f[i], f[i + 1], f[i + 2]).v; });
+	time("host_f32_mulAdd", [&](int i) { return (uint64_t)host_f32_mulAdd(f[i], f[i + 1], f[i + 2], 1).v; });
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "bench"))
+		return bench();
+	return conformance(argc == 2 ? strtoul(argv[1], nullptr, 0) : 1000000);
+}
@@ -0,0 +1,22 @@
+#!/bin/bash
+#
+# The host FPU fast path (core/common/fp_host.h) must compute the same
+# results and flags as softfloat.
+
+set -e
+
+SRC=../../src
+SOFTFLOAT=../../dependencies/softfloat-dist
+CXX=${CXX:-g++}
+CXXFLAGS="-std=c++14 -O2 -w"
+
+tmp=$(mktemp -d)
+trap 'rm -rf "${tmp}"' EXIT
+
+printf "Building fp_host: "
+${CXX} ${CXXFLAGS} -I"${SRC}" -I"${SRC}/core/common" -I"${SOFTFLOAT}/include" \
+	fp_host.cpp "${SOFTFLOAT}/lib/libsoftfloat.a" -o "${tmp}/fp_host"
+printf "OK.\n"
+
+"${tmp}/fp_host"
+"${tmp}/fp_host" bench